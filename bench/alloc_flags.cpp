@@ -0,0 +1,77 @@
+#include "bench.hpp"
+
+#include <string.h> // memcpy
+
+// A 3840x2160 ARGB frame cleared and blitted row by row into a second buffer, both
+// from `la::alloc` with each set of `AllocFlags`: the allocation itself, the first
+// frame (which faults the pages in), the steady per-frame cost and the data TLB
+// misses of the best steady frame, then its IPC, LLC and branch misses per pixel
+// ("n/a" where perf is restricted).
+//
+//     g++ -std=c++14 -O2 -Isrc bench/alloc_flags.cpp src/la/*.cpp -o bench_alloc_flags -lpthread
+
+namespace {
+
+LA_CONSTEXPR_VAR int WIDTH = 3840;
+LA_CONSTEXPR_VAR int HEIGHT = 2160;
+LA_CONSTEXPR_VAR size_t BYTES = static_cast<size_t>(WIDTH) * HEIGHT * sizeof(uint32_t);
+LA_CONSTEXPR_VAR int FRAMES = 20;
+
+void
+draw_frame(uint32_t* src, uint32_t* dst, uint32_t color) noexcept {
+    for (size_t i = 0; i < static_cast<size_t>(WIDTH) * HEIGHT; ++i) src[i] = color;
+    for (int y = 0; y < HEIGHT; ++y) {
+        memcpy(dst + static_cast<size_t>(y) * WIDTH, src + static_cast<size_t>(y) * WIDTH, WIDTH * sizeof(uint32_t));
+    }
+} // draw_frame
+
+void
+run(const char* name, uint32_t flags) noexcept {
+    uint64_t start = la::get_monotonic_ns();
+    uint32_t* src = static_cast<uint32_t*>(la::alloc(BYTES, flags));
+    uint32_t* dst = static_cast<uint32_t*>(la::alloc(BYTES, flags));
+    if (!src || !dst) {
+        printf("  %-28s allocation failed\n", name);
+        if (src) la::free(src, BYTES);
+        if (dst) la::free(dst, BYTES);
+        return;
+    }
+    const uint64_t allocated = la::get_monotonic_ns() - start;
+
+    start = la::get_monotonic_ns();
+    draw_frame(src, dst, 0xff000000u);
+    const uint64_t first = la::get_monotonic_ns() - start;
+
+    la::PerfSample perf;
+    uint32_t frame = 0;
+    const double best = bench::best_ns(FRAMES, 1, [&]() noexcept {
+        draw_frame(src, dst, 0xff000000u | frame++);
+    }, &perf);
+    bench::g_sink = dst[static_cast<size_t>(WIDTH) * HEIGHT - 1];
+
+    printf("  %-28s %8.2f  %8.2f  %8.2f", name, allocated / 1e6, first / 1e6, best / 1e6);
+    if (perf.has(la::PerfCounter::DtlbMisses))
+        printf("  %10llu\n", static_cast<unsigned long long>(perf[la::PerfCounter::DtlbMisses]));
+    else
+        printf("  %10s\n", "n/a");
+    printf("  %-28s", "");
+    bench::print_counters(perf, static_cast<double>(WIDTH) * HEIGHT);
+    printf("\n");
+    la::free(src, BYTES);
+    la::free(dst, BYTES);
+} // run
+
+} // namespace
+
+int main() {
+    printf("Two %dx%d ARGB buffers, large pages of %llu KB\n", WIDTH, HEIGHT,
+           static_cast<unsigned long long>(la::get_large_page_size() / 1024));
+    if (!bench::counters().read().has(la::PerfCounter::DtlbMisses))
+        printf("dTLB miss counter unavailable (perf_event_paranoid, container or VM)\n");
+    printf("  ms                              alloc     first per frame  dTLB/frame\n");
+    run("ALLOC_DEFAULT", la::ALLOC_DEFAULT);
+    run("ALLOC_POPULATE", la::ALLOC_POPULATE);
+    run("ALLOC_LARGE_PAGES", la::ALLOC_LARGE_PAGES);
+    run("ALLOC_LARGE_PAGES|POPULATE", la::ALLOC_LARGE_PAGES | la::ALLOC_POPULATE);
+    return 0;
+}
@@ -0,0 +1,58 @@
+#ifndef __LA_BENCH_HEADER_GUARD
+#define __LA_BENCH_HEADER_GUARD
+
+#include "la/la.hpp"
+#include <stdio.h>
+
+// Shared by the programs in bench/, see README.md
+
+namespace bench {
+
+// Results are added here so the optimizer can't drop the work
+static volatile uint64_t g_sink = 0;
+
+// Hardware counters of the main thread, opened on first use. Samples stay empty
+// where the kernel refuses them (perf_event_paranoid, containers, VMs) and on Windows
+inline const ::la::PerfCounters&
+counters() noexcept {
+    static ::la::PerfCounters perf;
+    static const bool opened = perf.open();
+    (void)opened;
+    return perf;
+} // counters
+
+// Best of `runs` calls of `body()`, in nanoseconds per operation. With `perf`, also
+// the counter deltas of that best call
+template <typename F>
+inline double
+best_ns(unsigned runs, uint64_t ops, F&& body, ::la::PerfSample* perf = nullptr) noexcept {
+    uint64_t best = ~0ull;
+    for (unsigned r = 0; r < runs; ++r) {
+        const ::la::PerfSample before = perf ? counters().read() : ::la::PerfSample{};
+        const uint64_t start = ::la::get_monotonic_ns();
+        body();
+        const uint64_t elapsed = ::la::get_monotonic_ns() - start;
+        if (elapsed < best) {
+            best = elapsed;
+            if (perf) *perf = counters().read() - before;
+        }
+    }
+    return static_cast<double>(best) / static_cast<double>(ops ? ops : 1);
+} // best_ns
+
+// "  IPC 1.52  LLC 0.0031/px  branch 0.0002/px", the counters that are missing as n/a
+inline void
+print_counters(const ::la::PerfSample& perf, double pixels) noexcept {
+    const ::la::PerfCounter MISSES[] = { ::la::PerfCounter::LlcMisses, ::la::PerfCounter::BranchMisses };
+    const char* const NAMES[] = { "LLC", "branch" };
+    if (perf.ipc() > 0.0) printf("  IPC %4.2f", perf.ipc());
+    else                  printf("  IPC  n/a");
+    for (int i = 0; i < 2; ++i) {
+        if (perf.has(MISSES[i])) printf("  %s %6.4f/px", NAMES[i], static_cast<double>(perf[MISSES[i]]) / pixels);
+        else                     printf("  %s %9s", NAMES[i], "n/a");
+    }
+} // print_counters
+
+} // namespace bench
+
+#endif // __LA_BENCH_HEADER_GUARD
@@ -0,0 +1,86 @@
+#include "bench.hpp"
+
+#include <algorithm>
+
+// Cost per call of each clock, how far `tsc_now_ns()` strays from
+// `get_monotonic_ns()` over a short interval, and how late plain sleeps wake up
+// (`measure_sleep_error()`) with the spin margin that follows from it.
+//
+//     g++ -std=c++14 -O2 -Isrc bench/clock.cpp src/la/*.cpp -o bench_clock -lpthread
+
+namespace {
+
+LA_CONSTEXPR_VAR uint64_t CALLS = 10000000;
+
+template <typename F>
+double
+per_call(F&& clock) noexcept {
+    return bench::best_ns(5, CALLS, [&]() noexcept {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < CALLS; ++i) sum += clock();
+        bench::g_sink = sum;
+    });
+} // per_call
+
+// Lateness of 100 `sleep_for(interval_ns, spin_ns)`, printed as p50 and max
+void
+print_lateness(const char* name, uint64_t interval_ns, uint64_t spin_ns) noexcept {
+    LA_CONSTEXPR_VAR unsigned SAMPLES = 100;
+    uint64_t late[SAMPLES];
+    for (unsigned i = 0; i < SAMPLES; ++i) {
+        const uint64_t start = la::get_monotonic_ns();
+        la::sleep_for(interval_ns, spin_ns);
+        const uint64_t slept = la::get_monotonic_ns() - start;
+        late[i] = slept > interval_ns ? slept - interval_ns : 0;
+    }
+    std::sort(late, late + SAMPLES);
+    printf("  %-26s %9.1f %9.1f\n", name, late[SAMPLES / 2] / 1e3, late[SAMPLES - 1] / 1e3);
+} // print_lateness
+
+void
+sleep_error() noexcept {
+    // About 200 ms of sleeping per interval, within what one measurement holds
+    const uint64_t intervals_us[] = { 100, 500, 1000, 2000, 5000, 10000 };
+    uint64_t margin = 0;
+    printf("Sleep error, us        p50       p99       max\n");
+    for (uint64_t us : intervals_us) {
+        const uint64_t wanted = 200000 / us;
+        const unsigned samples = static_cast<unsigned>(wanted < 20 ? 20 : wanted > 256 ? 256 : wanted);
+        const la::SleepError e = la::measure_sleep_error(us * 1000, samples);
+        printf("  %5llu us x %3u  %9.1f %9.1f %9.1f\n", static_cast<unsigned long long>(us), samples,
+               e.p50_ns / 1e3, e.p99_ns / 1e3, e.max_ns / 1e3);
+        if (e.p99_ns > margin) margin = e.p99_ns;
+    }
+
+    // One margin serves every interval: the largest p99
+    printf("Suggested spin margin (spin_ns): %.1f us\n", margin / 1e3);
+    printf("Lateness of 100 x 1 ms, us         p50       max\n");
+    print_lateness("sleep_for(1 ms)", 1000000, 0);
+    print_lateness("sleep_for(1 ms, margin)", 1000000, margin);
+} // sleep_error
+
+} // namespace
+
+int main() {
+    const bool tsc = la::tsc_calibrate();
+    printf("Invariant TSC: %s\n", tsc ? "yes" : "no, tsc_now_ns() is get_monotonic_ns()");
+
+    printf("  get_monotonic_secs %6.1f ns\n", per_call([]() noexcept {
+        return static_cast<uint64_t>(la::get_monotonic_secs() * 1e9);
+    }));
+    printf("  get_monotonic_ns   %6.1f ns\n", per_call([]() noexcept { return la::get_monotonic_ns(); }));
+    printf("  tsc_now_ns         %6.1f ns\n", per_call([]() noexcept { return la::tsc_now_ns(); }));
+#if defined(LA_HAS_TSC)
+    printf("  __rdtsc            %6.1f ns\n", per_call([]() noexcept { return static_cast<uint64_t>(__rdtsc()); }));
+#endif
+
+    // Both clocks across the same 200 ms
+    const uint64_t mono_begin = la::get_monotonic_ns(), tsc_begin = la::tsc_now_ns();
+    la::sleep(200);
+    const uint64_t mono = la::get_monotonic_ns() - mono_begin, ticked = la::tsc_now_ns() - tsc_begin;
+    printf("Over %.1f ms tsc_now_ns() drifted %+lld ns\n", mono / 1e6,
+           static_cast<long long>(ticked) - static_cast<long long>(mono));
+
+    sleep_error();
+    return 0;
+}
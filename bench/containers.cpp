@@ -0,0 +1,165 @@
+#include "bench.hpp"
+#include "la/containers.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// `SmallVector` and `HashMap` against `std::vector` and `std::unordered_map`, both
+// on their default allocators. Each figure is the whole workload in milliseconds.
+//
+//     g++ -std=c++14 -O2 -Isrc bench/containers.cpp src/la/*.cpp -o bench_containers -lpthread
+
+namespace {
+
+LA_CONSTEXPR_VAR uint64_t COUNT = 1000000;
+LA_CONSTEXPR_VAR uint64_t STRINGS = 100000;
+
+struct Name { char text[24]; };
+
+uint64_t* g_keys;
+const Name* g_names;
+std::vector<std::string>* g_std_names;
+
+template <typename F>
+double ms(F&& body) noexcept { return bench::best_ns(3, 1, body) / 1e6; }
+
+void
+row(const char* name, double la_ms, double std_ms) noexcept {
+    printf("  %-32s %8.1f  %8.1f\n", name, la_ms, std_ms);
+} // row
+
+void
+vectors() noexcept {
+    row("push_back 1M u64", ms([]() noexcept {
+        la::Vector<uint64_t> v;
+        for (uint64_t i = 0; i < COUNT; ++i) (void)v.push_back(i);
+        bench::g_sink = v[COUNT - 1];
+    }), ms([]() noexcept {
+        std::vector<uint64_t> v;
+        for (uint64_t i = 0; i < COUNT; ++i) v.push_back(i);
+        bench::g_sink = v[COUNT - 1];
+    }));
+
+    // The common case for scratch lists: a handful of elements, gone at end of scope
+    row("1M short-lived, <=7 elements", ms([]() noexcept {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < COUNT; ++i) {
+            la::SmallVector<uint32_t, 8> v;
+            for (uint32_t j = 0; j <= (i & 7u); ++j) (void)v.push_back(j);
+            sum += v.size();
+        }
+        bench::g_sink = sum;
+    }), ms([]() noexcept {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < COUNT; ++i) {
+            std::vector<uint32_t> v;
+            for (uint32_t j = 0; j <= (i & 7u); ++j) v.push_back(j);
+            sum += v.size();
+        }
+        bench::g_sink = sum;
+    }));
+} // vectors
+
+void
+integer_maps() noexcept {
+    la::HashMap<uint64_t, uint64_t> map;
+    std::unordered_map<uint64_t, uint64_t> std_map;
+    // Insert into a fresh map each run, keep the last one for the lookups below
+    row("insert 1M random u64", ms([&]() noexcept {
+        la::HashMap<uint64_t, uint64_t> fresh;
+        for (uint64_t i = 0; i < COUNT; ++i) (void)fresh.insert(g_keys[i], i);
+        map = la::move(fresh);
+    }), ms([&]() noexcept {
+        std::unordered_map<uint64_t, uint64_t> fresh;
+        for (uint64_t i = 0; i < COUNT; ++i) fresh.emplace(g_keys[i], i);
+        std_map = std::move(fresh);
+    }));
+
+    row("find 1M hits", ms([&]() noexcept {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < COUNT; ++i) sum += *map.find(g_keys[(i * 7919) % COUNT]);
+        bench::g_sink = sum;
+    }), ms([&]() noexcept {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < COUNT; ++i) sum += std_map.find(g_keys[(i * 7919) % COUNT])->second;
+        bench::g_sink = sum;
+    }));
+
+    // Keys are odd, these are even
+    row("find 1M misses", ms([&]() noexcept {
+        uint64_t found = 0;
+        for (uint64_t i = 0; i < COUNT; ++i) found += map.find(g_keys[i] + 1) != nullptr;
+        bench::g_sink = found;
+    }), ms([&]() noexcept {
+        uint64_t found = 0;
+        for (uint64_t i = 0; i < COUNT; ++i) found += std_map.find(g_keys[i] + 1) != std_map.end();
+        bench::g_sink = found;
+    }));
+
+    // Once, erasing from the maps above
+    const uint64_t start = la::get_monotonic_ns();
+    for (uint64_t i = 0; i < COUNT; i += 2) (void)map.erase(g_keys[i]);
+    const uint64_t erased = la::get_monotonic_ns() - start;
+    const uint64_t std_start = la::get_monotonic_ns();
+    for (uint64_t i = 0; i < COUNT; i += 2) std_map.erase(g_keys[i]);
+    const uint64_t std_erased = la::get_monotonic_ns() - std_start;
+    row("erase 500k", erased / 1e6, std_erased / 1e6);
+} // integer_maps
+
+void
+string_maps() noexcept {
+    la::HashMap<la::String, uint32_t> map;
+    std::unordered_map<std::string, uint32_t> std_map;
+    row("insert 100k string keys", ms([&]() noexcept {
+        la::HashMap<la::String, uint32_t> fresh;
+        for (uint64_t i = 0; i < STRINGS; ++i) (void)fresh.insert(la::StringView{ g_names[i].text }, static_cast<uint32_t>(i));
+        map = la::move(fresh);
+    }), ms([&]() noexcept {
+        std::unordered_map<std::string, uint32_t> fresh;
+        for (uint64_t i = 0; i < STRINGS; ++i) fresh.emplace(g_names[i].text, static_cast<uint32_t>(i));
+        std_map = std::move(fresh);
+    }));
+
+    // `HashMap` looks up by `StringView`; `unordered_map` gets prebuilt `std::string`s
+    row("find 1M string keys", ms([&]() noexcept {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < COUNT; ++i) sum += *map.find(la::StringView{ g_names[(i * 7919) % STRINGS].text });
+        bench::g_sink = sum;
+    }), ms([&]() noexcept {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < COUNT; ++i) sum += std_map.find((*g_std_names)[(i * 7919) % STRINGS])->second;
+        bench::g_sink = sum;
+    }));
+} // string_maps
+
+} // namespace
+
+int main() {
+    // Odd random keys, so `key + 1` is never present
+    std::vector<uint64_t> keys(COUNT);
+    uint64_t state = 0x9e3779b97f4a7c15ull;
+    for (uint64_t& key : keys) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        key = state | 1;
+    }
+    g_keys = keys.data();
+
+    std::vector<Name> names(STRINGS);
+    std::vector<std::string> std_names;
+    std_names.reserve(STRINGS);
+    for (uint64_t i = 0; i < STRINGS; ++i) {
+        snprintf(names[i].text, sizeof(names[i].text), "component.%07llu", static_cast<unsigned long long>(i));
+        std_names.emplace_back(names[i].text);
+    }
+    g_names = names.data();
+    g_std_names = &std_names;
+
+    printf("ms                                       la       std\n");
+    vectors();
+    integer_maps();
+    string_maps();
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "bench.hpp"
+#include "la/pool.hpp"
+
+#include <stdlib.h> // malloc, realloc, free
+
+// `heap_alloc`/`heap_realloc`/`heap_free` against `malloc`/`realloc`/`free`. Churn
+// keeps a set of blocks live and replaces a random one with a block of random size.
+//
+//     g++ -std=c++14 -O2 -Isrc bench/heap.cpp src/la/*.cpp -o bench_heap -lpthread
+
+namespace {
+
+LA_CONSTEXPR_VAR int MAX_LIVE = 4096;
+
+void* g_blocks[MAX_LIVE];
+uint32_t g_rng = 0x9e3779b9u;
+
+uint32_t
+next_random() noexcept {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return g_rng;
+} // next_random
+
+void* alloc_block(bool heap, size_t size) noexcept { return heap ? la::heap_alloc(size) : malloc(size); }
+void free_block(bool heap, void* ptr) noexcept { if (heap) la::heap_free(ptr); else free(ptr); }
+
+// Nanoseconds per free + alloc, sizes in [`min_size`, `max_size`)
+double
+churn(bool heap, int live, size_t min_size, size_t max_size, uint64_t ops) noexcept {
+    g_rng = 0x9e3779b9u;
+    for (int i = 0; i < live; ++i) g_blocks[i] = alloc_block(heap, min_size);
+    const double ns = bench::best_ns(3, ops, [=]() noexcept {
+        for (uint64_t op = 0; op < ops; ++op) {
+            const uint32_t random = next_random();
+            const int at = static_cast<int>(random % static_cast<uint32_t>(live));
+            free_block(heap, g_blocks[at]);
+            void* ptr = alloc_block(heap, min_size + (random >> 8) % (max_size - min_size));
+            *static_cast<char*>(ptr) = static_cast<char>(op);
+            g_blocks[at] = ptr;
+        }
+    });
+    for (int i = 0; i < live; ++i) free_block(heap, g_blocks[i]);
+    return ns;
+} // churn
+
+// Nanoseconds per block grown from 16 B to 8 KB in 16-byte steps
+double
+realloc_growth(bool heap) noexcept {
+    LA_CONSTEXPR_VAR uint64_t BLOCKS = 1000;
+    return bench::best_ns(3, BLOCKS, [=]() noexcept {
+        for (uint64_t block = 0; block < BLOCKS; ++block) {
+            void* ptr = nullptr;
+            for (size_t size = 16; size <= 8192; size += 16) {
+                ptr = heap ? la::heap_realloc(ptr, size) : realloc(ptr, size);
+                static_cast<char*>(ptr)[size - 1] = 1;
+            }
+            free_block(heap, ptr);
+        }
+    });
+} // realloc_growth
+
+} // namespace
+
+int main() {
+    printf("ns per free + alloc                      heap  malloc\n");
+    printf("  %-36s %6.1f  %6.1f\n", "small, 16-1040 B, 4096 live",
+           churn(true, 4096, 16, 1040, 2000000), churn(false, 4096, 16, 1040, 2000000));
+    printf("  %-36s %6.1f  %6.1f\n", "tiny, 16-80 B, 256 live",
+           churn(true, 256, 16, 80, 2000000), churn(false, 256, 16, 80, 2000000));
+    printf("  %-36s %6.1f  %6.1f\n", "mixed, 16 B-16 KB, 1024 live",
+           churn(true, 1024, 16, 16384, 200000), churn(false, 1024, 16, 16384, 200000));
+    printf("us per block grown 16 B -> 8 KB\n");
+    printf("  %-36s %6.2f  %6.2f\n", "realloc by 16 B", realloc_growth(true) / 1e3, realloc_growth(false) / 1e3);
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include "bench.hpp"
+#include "la/pool.hpp"
+
+#include <stdlib.h> // malloc, free
+
+// `la::Pool` against `malloc` for 32-byte objects: bursts, alloc/free pairs, and
+// objects allocated on one thread and freed on another.
+//
+//     g++ -std=c++14 -O2 -Isrc bench/pool.cpp src/la/*.cpp -o bench_pool -lpthread
+
+namespace {
+
+LA_CONSTEXPR_VAR int COUNT = 10000;
+LA_CONSTEXPR_VAR int PAIRS = 1000000;
+
+struct Node { uint64_t words[4]; };
+
+void* g_objects[COUNT];
+
+void* alloc_node(bool pool) noexcept { return pool ? la::pool_alloc(sizeof(Node)) : malloc(sizeof(Node)); }
+void free_node(bool pool, void* ptr) noexcept { if (pool) la::pool_free(ptr, sizeof(Node)); else free(ptr); }
+
+// `COUNT` allocations, then every one freed in reverse
+double
+burst(bool pool) noexcept {
+    return bench::best_ns(5, COUNT, [pool]() noexcept {
+        for (int i = 0; i < COUNT; ++i) g_objects[i] = alloc_node(pool);
+        for (int i = COUNT; i-- > 0;) free_node(pool, g_objects[i]);
+    });
+} // burst
+
+double
+pairs(bool pool) noexcept {
+    return bench::best_ns(5, PAIRS, [pool]() noexcept {
+        for (int i = 0; i < PAIRS; ++i) {
+            void* ptr = alloc_node(pool);
+            static_cast<Node*>(ptr)->words[0] = static_cast<uint64_t>(i);
+            bench::g_sink = static_cast<Node*>(ptr)->words[0];
+            free_node(pool, ptr);
+        }
+    });
+} // pairs
+
+struct Freeing {
+    bool pool;
+    uint64_t ns;
+};
+
+void
+free_objects(void* arg) noexcept {
+    Freeing& freeing = *static_cast<Freeing*>(arg);
+    const uint64_t start = la::get_monotonic_ns();
+    for (int i = 0; i < COUNT; ++i) free_node(freeing.pool, g_objects[i]);
+    freeing.ns = la::get_monotonic_ns() - start;
+    if (freeing.pool) la::pool_flush_thread();
+} // free_objects
+
+// Allocated here, freed by a second thread: every object goes through the shared lists
+double
+cross_thread(bool pool) noexcept {
+    uint64_t best = ~0ull;
+    for (int run = 0; run < 5; ++run) {
+        const uint64_t start = la::get_monotonic_ns();
+        for (int i = 0; i < COUNT; ++i) g_objects[i] = alloc_node(pool);
+        const uint64_t allocated = la::get_monotonic_ns() - start;
+
+        Freeing freeing{ pool, 0 };
+        la::Thread thread;
+        if (!thread.start(&free_objects, &freeing)) return 0.0;
+        thread.join();
+        if (allocated + freeing.ns < best) best = allocated + freeing.ns;
+    }
+    return static_cast<double>(best) / COUNT;
+} // cross_thread
+
+} // namespace
+
+int main() {
+    printf("%d-byte objects, ns per alloc + free     pool  malloc\n", static_cast<int>(sizeof(Node)));
+    printf("  burst of %-27d %6.1f  %6.1f\n", COUNT, burst(true), burst(false));
+    printf("  %-36s %6.1f  %6.1f\n", "alloc/free pairs", pairs(true), pairs(false));
+    printf("  %-36s %6.1f  %6.1f\n", "freed on another thread", cross_thread(true), cross_thread(false));
+
+    la::pool_flush_thread();
+    la::pool_trim();
+    const la::PoolStats stats = la::pool_stats();
+    printf("After trim: %llu slabs, %llu KB, %llu released\n",
+           static_cast<unsigned long long>(stats.slabs), static_cast<unsigned long long>(stats.slab_bytes / 1024),
+           static_cast<unsigned long long>(stats.released));
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include "bench.hpp"
+
+#include <memory>
+
+// Resize storm: a live drag sends many size events per painted frame. Drives
+// `native::Framebuffer` directly, no window needed: a fresh allocation per event
+// (what resizing used to do), `resize()` per event reusing the capacity, and
+// `resize()` once per frame with the latest size (what `Window::render()` does
+// with the pending geometry). Every frame is cleared at its final size.
+//
+//     g++ -std=c++14 -O2 -Isrc bench/resize.cpp src/la/*.cpp -o bench_resize -lpthread
+
+namespace {
+
+LA_CONSTEXPR_VAR int FRAMES = 240;
+LA_CONSTEXPR_VAR int EVENTS_PER_FRAME = 16;
+
+enum class Mode { FreshPerEvent, ResizePerEvent, ResizePerFrame };
+
+// Drag from 640x480 to 1920x1080 and back, `EVENTS_PER_FRAME` sizes per frame
+void
+drag_size(int event, int& w, int& h) noexcept {
+    const int steps = FRAMES * EVENTS_PER_FRAME / 2;
+    const int at = event < steps ? event : 2 * steps - event;
+    w = 640 + (1920 - 640) * at / steps;
+    h = 480 + (1080 - 480) * at / steps;
+} // drag_size
+
+// Nanoseconds per frame, starting from an empty framebuffer
+uint64_t
+drag(Mode mode, unsigned& allocations) noexcept {
+    std::unique_ptr<la::native::Framebuffer> fb{ new la::native::Framebuffer };
+    allocations = 0;
+    int stride = 0, rows = 0; // A new capacity means a new allocation
+    const uint64_t start = la::get_monotonic_ns();
+    for (int frame = 0, event = 0; frame < FRAMES; ++frame) {
+        int w = 0, h = 0;
+        for (int i = 0; i < EVENTS_PER_FRAME; ++i, ++event) {
+            drag_size(event, w, h);
+            if (mode == Mode::ResizePerFrame) continue;
+            if (mode == Mode::FreshPerEvent) {
+                fb.reset(); // Old buffer gone before the new one, as `release()` did
+                fb.reset(new la::native::Framebuffer);
+                stride = rows = 0;
+            }
+            if (fb->resize(w, h) != la::AboutError::None) return 0;
+            if (fb->stride != stride || fb->capacity_height != rows) ++allocations;
+            stride = fb->stride;
+            rows = fb->capacity_height;
+        }
+        if (mode == Mode::ResizePerFrame) {
+            if (fb->resize(w, h) != la::AboutError::None) return 0;
+            if (fb->stride != stride || fb->capacity_height != rows) ++allocations;
+            stride = fb->stride;
+            rows = fb->capacity_height;
+        }
+        fb->clear(0xff000000u | static_cast<uint32_t>(frame), w, h);
+    }
+    const uint64_t ns = (la::get_monotonic_ns() - start) / FRAMES;
+    bench::g_sink = static_cast<const uint32_t*>(fb->pixels)[0];
+    return ns;
+} // drag
+
+} // namespace
+
+int main() {
+    const char* names[] = { "fresh buffer per event", "resize() per event", "resize() per frame" };
+    const Mode modes[] = { Mode::FreshPerEvent, Mode::ResizePerEvent, Mode::ResizePerFrame };
+    printf("%d frames, %d size events each, 640x480 to 1920x1080 and back\n", FRAMES, EVENTS_PER_FRAME);
+    for (int m = 0; m < 3; ++m) {
+        uint64_t best = ~0ull;
+        unsigned allocations = 0;
+        for (int run = 0; run < 3; ++run) {
+            const uint64_t ns = drag(modes[m], allocations);
+            if (ns < best) best = ns;
+        }
+        printf("  %-24s %8.1f us/frame, %5u allocations\n", names[m], best / 1e3, allocations);
+    }
+    return 0;
+}
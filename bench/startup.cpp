@@ -0,0 +1,66 @@
+#include "bench.hpp"
+
+// Startup cost of the runtimes. Built with `STARTUP_TARGET` this is the program
+// being measured: it prints one line and exits, hosted or with `LA_NOSTD`.
+// Without it, it spawns each target given on the command line and reports the
+// mean time from spawn to exit. `startup.sh` builds the targets, prints their
+// sizes and runs this.
+//
+//     sh bench/startup.sh
+
+#if defined(STARTUP_TARGET)
+
+int main() {
+    static const char HELLO[] = "hello\n";
+    la::print(HELLO, sizeof(HELLO) - 1);
+    return 0;
+}
+
+#else
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace {
+
+LA_CONSTEXPR_VAR int RUNS = 2000;
+
+// Microseconds from `posix_spawn` to the reaped exit, best of 3 batches
+double
+spawn_us(const char* path, posix_spawn_file_actions_t* actions) noexcept {
+    char* const argv[] = { const_cast<char*>(path), nullptr };
+    return bench::best_ns(3, RUNS, [&]() noexcept {
+        for (int i = 0; i < RUNS; ++i) {
+            pid_t pid;
+            int status = 0;
+            if (posix_spawn(&pid, path, actions, nullptr, argv, environ) != 0) return;
+            (void)waitpid(pid, &status, 0);
+        }
+    }) / 1e3;
+} // spawn_us
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // Targets write to /dev/null, the console would dominate
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, 1, "/dev/null", O_WRONLY, 0);
+
+    printf("Spawn to exit, mean of %d runs\n", RUNS);
+    for (int i = 1; i < argc; ++i) {
+        if (access(argv[i], X_OK) != 0) {
+            printf("  %-32s not built\n", argv[i]);
+            continue;
+        }
+        printf("  %-32s %8.1f us\n", argv[i], spawn_us(argv[i], &actions));
+    }
+    posix_spawn_file_actions_destroy(&actions);
+    return 0;
+}
+
+#endif // STARTUP_TARGET
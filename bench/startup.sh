@@ -0,0 +1,26 @@
+#!/bin/sh
+# Binary size and spawn-to-exit time of a print-and-exit program: hosted with
+# dynamic glibc, hosted with static glibc, and LA_NOSTD (no libc at all). Linux,
+# x86-64 or AArch64. Run from the repository root:
+#
+#     sh bench/startup.sh [output directory, default /tmp/la_startup]
+
+set -e
+CXX=${CXX:-g++}
+OUT=${1:-/tmp/la_startup}
+mkdir -p "$OUT"
+
+COMMON="-std=c++14 -O2 -Isrc -DSTARTUP_TARGET -ffunction-sections -fdata-sections -Wl,--gc-sections -s"
+NOSTD="-DLA_NOSTD -static -nostdlib -fno-pie -no-pie -ffreestanding -fno-exceptions -fno-rtti
+       -fno-threadsafe-statics -fno-stack-protector"
+
+$CXX $COMMON bench/startup.cpp src/la/la.cpp -o "$OUT/hosted_dynamic" -lpthread
+$CXX $COMMON -static bench/startup.cpp src/la/la.cpp -o "$OUT/hosted_static" -lpthread
+$CXX $COMMON $NOSTD bench/startup.cpp src/la/la.cpp -o "$OUT/nostd" -lgcc
+$CXX -std=c++14 -O2 -Isrc bench/startup.cpp src/la/*.cpp -o "$OUT/spawn" -lpthread
+
+echo "Stripped size, --gc-sections"
+for target in hosted_dynamic hosted_static nostd; do
+    printf '  %-32s %8s bytes\n' "$OUT/$target" "$(wc -c < "$OUT/$target")"
+done
+"$OUT/spawn" "$OUT/hosted_dynamic" "$OUT/hosted_static" "$OUT/nostd"
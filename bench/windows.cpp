@@ -0,0 +1,131 @@
+#include "bench.hpp"
+#include "la/display_list.hpp"
+
+#include <memory>
+
+// Windows rendering side by side, one thread each. There is no Linux window
+// backend, so each thread owns what a window owns without the OS window: an
+// `EventQueue`, a `DisplayList` and a `native::Framebuffer`. A frame drains the
+// input, records the UI and replays it into the framebuffer. Aggregate frames per
+// second against the window count shows how far the per-window state scales;
+// past the core count it can't.
+//
+//     g++ -std=c++14 -O2 -Isrc bench/windows.cpp src/la/*.cpp -o bench_windows -lpthread
+
+namespace {
+
+LA_CONSTEXPR_VAR int WIDTH = 1280;
+LA_CONSTEXPR_VAR int HEIGHT = 720;
+LA_CONSTEXPR_VAR int FRAMES = 60;
+LA_CONSTEXPR_VAR unsigned MAX_WINDOWS = 16;
+
+struct Events : la::IWindowEvents {
+    int x{ 0 }, y{ 0 };
+    void on_mouse_move(int x_, int y_) noexcept override { x = x_; y = y_; }
+};
+
+struct RenderWindow {
+    la::EventQueue queue;
+    la::DisplayList list;
+    la::native::Framebuffer fb;
+    Events events;
+    uint32_t seed{ 0 };
+    la::Thread thread;
+};
+
+la::Atomic<uint32_t> g_ready{ 0 };
+la::Atomic<uint32_t> g_go{ 0 };
+
+// What the window thread would post for one frame
+void
+post_input(RenderWindow& w, int frame) noexcept {
+    for (int i = 0; i < 8; ++i) {
+        la::Event e;
+        e.type = la::EventType::MouseMove;
+        e.x = (frame * 8 + i) % WIDTH;
+        e.y = (frame * 5 + i) % HEIGHT;
+        w.queue.push(e);
+    }
+    w.queue.flush();
+} // post_input
+
+void
+record_frame(RenderWindow& w) noexcept {
+    w.list.reset();
+    w.list.clear(0xff202020u);
+    for (int panel = 0; panel < 4; ++panel) {
+        w.list.fill_rect(la::Rect::from_size(20 + panel * 315, 20, 300, 680), 0xff303840u + static_cast<uint32_t>(panel));
+    }
+    uint32_t rng = w.seed;
+    for (int i = 0; i < 1500; ++i) {
+        rng = rng * 1664525u + 1013904223u;
+        const int x = static_cast<int>(rng % (WIDTH - 64)), y = static_cast<int>((rng >> 12) % (HEIGHT - 32));
+        w.list.fill_rect(la::Rect::from_size(x, y, 16 + static_cast<int>(rng >> 27) * 2, 8 + static_cast<int>(rng & 15)),
+                         0xff000000u | rng);
+    }
+    static const char LINE[] = "The quick brown fox jumps over the lazy dog 0123456789";
+    for (int y = 30; y < HEIGHT - 20; y += 12) w.list.text(30, y, LINE, sizeof(LINE) - 1, 0xffe0e0e0u);
+    w.list.fill_rect(la::Rect::from_size(w.events.x, w.events.y, 12, 12), 0xffffffffu); // Cursor
+} // record_frame
+
+void
+render_thread(void* arg) noexcept {
+    RenderWindow& w = *static_cast<RenderWindow*>(arg);
+    (void)w.fb.resize(WIDTH, HEIGHT);
+    la::Canvas canvas{ static_cast<uint32_t*>(w.fb.pixels), WIDTH, HEIGHT, w.fb.stride };
+    (void)g_ready.fetch_add(1);
+    while (!g_go.load()) la::yield_thread();
+    for (int frame = 0; frame < FRAMES; ++frame) {
+        post_input(w, frame);
+        (void)w.queue.dispatch(w.events);
+        record_frame(w);
+        w.list.replay(canvas);
+    }
+} // render_thread
+
+// Frames per second over all windows
+double
+run(unsigned count) noexcept {
+    std::unique_ptr<RenderWindow> windows[MAX_WINDOWS];
+    for (unsigned i = 0; i < count; ++i) {
+        windows[i].reset(new RenderWindow);
+        windows[i]->seed = 12345u + i;
+    }
+    g_ready.store(0);
+    g_go.store(0);
+    unsigned started = 0;
+    for (unsigned i = 0; i < count; ++i) started += windows[i]->thread.start(&render_thread, windows[i].get());
+    if (started != count) {
+        g_go.store(1);
+        for (unsigned i = 0; i < count; ++i) windows[i]->thread.join();
+        return 0.0;
+    }
+
+    while (g_ready.load() != count) la::yield_thread();
+    const uint64_t start = la::get_monotonic_ns();
+    g_go.store(1);
+    for (unsigned i = 0; i < count; ++i) windows[i]->thread.join();
+    const uint64_t elapsed = la::get_monotonic_ns() - start;
+    return static_cast<double>(count) * FRAMES * 1e9 / static_cast<double>(elapsed ? elapsed : 1);
+} // run
+
+} // namespace
+
+int main() {
+    const la::CpuTopology topology = la::get_cpu_topology();
+    printf("%u logical CPUs, %u cores; %dx%d, %d frames per window\n",
+           topology.logical, topology.cores, WIDTH, HEIGHT, FRAMES);
+    printf("  windows   frames/s   per window   scaling\n");
+    const unsigned counts[] = { 1, 2, 4, 8, 16 };
+    double single = 0.0;
+    for (unsigned count : counts) {
+        double best = 0.0;
+        for (int r = 0; r < 3; ++r) {
+            const double fps = run(count);
+            if (fps > best) best = fps;
+        }
+        if (count == 1) single = best;
+        printf("  %7u %10.1f %12.1f %8.2fx\n", count, best, best / count, single > 0.0 ? best / single : 0.0);
+    }
+    return 0;
+}
@@ -1,11 +1,13 @@
 ﻿#include "la/la.hpp"
 #include "la/gl.hpp"
+#include "la/scheduler.hpp"
 
 namespace gl = la::gl;
 
 struct Window : public la::IWindowEvents {
     la::Window win;
     la::Out out;
+    la::FrameScheduler scheduler;
     uint32_t counter = 0;
 
     Window() noexcept : win{ *this } {
@@ -13,6 +15,7 @@ struct Window : public la::IWindowEvents {
     }
 
     void on_render_software() noexcept override {
+        LA_PROFILE_ZONE_COUNTERS("on_render_software");
         int w = win.width();
         int h = win.height();
         win.fb().clear(counter, w, h); // Blue color
@@ -26,10 +29,12 @@ struct Window : public la::IWindowEvents {
     }
 
     void on_key_up(la::Key key) noexcept override {
+        scheduler.request_frame();
         out << "Released key: " << la::get_key_name(key) << la::endl;
     }
 
     void on_key_down(la::Key key) noexcept override {
+        scheduler.request_frame();
         out << "Pressed key: " << la::get_key_name(key) << la::endl;
     }
 };
@@ -48,42 +53,37 @@ struct Application : public Window {
     }
 }; // struct Application
 
-static inline float get_fps(double dt_sec) noexcept {
-    if (dt_sec <= 0.0)
-        return 0.0f;
-    return static_cast<float>(1.0 / dt_sec);
-}
-
-static inline float get_fps_smooth(double dt_sec) noexcept {
-    static double fps_smooth = 0.0;
-    const double alpha = 0.1;
-    float fps = get_fps(dt_sec);
-    fps_smooth = alpha * fps + (1.0 - alpha) * fps_smooth;
-    return static_cast<float>(fps_smooth);
-}
-
 inline void run() noexcept {
     Application app;
 
-    // Timer things
-    double last_time = la::get_monotonic_secs();
-    double dt;
-    
+    // Frame timing percentiles every 256 frames (console builds)
+    app.win.set_timings_dump(true);
+    (void)app.win.set_perf_counters(true); // IPC and misses in the dump, when the OS allows
+    app.win.set_event_buffering(true);
+    app.scheduler.set_wait(app.win);
 
-    // Main loop
+    // Main loop, paced by the scheduler instead of spinning a core.
+    // Event-driven (on battery) it blocks until input or the next battery check
     while (app.win.poll_events()) {
-        // Calculate delta time in seconds
-        double current_time = la::get_monotonic_secs();
-        dt = current_time - last_time;
-        last_time = current_time;
-
-        // app.out << "fps: " << get_fps_smooth(dt) << la::endl;
+        app.win.events().dispatch(app.win.handler()); // One batch per frame
+        if (app.win.input().just_pressed(la::Key::Escape))
+            app.win.quit();
 
+        if (!app.scheduler.wait())
+            continue;
 
         app.win.render();
         app.counter++;
     } // while
 
+    const la::FrameScheduler::Stats& stats = app.scheduler.stats();
+    app.out << "Frames: " << stats.frames << ", missed: " << stats.missed
+            << ", worst late (ms): " << stats.worst_late_secs * 1000.0 << la::endl;
+
+#if defined(LA_PROFILE) // Open in https://ui.perfetto.dev
+    if (!la::profile_export_chrome("la_trace.json"))
+        app.out << "Couldn't write la_trace.json" << la::endl;
+#endif
 
     // app.win.set_renderer(la::RendererApi::None); // ERROR. Shows message to the user (DEBUG only)
 } // run
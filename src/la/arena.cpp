@@ -0,0 +1,146 @@
+#include "arena.hpp"
+
+namespace la {
+
+namespace detail {
+#ifdef LA_ARENA_POISON
+    static inline void
+    arena_poison(unsigned char* bytes, size_t size, unsigned char value) noexcept {
+        for (size_t i = 0; i < size; ++i) bytes[i] = value;
+    } // arena_poison
+#endif
+} // namespace detail
+
+// ------------------------------ Allocation ----------------------------------
+
+void* Arena::
+alloc_slow(size_t size, size_t align) noexcept {
+    LA_ALLOC_TAG(AllocTag::Arena);
+    // Worst-case padding: block data is only `DEFAULT_ALIGN`-aligned
+    const size_t need = size + (align > DEFAULT_ALIGN ? align - DEFAULT_ALIGN : 0);
+
+    // Move along the chain, allocating only when every kept block is full
+    for (;;) {
+        Block* next = m_current ? m_current->next : m_first;
+        if (!next) {
+            const size_t capacity = need > m_block_size - sizeof(Block) ?
+                                    need : m_block_size - sizeof(Block);
+            next = static_cast<Block*>(::la::alloc(sizeof(Block) + capacity, m_alloc_flags));
+            if (!next) {
+                m_failed = true;
+                return nullptr;
+            }
+            next->next = nullptr;
+            next->capacity = capacity;
+            if (m_current) m_current->next = next;
+            else           m_first = next;
+        }
+        next->used = 0;
+        m_current = next;
+        if (need <= next->capacity)
+            break;
+    }
+
+    return bump(*m_current, size, align);
+} // alloc_slow
+
+char* Arena::
+copy_string(const char* str, size_t length) noexcept {
+    char* dst = static_cast<char*>(alloc(length + 1, 1));
+    if (!dst) return nullptr;
+    for (size_t i = 0; i < length; ++i) dst[i] = str[i];
+    dst[length] = '\0';
+    return dst;
+} // copy_string
+
+// ------------------------------ Release -------------------------------------
+
+void Arena::
+update_peak() noexcept {
+    const size_t used = stats().used;
+    if (used > m_peak) m_peak = used;
+} // update_peak
+
+void Arena::
+rewind(const Marker& marker) noexcept {
+    if (!marker.block) {
+        reset();
+        return;
+    }
+    update_peak();
+
+    // Blocks after the marker's, up to the current one, are empty again
+    if (m_current != marker.block) {
+        for (Block* block = marker.block->next; block; block = block->next) {
+#ifdef LA_ARENA_POISON
+            detail::arena_poison(block->data(), block->used, 0xDD);
+#endif
+            block->used = 0;
+            if (block == m_current) break;
+        }
+    }
+#ifdef LA_ARENA_POISON
+    detail::arena_poison(marker.block->data() + marker.used, marker.block->used - marker.used, 0xDD);
+#endif
+    marker.block->used = marker.used;
+    m_current = marker.block;
+} // rewind
+
+void Arena::
+reset() noexcept {
+    update_peak();
+    for (Block* block = m_first; block; block = block->next) {
+#ifdef LA_ARENA_POISON
+        detail::arena_poison(block->data(), block->used, 0xDD);
+#endif
+        block->used = 0;
+    }
+    m_current = m_first;
+    m_failed = false;
+} // reset
+
+void Arena::
+release() noexcept {
+    LA_ALLOC_TAG(AllocTag::Arena);
+    Block* block = m_first;
+    while (block) {
+        Block* next = block->next;
+        ::la::free(block, sizeof(Block) + block->capacity);
+        block = next;
+    }
+    m_first = m_current = nullptr;
+    m_failed = false;
+} // release
+
+size_t Arena::
+discard_unused() noexcept {
+    LA_CONSTEXPR_VAR uintptr_t PAGE = 4096;
+    size_t discarded = 0;
+    for (Block* block = m_first; block; block = block->next) {
+        const uintptr_t begin = (reinterpret_cast<uintptr_t>(block->data() + block->used) + PAGE - 1) & ~(PAGE - 1);
+        const uintptr_t end = reinterpret_cast<uintptr_t>(block->data() + block->capacity) & ~(PAGE - 1);
+        if (begin >= end) continue;
+        ::la::discard_pages(reinterpret_cast<void*>(begin), end - begin);
+        discarded += end - begin;
+    }
+    return discarded;
+} // discard_unused
+
+// ------------------------------ Queries -------------------------------------
+
+ArenaStats Arena::
+stats() const noexcept {
+    ArenaStats result;
+    result.allocations = m_allocations;
+
+    // Blocks past the current one are always empty
+    for (const Block* block = m_first; block; block = block->next) {
+        result.used += block->used;
+        result.reserved += sizeof(Block) + block->capacity;
+        ++result.blocks;
+    }
+    result.peak = result.used > m_peak ? result.used : m_peak;
+    return result;
+} // stats
+
+} // namespace la
@@ -0,0 +1,180 @@
+#ifndef __LA_ARENA_HEADER_GUARD
+#define __LA_ARENA_HEADER_GUARD
+
+#include "la.hpp"
+
+/*
+    Linear (bump-pointer) allocation for transient data: display lists,
+    layout scratch, formatted strings. Allocating moves a cursor, nothing is
+    freed on its own; `reset()` or `rewind()` drops everything at once and
+    keeps the blocks, so a warmed-up arena never calls `la::alloc` again.
+
+        la::FrameArena frame;
+        for (;;) {
+            la::Arena& arena = frame.begin_frame(); // Last frame's data still valid
+            char* label = arena.copy_string("fps", 3);
+            ...
+        }
+
+    Define `LA_ARENA_POISON` (on by default with `_DEBUG`) to fill fresh
+    allocations with 0xCD and released ones with 0xDD.
+*/
+
+#if !defined(LA_ARENA_POISON) && defined(_DEBUG)
+#   define LA_ARENA_POISON
+#endif
+
+namespace la {
+
+// --------------------------- Arena ------------------------------------------
+
+struct ArenaStats {
+    size_t   used{ 0 };        // Bytes handed out since the last reset, padding included
+    size_t   peak{ 0 };        // Highest `used` seen so far
+    size_t   reserved{ 0 };    // Bytes taken from `la::alloc`, block headers included
+    uint32_t blocks{ 0 };
+    uint64_t allocations{ 0 }; // Since construction
+}; // struct ArenaStats
+
+struct Arena {
+    LA_CONSTEXPR_VAR static size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+    LA_CONSTEXPR_VAR static size_t DEFAULT_ALIGN = 16;
+
+    // Blocks stay chained in allocation order, walking them visits the
+    // allocations in order too (padding aside)
+    struct alignas(16) Block {
+        Block* next;
+        size_t capacity; // Bytes after the header
+        size_t used;
+
+        LA_NO_DISCARD unsigned char* data() noexcept {
+            return reinterpret_cast<unsigned char*>(this + 1);
+        }
+        LA_NO_DISCARD const unsigned char* data() const noexcept {
+            return reinterpret_cast<const unsigned char*>(this + 1);
+        }
+    }; // struct Block
+
+    // Allocation position to `rewind()` to
+    struct Marker {
+        Block* block;
+        size_t used;
+    }; // struct Marker
+
+    // `alloc_flags` (`la::AllocFlags`) apply to every block, e.g. large pages
+    // for arenas holding pixel data
+    explicit inline Arena(size_t block_size = DEFAULT_BLOCK_SIZE,
+                          uint32_t alloc_flags = ALLOC_DEFAULT) noexcept
+        : m_block_size{ block_size }, m_alloc_flags{ alloc_flags } {}
+    inline ~Arena() noexcept { release(); }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena(Arena&&) = delete;
+    Arena& operator=(Arena&&) = delete;
+
+    // ---------------------------- Allocation --------------------------------
+
+    // `align` is a power of two. Null when out of memory
+    LA_NO_DISCARD inline void* alloc(size_t size, size_t align = DEFAULT_ALIGN) noexcept;
+
+    // Uninitialized storage for `count` objects
+    template <typename T>
+    LA_NO_DISCARD inline T* alloc_array(size_t count) noexcept {
+        return static_cast<T*>(alloc(count * sizeof(T), alignof(T)));
+    }
+
+    // Zero-terminated copy of `length` bytes
+    LA_NO_DISCARD char* copy_string(const char* str, size_t length) noexcept;
+
+    // ---------------------------- Release -----------------------------------
+
+    LA_NO_DISCARD Marker mark() const noexcept {
+        return Marker{ m_current, m_current ? m_current->used : 0 };
+    }
+    // Drop everything allocated after `mark()`
+    void rewind(const Marker& marker) noexcept;
+    // Drop everything, keep the blocks
+    void reset() noexcept;
+    // Give the blocks back to the OS
+    void release() noexcept;
+    // Keep the blocks but drop the pages no allocation uses, they fault back in
+    // zeroed. Returns the unused bytes, resident or not
+    size_t discard_unused() noexcept;
+
+    // ---------------------------- Queries -----------------------------------
+
+    LA_NO_DISCARD ArenaStats stats() const noexcept;
+    LA_NO_DISCARD const Block* first_block() const noexcept { return m_first; }
+    LA_NO_DISCARD bool has_failed() const noexcept { return m_failed; }
+
+private:
+    LA_NO_DISCARD static inline void* bump(Block& block, size_t size, size_t align) noexcept;
+    void* alloc_slow(size_t size, size_t align) noexcept;
+    void update_peak() noexcept;
+
+    Block* m_first{ nullptr };
+    Block* m_current{ nullptr };
+    size_t m_block_size;
+    uint32_t m_alloc_flags;
+    size_t m_peak{ 0 };
+    uint64_t m_allocations{ 0 };
+    bool m_failed{ false }; // Some allocation returned null
+}; // struct Arena
+
+inline void* Arena::
+bump(Block& block, size_t size, size_t align) noexcept {
+    const uintptr_t base = reinterpret_cast<uintptr_t>(block.data());
+    const uintptr_t at = (base + block.used + (align - 1)) & ~static_cast<uintptr_t>(align - 1);
+    const size_t end = static_cast<size_t>(at - base) + size;
+    if (end > block.capacity)
+        return nullptr;
+    block.used = end;
+#ifdef LA_ARENA_POISON
+    unsigned char* bytes = reinterpret_cast<unsigned char*>(at);
+    for (size_t i = 0; i < size; ++i) bytes[i] = 0xCD;
+#endif
+    return reinterpret_cast<void*>(at);
+} // bump
+
+inline void* Arena::
+alloc(size_t size, size_t align) noexcept {
+    ++m_allocations;
+    if (m_current)
+        if (void* ptr = bump(*m_current, size, align))
+            return ptr;
+    return alloc_slow(size, align);
+} // alloc
+
+// --------------------------- Frame Arena ------------------------------------
+
+/// Two arenas swapped every frame: what frame N allocated stays valid through
+/// frame N + 1, long enough to diff against or to finish presenting.
+struct FrameArena {
+    explicit inline FrameArena(size_t block_size = Arena::DEFAULT_BLOCK_SIZE,
+                               uint32_t alloc_flags = ALLOC_DEFAULT) noexcept
+        : m_even{ block_size, alloc_flags }, m_odd{ block_size, alloc_flags } {}
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Resets and returns the arena the new frame allocates from
+    LA_NO_DISCARD Arena& begin_frame() noexcept {
+        ++m_frame;
+        current().reset();
+        return current();
+    }
+
+    LA_NO_DISCARD Arena& current() noexcept { return m_frame & 1 ? m_odd : m_even; }
+    LA_NO_DISCARD Arena& previous() noexcept { return m_frame & 1 ? m_even : m_odd; }
+    LA_NO_DISCARD uint64_t frame() const noexcept { return m_frame; }
+
+private:
+    Arena m_even;
+    Arena m_odd;
+    uint64_t m_frame{ 0 };
+}; // struct FrameArena
+
+} // namespace la
+
+#endif // __LA_ARENA_HEADER_GUARD
@@ -0,0 +1,263 @@
+#include "canvas.hpp"
+
+namespace la {
+
+// ------------------------------ Font ----------------------------------------
+
+namespace detail {
+    // Classic 5x7 font, ASCII 0x20..0x7E, column-major, bit 0 is the top row
+    LA_CONSTEXPR_VAR unsigned char FONT_5X7[95][5] {
+        { 0x00, 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x5F, 0x00, 0x00 }, //   !
+        { 0x00, 0x07, 0x00, 0x07, 0x00 }, { 0x14, 0x7F, 0x14, 0x7F, 0x14 }, // " #
+        { 0x24, 0x2A, 0x7F, 0x2A, 0x12 }, { 0x23, 0x13, 0x08, 0x64, 0x62 }, // $ %
+        { 0x36, 0x49, 0x55, 0x22, 0x50 }, { 0x00, 0x05, 0x03, 0x00, 0x00 }, // & '
+        { 0x00, 0x1C, 0x22, 0x41, 0x00 }, { 0x00, 0x41, 0x22, 0x1C, 0x00 }, // ( )
+        { 0x08, 0x2A, 0x1C, 0x2A, 0x08 }, { 0x08, 0x08, 0x3E, 0x08, 0x08 }, // * +
+        { 0x00, 0x50, 0x30, 0x00, 0x00 }, { 0x08, 0x08, 0x08, 0x08, 0x08 }, // , -
+        { 0x00, 0x60, 0x60, 0x00, 0x00 }, { 0x20, 0x10, 0x08, 0x04, 0x02 }, // . /
+        { 0x3E, 0x51, 0x49, 0x45, 0x3E }, { 0x00, 0x42, 0x7F, 0x40, 0x00 }, // 0 1
+        { 0x42, 0x61, 0x51, 0x49, 0x46 }, { 0x21, 0x41, 0x45, 0x4B, 0x31 }, // 2 3
+        { 0x18, 0x14, 0x12, 0x7F, 0x10 }, { 0x27, 0x45, 0x45, 0x45, 0x39 }, // 4 5
+        { 0x3C, 0x4A, 0x49, 0x49, 0x30 }, { 0x01, 0x71, 0x09, 0x05, 0x03 }, // 6 7
+        { 0x36, 0x49, 0x49, 0x49, 0x36 }, { 0x06, 0x49, 0x49, 0x29, 0x1E }, // 8 9
+        { 0x00, 0x36, 0x36, 0x00, 0x00 }, { 0x00, 0x56, 0x36, 0x00, 0x00 }, // : ;
+        { 0x08, 0x14, 0x22, 0x41, 0x00 }, { 0x14, 0x14, 0x14, 0x14, 0x14 }, // < =
+        { 0x00, 0x41, 0x22, 0x14, 0x08 }, { 0x02, 0x01, 0x51, 0x09, 0x06 }, // > ?
+        { 0x32, 0x49, 0x79, 0x41, 0x3E }, { 0x7E, 0x11, 0x11, 0x11, 0x7E }, // @ A
+        { 0x7F, 0x49, 0x49, 0x49, 0x36 }, { 0x3E, 0x41, 0x41, 0x41, 0x22 }, // B C
+        { 0x7F, 0x41, 0x41, 0x22, 0x1C }, { 0x7F, 0x49, 0x49, 0x49, 0x41 }, // D E
+        { 0x7F, 0x09, 0x09, 0x09, 0x01 }, { 0x3E, 0x41, 0x49, 0x49, 0x7A }, // F G
+        { 0x7F, 0x08, 0x08, 0x08, 0x7F }, { 0x00, 0x41, 0x7F, 0x41, 0x00 }, // H I
+        { 0x20, 0x40, 0x41, 0x3F, 0x01 }, { 0x7F, 0x08, 0x14, 0x22, 0x41 }, // J K
+        { 0x7F, 0x40, 0x40, 0x40, 0x40 }, { 0x7F, 0x02, 0x0C, 0x02, 0x7F }, // L M
+        { 0x7F, 0x04, 0x08, 0x10, 0x7F }, { 0x3E, 0x41, 0x41, 0x41, 0x3E }, // N O
+        { 0x7F, 0x09, 0x09, 0x09, 0x06 }, { 0x3E, 0x41, 0x51, 0x21, 0x5E }, // P Q
+        { 0x7F, 0x09, 0x19, 0x29, 0x46 }, { 0x46, 0x49, 0x49, 0x49, 0x31 }, // R S
+        { 0x01, 0x01, 0x7F, 0x01, 0x01 }, { 0x3F, 0x40, 0x40, 0x40, 0x3F }, // T U
+        { 0x1F, 0x20, 0x40, 0x20, 0x1F }, { 0x3F, 0x40, 0x38, 0x40, 0x3F }, // V W
+        { 0x63, 0x14, 0x08, 0x14, 0x63 }, { 0x07, 0x08, 0x70, 0x08, 0x07 }, // X Y
+        { 0x61, 0x51, 0x49, 0x45, 0x43 }, { 0x00, 0x7F, 0x41, 0x41, 0x00 }, // Z [
+        { 0x02, 0x04, 0x08, 0x10, 0x20 }, { 0x00, 0x41, 0x41, 0x7F, 0x00 }, // \ ]
+        { 0x04, 0x02, 0x01, 0x02, 0x04 }, { 0x40, 0x40, 0x40, 0x40, 0x40 }, // ^ _
+        { 0x00, 0x01, 0x02, 0x04, 0x00 }, { 0x20, 0x54, 0x54, 0x54, 0x78 }, // ` a
+        { 0x7F, 0x48, 0x44, 0x44, 0x38 }, { 0x38, 0x44, 0x44, 0x44, 0x20 }, // b c
+        { 0x38, 0x44, 0x44, 0x48, 0x7F }, { 0x38, 0x54, 0x54, 0x54, 0x18 }, // d e
+        { 0x08, 0x7E, 0x09, 0x01, 0x02 }, { 0x0C, 0x52, 0x52, 0x52, 0x3E }, // f g
+        { 0x7F, 0x08, 0x04, 0x04, 0x78 }, { 0x00, 0x44, 0x7D, 0x40, 0x00 }, // h i
+        { 0x20, 0x40, 0x44, 0x3D, 0x00 }, { 0x7F, 0x10, 0x28, 0x44, 0x00 }, // j k
+        { 0x00, 0x41, 0x7F, 0x40, 0x00 }, { 0x7C, 0x04, 0x18, 0x04, 0x78 }, // l m
+        { 0x7C, 0x08, 0x04, 0x04, 0x78 }, { 0x38, 0x44, 0x44, 0x44, 0x38 }, // n o
+        { 0x7C, 0x14, 0x14, 0x14, 0x08 }, { 0x08, 0x14, 0x14, 0x18, 0x7C }, // p q
+        { 0x7C, 0x08, 0x04, 0x04, 0x08 }, { 0x48, 0x54, 0x54, 0x54, 0x20 }, // r s
+        { 0x04, 0x3F, 0x44, 0x40, 0x20 }, { 0x3C, 0x40, 0x40, 0x20, 0x7C }, // t u
+        { 0x1C, 0x20, 0x40, 0x20, 0x1C }, { 0x3C, 0x40, 0x30, 0x40, 0x3C }, // v w
+        { 0x44, 0x28, 0x10, 0x28, 0x44 }, { 0x0C, 0x50, 0x50, 0x50, 0x3C }, // x y
+        { 0x44, 0x64, 0x54, 0x4C, 0x44 }, { 0x00, 0x08, 0x36, 0x41, 0x00 }, // z {
+        { 0x00, 0x00, 0x7F, 0x00, 0x00 }, { 0x00, 0x41, 0x36, 0x08, 0x00 }, // | }
+        { 0x08, 0x04, 0x08, 0x10, 0x08 },                                   // ~
+    }; // FONT_5X7
+
+    LA_NO_DISCARD static inline const unsigned char*
+    glyph(unsigned char c) noexcept {
+        if (c < 0x20 || c > 0x7E) c = '?';
+        return FONT_5X7[c - 0x20];
+    } // glyph
+
+    // UTF-8 continuation bytes belong to the previous glyph
+    LA_NO_DISCARD static inline bool
+    is_continuation(unsigned char c) noexcept { return (c & 0xC0) == 0x80; }
+
+    // Freestanding-friendly rounding helpers (no libm)
+    LA_NO_DISCARD static inline int
+    floor_to_int(float v) noexcept {
+        const int i = static_cast<int>(v);
+        return (v < static_cast<float>(i)) ? i - 1 : i;
+    } // floor_to_int
+
+    LA_NO_DISCARD static inline int
+    ceil_to_int(float v) noexcept {
+        const int i = static_cast<int>(v);
+        return (v > static_cast<float>(i)) ? i + 1 : i;
+    } // ceil_to_int
+
+    static inline void
+    fill_span(const Canvas& c, int y, int x0, int x1, uint32_t color) noexcept {
+        if (x0 < c.clip.left)  x0 = c.clip.left;
+        if (x1 > c.clip.right) x1 = c.clip.right;
+        if (x0 >= x1) return;
+        ::la::fill_int32(reinterpret_cast<int32_t*>(c.row(y) + x0),
+                         static_cast<int32_t>(color),
+                         static_cast<size_t>(x1 - x0));
+    } // fill_span
+} // namespace detail
+
+// ------------------------------ Drawing -------------------------------------
+
+void Canvas::
+clear(uint32_t color) noexcept { fill_rect(clip, color); }
+
+void Canvas::
+fill_rect(const Rect& r, uint32_t color) noexcept {
+    const Rect area = r.intersect(clip);
+    if (area.is_empty() || !pixels) return;
+
+    // Whole rows: one contiguous SIMD fill
+    if (area.left == 0 && area.right == width && width == stride) {
+        ::la::fill_int32(reinterpret_cast<int32_t*>(row(area.top)),
+                         static_cast<int32_t>(color),
+                         static_cast<size_t>(area.area()));
+        return;
+    }
+
+    for (int y = area.top; y < area.bottom; ++y)
+        detail::fill_span(*this, y, area.left, area.right, color);
+} // fill_rect
+
+void Canvas::
+blit(const Image& image, int x, int y) noexcept {
+    if (!pixels || !image.pixels) return;
+
+    const Rect area = Rect::from_size(x, y, image.width, image.height).intersect(clip);
+    if (area.is_empty()) return;
+
+    const int w = area.width();
+    const uint32_t* src = image.pixels
+                        + static_cast<size_t>(image.stride) * (area.top - y)
+                        + (area.left - x);
+    for (int py = area.top; py < area.bottom; ++py) {
+        uint32_t* LA_RESTRICT dst = row(py) + area.left;
+        const uint32_t* LA_RESTRICT s = src;
+        for (int i = 0; i < w; ++i) dst[i] = s[i]; // Lowered to `memcpy`
+        src += image.stride;
+    }
+} // blit
+
+void Canvas::
+draw_text(int x, int y, const char* text, size_t length,
+          uint32_t color, int scale) noexcept {
+    if (!pixels || !text || scale <= 0) return;
+
+    int pen_x = x;
+    int pen_y = y;
+    for (size_t i = 0; i < length; ++i) {
+        const unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c == '\n') {
+            pen_x = x;
+            pen_y += GLYPH_LINE * scale;
+            continue;
+        }
+        if (detail::is_continuation(c))
+            continue;
+
+        // Skip glyphs outside of the clip quickly
+        const Rect cell = Rect::from_size(pen_x, pen_y, 5 * scale, 7 * scale);
+        if (cell.intersects(clip)) {
+            const unsigned char* columns = detail::glyph(c);
+            for (int row_ = 0; row_ < 7; ++row_) {
+                for (int col = 0; col < 5; ++col) {
+                    if (!(columns[col] & (1u << row_)))
+                        continue;
+                    fill_rect(Rect::from_size(pen_x + col * scale, pen_y + row_ * scale,
+                                              scale, scale), color);
+                }
+            }
+        }
+        pen_x += GLYPH_ADVANCE * scale;
+    }
+} // draw_text
+
+void Canvas::
+fill_path(const Point* points, size_t count, uint32_t color) noexcept {
+    if (!pixels || !points || count < 3) return;
+
+    const Rect area = path_bounds(points, count).intersect(clip);
+    if (area.is_empty()) return;
+
+    float xs[MAX_PATH_CROSSINGS];
+    int   winds[MAX_PATH_CROSSINGS];
+
+    for (int y = area.top; y < area.bottom; ++y) {
+        const float sy = static_cast<float>(y) + 0.5f;
+
+        // Collect edge crossings of this scanline
+        int n = 0;
+        for (size_t i = 0; i < count && n < MAX_PATH_CROSSINGS; ++i) {
+            const Point& a = points[i];
+            const Point& b = points[(i + 1) == count ? 0 : i + 1];
+
+            int wind;
+            if (a.y <= sy && b.y > sy)      wind = 1;
+            else if (b.y <= sy && a.y > sy) wind = -1;
+            else continue;
+
+            const float t = (sy - a.y) / (b.y - a.y);
+            const float cx = a.x + t * (b.x - a.x);
+
+            // Insertion sort: crossings per scanline are few
+            int k = n++;
+            while (k > 0 && xs[k - 1] > cx) {
+                xs[k] = xs[k - 1];
+                winds[k] = winds[k - 1];
+                --k;
+            }
+            xs[k] = cx;
+            winds[k] = wind;
+        }
+
+        // Fill spans with non-zero winding, pixel centers inside
+        int acc = 0;
+        float span_start = 0.f;
+        for (int i = 0; i < n; ++i) {
+            const int prev = acc;
+            acc += winds[i];
+            if (prev == 0 && acc != 0) {
+                span_start = xs[i];
+            }
+            else if (prev != 0 && acc == 0) {
+                detail::fill_span(*this, y,
+                                  detail::ceil_to_int(span_start - 0.5f),
+                                  detail::ceil_to_int(xs[i] - 0.5f), color);
+            }
+        }
+    }
+} // fill_path
+
+// ------------------------------ Measuring -----------------------------------
+
+Rect Canvas::
+text_bounds(int x, int y, const char* text, size_t length, int scale) noexcept {
+    int columns = 0, max_columns = 0, lines = 1;
+    for (size_t i = 0; i < length; ++i) {
+        const unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c == '\n') {
+            ++lines;
+            columns = 0;
+            continue;
+        }
+        if (detail::is_continuation(c))
+            continue;
+        if (++columns > max_columns)
+            max_columns = columns;
+    }
+    if (max_columns == 0) return Rect{};
+    return Rect::from_size(x, y,
+        (max_columns * GLYPH_ADVANCE - 1) * scale,
+        ((lines - 1) * GLYPH_LINE + 7) * scale);
+} // text_bounds
+
+Rect Canvas::
+path_bounds(const Point* points, size_t count) noexcept {
+    if (!points || count == 0) return Rect{};
+
+    float x0 = points[0].x, y0 = points[0].y, x1 = x0, y1 = y0;
+    for (size_t i = 1; i < count; ++i) {
+        if (points[i].x < x0) x0 = points[i].x;
+        if (points[i].y < y0) y0 = points[i].y;
+        if (points[i].x > x1) x1 = points[i].x;
+        if (points[i].y > y1) y1 = points[i].y;
+    }
+    return Rect{ detail::floor_to_int(x0), detail::floor_to_int(y0),
+                 detail::ceil_to_int(x1),  detail::ceil_to_int(y1) };
+} // path_bounds
+
+} // namespace la
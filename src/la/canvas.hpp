@@ -0,0 +1,134 @@
+#ifndef __LA_CANVAS_HEADER_GUARD
+#define __LA_CANVAS_HEADER_GUARD
+
+#include "la.hpp"
+
+/*
+    Software rasterizer: a non-owning view over 32-bit ARGB pixels
+    (`native::Framebuffer`, offscreen surfaces, user images).
+    All drawing is opaque and limited to `Canvas::clip`.
+*/
+
+namespace la {
+
+// --------------------------- Rect -------------------------------------------
+
+// Half-open integer rectangle: [left, right) x [top, bottom)
+struct Rect {
+    int left{ 0 };
+    int top{ 0 };
+    int right{ 0 };
+    int bottom{ 0 };
+
+    LA_NO_DISCARD static LA_CONSTEXPR Rect
+from_size(int x, int y, int w, int h) noexcept { return Rect{ x, y, x + w, y + h }; }
+
+    // Covers any canvas, used by commands without geometry (e.g. clear)
+    LA_NO_DISCARD static LA_CONSTEXPR Rect
+infinite() noexcept { return Rect{ -(1 << 30), -(1 << 30), 1 << 30, 1 << 30 }; }
+
+    LA_NO_DISCARD int width() const noexcept { return right - left; }
+    LA_NO_DISCARD int height() const noexcept { return bottom - top; }
+    LA_NO_DISCARD bool is_empty() const noexcept { return left >= right || top >= bottom; }
+    LA_NO_DISCARD int64_t area() const noexcept {
+        return is_empty() ? 0 : static_cast<int64_t>(width()) * height();
+    }
+
+    LA_NO_DISCARD bool intersects(const Rect& r) const noexcept {
+        return left < r.right && r.left < right && top < r.bottom && r.top < bottom;
+    }
+    LA_NO_DISCARD bool contains(const Rect& r) const noexcept {
+        return left <= r.left && top <= r.top && right >= r.right && bottom >= r.bottom;
+    }
+
+    LA_NO_DISCARD Rect intersect(const Rect& r) const noexcept {
+        return Rect{ left   > r.left   ? left   : r.left,
+                     top    > r.top    ? top    : r.top,
+                     right  < r.right  ? right  : r.right,
+                     bottom < r.bottom ? bottom : r.bottom };
+    }
+    LA_NO_DISCARD Rect unite(const Rect& r) const noexcept {
+        if (is_empty())   return r;
+        if (r.is_empty()) return *this;
+        return Rect{ left   < r.left   ? left   : r.left,
+                     top    < r.top    ? top    : r.top,
+                     right  > r.right  ? right  : r.right,
+                     bottom > r.bottom ? bottom : r.bottom };
+    }
+    LA_NO_DISCARD Rect translate(int dx, int dy) const noexcept {
+        return Rect{ left + dx, top + dy, right + dx, bottom + dy };
+    }
+
+    LA_NO_DISCARD bool operator==(const Rect& r) const noexcept {
+        return left == r.left && top == r.top && right == r.right && bottom == r.bottom;
+    }
+    LA_NO_DISCARD bool operator!=(const Rect& r) const noexcept { return !(*this == r); }
+}; // struct Rect
+
+// --------------------------- Point ------------------------------------------
+
+struct Point {
+    float x{ 0.f };
+    float y{ 0.f };
+}; // struct Point
+
+// --------------------------- Image ------------------------------------------
+
+// Read-only 32-bit ARGB pixels owned by the caller
+struct Image {
+    const uint32_t* pixels{ nullptr };
+    int width{ 0 };
+    int height{ 0 };
+    int stride{ 0 }; // Pixels per row
+}; // struct Image
+
+// --------------------------- Canvas -----------------------------------------
+
+struct Canvas {
+    // Built-in 5x7 font in a 6x8 cell (ASCII, other bytes draw as '?')
+    LA_CONSTEXPR_VAR static int GLYPH_ADVANCE = 6;
+    LA_CONSTEXPR_VAR static int GLYPH_LINE = 8;
+    // Crossings per scanline `fill_path` can track, extra edges are ignored
+    LA_CONSTEXPR_VAR static int MAX_PATH_CROSSINGS = 128;
+
+    uint32_t* pixels{ nullptr };
+    int width{ 0 };
+    int height{ 0 };
+    int stride{ 0 }; // Pixels per row
+    Rect clip{};     // Always inside `bounds()`
+
+    explicit inline Canvas() noexcept = default;
+    inline Canvas(uint32_t* pixels_, int width_, int height_, int stride_) noexcept
+        : pixels{ pixels_ }, width{ width_ }, height{ height_ }, stride{ stride_ },
+          clip{ 0, 0, width_, height_ } {}
+    explicit inline Canvas(const native::Framebuffer& fb) noexcept
+        : Canvas{ static_cast<uint32_t*>(fb.pixels), fb.width, fb.height, fb.stride } {}
+
+    LA_NO_DISCARD Rect bounds() const noexcept { return Rect{ 0, 0, width, height }; }
+    LA_NO_DISCARD uint32_t* row(int y) const noexcept {
+        return pixels + static_cast<size_t>(stride) * y;
+    }
+
+    void set_clip(const Rect& r) noexcept { clip = r.intersect(bounds()); }
+    void reset_clip() noexcept { clip = bounds(); }
+
+    // ---------------------------- Drawing -----------------------------------
+
+    void clear(uint32_t color) noexcept;
+    void fill_rect(const Rect& r, uint32_t color) noexcept;
+    void blit(const Image& image, int x, int y) noexcept;
+    void draw_text(int x, int y, const char* text, size_t length,
+                   uint32_t color, int scale = 1) noexcept;
+    // Non-zero winding, closed polygon, pixel centers sampled
+    void fill_path(const Point* points, size_t count, uint32_t color) noexcept;
+
+    // ---------------------------- Measuring ---------------------------------
+
+    LA_NO_DISCARD static Rect text_bounds(int x, int y, const char* text,
+                                          size_t length, int scale = 1) noexcept;
+    LA_NO_DISCARD static Rect path_bounds(const Point* points, size_t count) noexcept;
+}; // struct Canvas
+
+} // namespace la
+
+#endif // __LA_CANVAS_HEADER_GUARD
@@ -0,0 +1,131 @@
+#include "la.hpp"
+
+// Time-stamp counter calibration behind `la::tsc_now_ns()` and the platform-independent
+// part of the precise sleeps
+
+#if defined(LA_HAS_TSC) && !defined(_MSC_VER)
+#   include <cpuid.h> // __get_cpuid (compiler-provided)
+#endif
+
+namespace la {
+
+namespace detail {
+    TscClock g_tsc; // Zero-initialized, TSC_UNKNOWN
+
+#if defined(LA_HAS_TSC)
+    // Constant rate in all P/C-states, and synchronized across cores
+    LA_NO_DISCARD static bool
+    has_invariant_tsc() noexcept {
+        unsigned info[4] = {};
+#if defined(_MSC_VER)
+        __cpuid(reinterpret_cast<int*>(info), 0x80000000);
+        if (info[0] < 0x80000007) return false;
+        __cpuid(reinterpret_cast<int*>(info), 0x80000007);
+#else
+        if (!__get_cpuid(0x80000007, &info[0], &info[1], &info[2], &info[3])) return false;
+#endif
+        return (info[3] & (1u << 8)) != 0; // EDX bit 8
+    } // has_invariant_tsc
+
+    struct ClockPair {
+        uint64_t ticks;
+        uint64_t ns;
+    }; // struct ClockPair
+
+    // The tightest of a few bracketed reads, an interrupt can land in any one of them
+    LA_NO_DISCARD static ClockPair
+    read_clock_pair() noexcept {
+        ClockPair best{ 0, 0 };
+        uint64_t best_width = ~0ull;
+        for (int i = 0; i < 8; ++i) {
+            const uint64_t before = __rdtsc();
+            const uint64_t ns = ::la::get_monotonic_ns();
+            const uint64_t after = __rdtsc();
+            if (after - before < best_width) {
+                best_width = after - before;
+                best = ClockPair{ before + (after - before) / 2, ns };
+            }
+        }
+        return best;
+    } // read_clock_pair
+#endif // LA_HAS_TSC
+} // namespace detail
+
+bool
+tsc_calibrate() noexcept {
+    using namespace detail;
+
+    // First caller calibrates, concurrent ones keep the fallback clock meanwhile
+    uint32_t state = TSC_UNKNOWN;
+    if (!g_tsc.state.compare_exchange(state, TSC_CALIBRATING))
+        return state == TSC_READY;
+
+#if defined(LA_HAS_TSC)
+    if (has_invariant_tsc()) {
+        // 10 ms keeps the rate error around a few ppm with a 100 ns clock read
+        LA_CONSTEXPR_VAR uint64_t CALIBRATION_NS = 10000000;
+        const ClockPair begin = read_clock_pair();
+        while (::la::get_monotonic_ns() - begin.ns < CALIBRATION_NS)
+            ::la::cpu_relax();
+        const ClockPair end = read_clock_pair();
+
+        if (end.ticks > begin.ticks && end.ns > begin.ns) {
+            g_tsc.base_ticks = end.ticks;
+            g_tsc.base_ns = end.ns;
+            g_tsc.ns_per_tick = static_cast<double>(end.ns - begin.ns) /
+                                static_cast<double>(end.ticks - begin.ticks);
+            g_tsc.state.store(TSC_READY);
+            return true;
+        }
+    }
+#endif
+    g_tsc.state.store(TSC_UNAVAILABLE);
+    return false;
+} // tsc_calibrate
+
+// ------------------------------ Sleep ---------------------------------------
+
+void
+sleep_until(uint64_t deadline_ns, uint64_t spin_ns) noexcept {
+    const uint64_t wake_ns = deadline_ns > spin_ns ? deadline_ns - spin_ns : 0;
+    if (::la::get_monotonic_ns() < wake_ns)
+        native::sleep_until(wake_ns);
+    while (::la::get_monotonic_ns() < deadline_ns)
+        ::la::cpu_relax();
+} // sleep_until
+
+void
+sleep_for(uint64_t ns, uint64_t spin_ns) noexcept {
+    ::la::sleep_until(::la::get_monotonic_ns() + ns, spin_ns);
+} // sleep_for
+
+SleepError
+measure_sleep_error(uint64_t interval_ns, unsigned samples) noexcept {
+    LA_CONSTEXPR_VAR unsigned MAX_SAMPLES = 256;
+    if (samples > MAX_SAMPLES) samples = MAX_SAMPLES;
+
+    uint64_t errors[MAX_SAMPLES];
+    for (unsigned i = 0; i < samples; ++i) {
+        const uint64_t deadline = ::la::get_monotonic_ns() + interval_ns;
+        native::sleep_until(deadline);
+        const uint64_t now = ::la::get_monotonic_ns();
+        errors[i] = now > deadline ? now - deadline : 0;
+
+        // Insertion sort as we go, `samples` is small
+        for (unsigned j = i; j > 0 && errors[j - 1] > errors[j]; --j) {
+            const uint64_t t = errors[j - 1];
+            errors[j - 1] = errors[j];
+            errors[j] = t;
+        }
+    }
+
+    SleepError result;
+    if (samples == 0)
+        return result;
+    result.p50_ns = errors[(samples - 1) * 50 / 100];
+    result.p99_ns = errors[(samples - 1) * 99 / 100];
+    result.max_ns = errors[samples - 1];
+    return result;
+} // measure_sleep_error
+
+} // namespace la
@@ -0,0 +1,153 @@
+#include "containers.hpp"
+
+namespace la {
+
+// ------------------------------ Allocators ----------------------------------
+
+namespace detail {
+    static void*
+    pool_allocator_alloc(void*, size_t size) noexcept { return pool_alloc(size); }
+
+    static void
+    pool_allocator_free(void*, void* ptr, size_t size) noexcept { pool_free(ptr, size); }
+
+    static void*
+    arena_allocator_alloc(void* arena, size_t size) noexcept {
+        return static_cast<Arena*>(arena)->alloc(size, Arena::DEFAULT_ALIGN);
+    } // arena_allocator_alloc
+
+    static void
+    arena_allocator_free(void*, void*, size_t) noexcept {}
+
+    static const Allocator::Ops POOL_ALLOCATOR{ &pool_allocator_alloc, &pool_allocator_free };
+    static const Allocator::Ops ARENA_ALLOCATOR{ &arena_allocator_alloc, &arena_allocator_free };
+} // namespace detail
+
+Allocator Allocator::
+pool() noexcept { return Allocator{ &detail::POOL_ALLOCATOR, nullptr }; }
+
+Allocator Allocator::
+arena(Arena& arena) noexcept { return Allocator{ &detail::ARENA_ALLOCATOR, &arena }; }
+
+// ------------------------------ Strings -------------------------------------
+
+int StringView::
+compare(StringView other) const noexcept {
+    const size_t common = m_size < other.m_size ? m_size : other.m_size;
+    for (size_t i = 0; i < common; ++i) {
+        const unsigned char a = static_cast<unsigned char>(m_data[i]);
+        const unsigned char b = static_cast<unsigned char>(other.m_data[i]);
+        if (a != b) return a < b ? -1 : 1;
+    }
+    return m_size == other.m_size ? 0 : (m_size < other.m_size ? -1 : 1);
+} // compare
+
+size_t StringView::
+find(StringView what, size_t from) const noexcept {
+    if (!what.m_size) return from <= m_size ? from : NPOS;
+    // First char as a cheap filter
+    for (size_t at = find(what.m_data[0], from); at != NPOS && at + what.m_size <= m_size;
+         at = find(what.m_data[0], at + 1))
+        if (substr(at, what.m_size).compare(what) == 0) return at;
+    return NPOS;
+} // find
+
+bool String::
+reserve(size_t capacity) noexcept {
+    return capacity <= m_capacity || grow(capacity, StringView{});
+} // reserve
+
+bool String::
+append(StringView text) noexcept {
+    if (text.size() > MAX_CAPACITY - m_size) return false;
+    const size_t size = m_size + text.size();
+    // `text` may be part of this string: a new buffer gets both before the old one goes
+    if (size > m_capacity) return grow(size, text);
+    for (size_t i = 0; i < text.size(); ++i) m_data[m_size + i] = text[i];
+    m_size = static_cast<uint32_t>(size);
+    m_data[m_size] = '\0';
+    return true;
+} // append
+
+bool String::
+grow(size_t capacity, StringView tail) noexcept {
+    if (capacity > MAX_CAPACITY) return false;
+
+    // Geometrically, repeated appends stay linear
+    size_t grown = m_capacity * 2 + 1;
+    if (grown < capacity) grown = capacity;
+    if (grown > MAX_CAPACITY) grown = MAX_CAPACITY;
+    char* data = static_cast<char*>(m_allocator.alloc(grown + 1));
+    if (!data) return false;
+    for (size_t i = 0; i < m_size; ++i) data[i] = m_data[i];
+    for (size_t i = 0; i < tail.size(); ++i) data[m_size + i] = tail[i];
+    release();
+    m_data = data;
+    m_size += static_cast<uint32_t>(tail.size());
+    m_data[m_size] = '\0';
+    m_capacity = static_cast<uint32_t>(grown);
+    return true;
+} // grow
+
+void String::
+take(String& other) noexcept {
+    if (other.m_data == other.m_inline) {
+        for (size_t i = 0; i <= other.m_size; ++i) m_inline[i] = other.m_inline[i];
+        m_data = m_inline;
+        m_capacity = INLINE_CAPACITY;
+    } else {
+        m_data = other.m_data;
+        m_capacity = other.m_capacity;
+        other.m_data = other.m_inline;
+        other.m_capacity = INLINE_CAPACITY;
+    }
+    m_size = other.m_size;
+    other.m_size = 0;
+    other.m_inline[0] = '\0';
+} // take
+
+// ------------------------------ Hashing -------------------------------------
+
+namespace detail {
+    // Unaligned little-endian read. Spelled out, compilers merge it into one load
+    LA_NO_DISCARD static inline uint64_t
+    read_u64(const unsigned char* p) noexcept {
+        return static_cast<uint64_t>(p[0])       | static_cast<uint64_t>(p[1]) << 8  |
+               static_cast<uint64_t>(p[2]) << 16 | static_cast<uint64_t>(p[3]) << 24 |
+               static_cast<uint64_t>(p[4]) << 32 | static_cast<uint64_t>(p[5]) << 40 |
+               static_cast<uint64_t>(p[6]) << 48 | static_cast<uint64_t>(p[7]) << 56;
+    } // read_u64
+
+    LA_NO_DISCARD static inline uint64_t
+    read_tail(const unsigned char* p, size_t size) noexcept {
+        uint64_t value = 0;
+        for (size_t i = 0; i < size; ++i) value |= static_cast<uint64_t>(p[i]) << (i * 8);
+        return value;
+    } // read_tail
+} // namespace detail
+
+uint64_t
+hash_bytes(const void* data, size_t size) noexcept {
+    // Eight bytes per multiply, two lanes so the multiplies overlap
+    LA_CONSTEXPR_VAR uint64_t K0 = 0x9E3779B97F4A7C15ull;
+    LA_CONSTEXPR_VAR uint64_t K1 = 0xC2B2AE3D27D4EB4Full;
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    uint64_t a = K0 ^ size;
+    uint64_t b = K1;
+
+    for (; size >= 16; p += 16, size -= 16) {
+        a = (a ^ detail::read_u64(p)) * K1;
+        b = (b ^ detail::read_u64(p + 8)) * K0;
+        a ^= a >> 29;
+        b ^= b >> 31;
+    }
+    if (size >= 8) {
+        a = (a ^ detail::read_u64(p)) * K1;
+        p += 8;
+        size -= 8;
+    }
+    b = (b ^ detail::read_tail(p, size)) * K0;
+    return hash_u64(a ^ (b >> 1) ^ (b << 63));
+} // hash_bytes
+
+} // namespace la
@@ -0,0 +1,788 @@
+#ifndef __LA_CONTAINERS_HEADER_GUARD
+#define __LA_CONTAINERS_HEADER_GUARD
+
+#include "arena.hpp"
+#include "pool.hpp"
+
+/*
+    Containers that need no STL, for `LA_NOSTD` builds and hot paths alike.
+    Memory comes through `la::Allocator`: the pool size classes by default,
+    or an arena for data that dies with the frame.
+
+        la::SmallVector<Rect, 8> dirty;                // First 8 inline
+        la::HashMap<uint32_t, Glyph> glyphs;           // Swiss table
+        la::HashMap<la::String, int> ids{ la::Allocator::arena(frame) };
+        if (int* id = ids.find(la::StringView{ "button" })) ...
+
+    Nothing throws: growing returns null or false when out of memory and
+    leaves the container as it was. Elements move when the storage grows,
+    pointers into a container last until the next insertion.
+    Element alignment is at most 16 bytes.
+*/
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h> // Compiler-provided
+#   define LA_HASH_GROUP_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64) // `vaddv_u8` is A64 only, 32-bit ARM uses the words
+#   include <arm_neon.h>
+#   define LA_HASH_GROUP_NEON
+#endif
+
+namespace la { namespace detail { struct PlaceTag {}; } }
+
+// Placement new without <new>, the tag keeps it apart from the standard one
+inline void* operator new(size_t, void* ptr, ::la::detail::PlaceTag) noexcept { return ptr; }
+inline void operator delete(void*, void*, ::la::detail::PlaceTag) noexcept {}
+
+namespace la {
+
+// --------------------------- Utilities --------------------------------------
+
+namespace detail {
+    template <typename T> struct RemoveReference { using Type = T; };
+    template <typename T> struct RemoveReference<T&> { using Type = T; };
+    template <typename T> struct RemoveReference<T&&> { using Type = T; };
+} // namespace detail
+
+// `std::move`/`std::forward`. Call them qualified, ADL may find the std ones
+template <typename T>
+LA_NO_DISCARD constexpr typename detail::RemoveReference<T>::Type&&
+move(T&& value) noexcept { return static_cast<typename detail::RemoveReference<T>::Type&&>(value); }
+
+template <typename T>
+LA_NO_DISCARD constexpr T&&
+forward(typename detail::RemoveReference<T>::Type& value) noexcept { return static_cast<T&&>(value); }
+
+// --------------------------- Allocator --------------------------------------
+
+/// Where a container's memory comes from. Blocks are 16-byte aligned and
+/// freed with the size they were allocated with
+struct Allocator {
+    struct Ops {
+        void* (*alloc)(void* context, size_t size) noexcept;
+        void (*free)(void* context, void* ptr, size_t size) noexcept;
+    }; // struct Ops
+
+    const Ops* ops;
+    void* context;
+
+    LA_NO_DISCARD void* alloc(size_t size) const noexcept { return ops->alloc(context, size); }
+    void free(void* ptr, size_t size) const noexcept { if (ptr) ops->free(context, ptr, size); }
+
+    // `pool_alloc()`: size classes up to `POOL_MAX_SIZE`, `la::alloc` above
+    LA_NO_DISCARD static Allocator pool() noexcept;
+    // Frees are no-ops, the memory goes with the arena's `reset()`. Growing
+    // containers leave their old storage behind, reserve up front
+    LA_NO_DISCARD static Allocator arena(Arena& arena) noexcept;
+}; // struct Allocator
+
+// --------------------------- Small Vector -----------------------------------
+
+namespace detail {
+    template <typename T, size_t N>
+    struct InlineBuffer {
+        LA_NO_DISCARD T* data() const noexcept { return reinterpret_cast<T*>(const_cast<unsigned char*>(bytes)); }
+        alignas(T) unsigned char bytes[N * sizeof(T)];
+    }; // struct InlineBuffer
+
+    template <typename T>
+    struct InlineBuffer<T, 0> {
+        LA_NO_DISCARD T* data() const noexcept { return nullptr; }
+    }; // struct InlineBuffer
+} // namespace detail
+
+/// Growable array keeping the first `N` elements inside the object itself
+template <typename T, size_t N = 0>
+struct SmallVector {
+    static_assert(alignof(T) <= 16, "SmallVector<T> aligns elements to 16 bytes at most");
+
+    // Elements whose bytes still fit a `size_t`
+    LA_CONSTEXPR_VAR static size_t MAX_CAPACITY = ~static_cast<size_t>(0) / sizeof(T);
+
+    explicit inline SmallVector(Allocator allocator = Allocator::pool()) noexcept
+        : m_capacity{ N }, m_allocator{ allocator } { m_data = m_inline.data(); }
+    inline ~SmallVector() noexcept { clear(); release(); }
+
+    SmallVector(const SmallVector&) = delete;
+    SmallVector& operator=(const SmallVector&) = delete;
+    SmallVector(SmallVector&& other) noexcept : SmallVector{ other.m_allocator } { take(other); }
+    SmallVector& operator=(SmallVector&& other) noexcept {
+        if (this != &other) {
+            clear();
+            release();
+            m_data = m_inline.data();
+            m_capacity = N;
+            m_allocator = other.m_allocator;
+            take(other);
+        }
+        return *this;
+    }
+
+    // ---------------------------- Modifiers ---------------------------------
+
+    // The new element, null when out of memory
+    template <typename... Args>
+    inline T* emplace_back(Args&&... args) noexcept {
+        if (m_size == m_capacity)
+            return grow_and_emplace(::la::forward<Args>(args)...);
+        T* slot = new (m_data + m_size, detail::PlaceTag{}) T(::la::forward<Args>(args)...);
+        ++m_size;
+        return slot;
+    }
+    inline T* push_back(const T& value) noexcept { return emplace_back(value); }
+    inline T* push_back(T&& value) noexcept { return emplace_back(::la::move(value)); }
+    void pop_back() noexcept { m_data[--m_size].~T(); }
+
+    // Shifts the tail down, keeps the order
+    void erase(size_t index) noexcept {
+        for (size_t i = index + 1; i < m_size; ++i) m_data[i - 1] = ::la::move(m_data[i]);
+        pop_back();
+    }
+    // The last element takes the hole, O(1)
+    void swap_erase(size_t index) noexcept {
+        if (index + 1 != m_size) m_data[index] = ::la::move(m_data[m_size - 1]);
+        pop_back();
+    }
+    void clear() noexcept {
+        for (size_t i = 0; i < m_size; ++i) m_data[i].~T();
+        m_size = 0;
+    }
+
+    // False, and the vector unchanged, when out of memory or past `MAX_CAPACITY`
+    bool reserve(size_t capacity) noexcept;
+    // New elements are value-initialized
+    bool resize(size_t size) noexcept;
+
+    // ---------------------------- Access ------------------------------------
+
+    LA_NO_DISCARD T& operator[](size_t index) noexcept { return m_data[index]; }
+    LA_NO_DISCARD const T& operator[](size_t index) const noexcept { return m_data[index]; }
+    LA_NO_DISCARD T& back() noexcept { return m_data[m_size - 1]; }
+    LA_NO_DISCARD T* data() noexcept { return m_data; }
+    LA_NO_DISCARD const T* data() const noexcept { return m_data; }
+    LA_NO_DISCARD T* begin() noexcept { return m_data; }
+    LA_NO_DISCARD T* end() noexcept { return m_data + m_size; }
+    LA_NO_DISCARD const T* begin() const noexcept { return m_data; }
+    LA_NO_DISCARD const T* end() const noexcept { return m_data + m_size; }
+
+    LA_NO_DISCARD size_t size() const noexcept { return m_size; }
+    LA_NO_DISCARD size_t capacity() const noexcept { return m_capacity; }
+    LA_NO_DISCARD bool empty() const noexcept { return m_size == 0; }
+    LA_NO_DISCARD bool is_inline() const noexcept { return m_data == m_inline.data(); }
+    LA_NO_DISCARD const Allocator& allocator() const noexcept { return m_allocator; }
+
+private:
+    template <typename... Args>
+    T* grow_and_emplace(Args&&... args) noexcept;
+    // Move `m_size` elements to `storage`, free the old one
+    void relocate(T* storage, size_t capacity) noexcept;
+    void release() noexcept {
+        if (!is_inline()) m_allocator.free(m_data, m_capacity * sizeof(T));
+    }
+    void take(SmallVector& other) noexcept;
+
+    T* m_data;
+    size_t m_size{ 0 };
+    size_t m_capacity;
+    Allocator m_allocator;
+    detail::InlineBuffer<T, N> m_inline;
+}; // struct SmallVector
+
+// Heap-only vector
+template <typename T>
+using Vector = SmallVector<T, 0>;
+
+template <typename T, size_t N>
+void SmallVector<T, N>::
+relocate(T* storage, size_t capacity) noexcept {
+    for (size_t i = 0; i < m_size; ++i) {
+        new (storage + i, detail::PlaceTag{}) T(::la::move(m_data[i]));
+        m_data[i].~T();
+    }
+    release();
+    m_data = storage;
+    m_capacity = capacity;
+} // relocate
+
+template <typename T, size_t N>
+bool SmallVector<T, N>::
+reserve(size_t capacity) noexcept {
+    if (capacity <= m_capacity) return true;
+    if (capacity > MAX_CAPACITY) return false;
+    T* storage = static_cast<T*>(m_allocator.alloc(capacity * sizeof(T)));
+    if (!storage) return false;
+    relocate(storage, capacity);
+    return true;
+} // reserve
+
+template <typename T, size_t N>
+bool SmallVector<T, N>::
+resize(size_t size) noexcept {
+    if (!reserve(size)) return false;
+    while (m_size > size) pop_back();
+    for (; m_size < size; ++m_size) new (m_data + m_size, detail::PlaceTag{}) T();
+    return true;
+} // resize
+
+template <typename T, size_t N>
+template <typename... Args>
+T* SmallVector<T, N>::
+grow_and_emplace(Args&&... args) noexcept {
+    if (m_capacity > MAX_CAPACITY / 2) return nullptr;
+    const size_t capacity = m_capacity ? m_capacity * 2 : 8;
+    T* storage = static_cast<T*>(m_allocator.alloc(capacity * sizeof(T)));
+    if (!storage) return nullptr;
+    // Before the move: `args` may refer to an element
+    T* slot = new (storage + m_size, detail::PlaceTag{}) T(::la::forward<Args>(args)...);
+    relocate(storage, capacity);
+    ++m_size;
+    return slot;
+} // grow_and_emplace
+
+template <typename T, size_t N>
+void SmallVector<T, N>::
+take(SmallVector& other) noexcept {
+    if (other.is_inline()) { // Element by element, within the inline capacity
+        for (size_t i = 0; i < other.m_size; ++i)
+            new (m_data + i, detail::PlaceTag{}) T(::la::move(other.m_data[i]));
+        m_size = other.m_size;
+        other.clear();
+        return;
+    }
+    m_data = other.m_data;
+    m_size = other.m_size;
+    m_capacity = other.m_capacity;
+    other.m_data = other.m_inline.data();
+    other.m_size = 0;
+    other.m_capacity = N;
+} // take
+
+// --------------------------- Strings ----------------------------------------
+
+/// Non-owning run of chars, not necessarily zero-terminated
+struct StringView {
+    LA_CONSTEXPR_VAR static size_t NPOS = ~static_cast<size_t>(0);
+
+    constexpr StringView() noexcept : m_data{ "" }, m_size{ 0 } {}
+    constexpr StringView(const char* data, size_t size) noexcept : m_data{ data }, m_size{ size } {}
+    // Zero-terminated
+    StringView(const char* str) noexcept : m_data{ str }, m_size{ 0 } { while (str[m_size]) ++m_size; }
+
+    LA_NO_DISCARD const char* data() const noexcept { return m_data; }
+    LA_NO_DISCARD size_t size() const noexcept { return m_size; }
+    LA_NO_DISCARD bool empty() const noexcept { return m_size == 0; }
+    LA_NO_DISCARD char operator[](size_t index) const noexcept { return m_data[index]; }
+    LA_NO_DISCARD const char* begin() const noexcept { return m_data; }
+    LA_NO_DISCARD const char* end() const noexcept { return m_data + m_size; }
+
+    // Clamped to the view
+    LA_NO_DISCARD StringView substr(size_t at, size_t count = NPOS) const noexcept {
+        if (at > m_size) at = m_size;
+        if (count > m_size - at) count = m_size - at;
+        return StringView{ m_data + at, count };
+    }
+    LA_NO_DISCARD size_t find(char c, size_t from = 0) const noexcept {
+        for (size_t i = from; i < m_size; ++i)
+            if (m_data[i] == c) return i;
+        return NPOS;
+    }
+    LA_NO_DISCARD size_t find(StringView what, size_t from = 0) const noexcept;
+    LA_NO_DISCARD bool starts_with(StringView prefix) const noexcept {
+        return prefix.m_size <= m_size && substr(0, prefix.m_size).compare(prefix) == 0;
+    }
+    LA_NO_DISCARD bool ends_with(StringView suffix) const noexcept {
+        return suffix.m_size <= m_size && substr(m_size - suffix.m_size).compare(suffix) == 0;
+    }
+    // Byte order: negative, 0 or positive
+    LA_NO_DISCARD int compare(StringView other) const noexcept;
+
+private:
+    const char* m_data;
+    size_t m_size;
+}; // struct StringView
+
+LA_NO_DISCARD inline bool operator==(StringView a, StringView b) noexcept {
+    return a.size() == b.size() && a.compare(b) == 0;
+}
+LA_NO_DISCARD inline bool operator!=(StringView a, StringView b) noexcept { return !(a == b); }
+LA_NO_DISCARD inline bool operator<(StringView a, StringView b) noexcept { return a.compare(b) < 0; }
+
+inline Out& operator<<(Out& out, StringView text) noexcept {
+    for (char c : text) out << c;
+    return out;
+}
+
+/// Owning, zero-terminated string. Up to `INLINE_CAPACITY` chars live in the
+/// object, longer ones in allocator memory
+struct String {
+    LA_CONSTEXPR_VAR static size_t INLINE_CAPACITY = 23;
+    LA_CONSTEXPR_VAR static size_t MAX_CAPACITY = 0xFFFFFFFEu;
+
+    explicit inline String(Allocator allocator = Allocator::pool()) noexcept
+        : m_data{ m_inline }, m_allocator{ allocator } { m_inline[0] = '\0'; }
+    // Empty when out of memory
+    explicit inline String(StringView text, Allocator allocator = Allocator::pool()) noexcept
+        : String{ allocator } { (void)append(text); }
+    inline ~String() noexcept { release(); }
+
+    String(const String&) = delete;
+    String& operator=(const String&) = delete;
+    String(String&& other) noexcept : String{ other.m_allocator } { take(other); }
+    String& operator=(String&& other) noexcept {
+        if (this != &other) {
+            release();
+            m_allocator = other.m_allocator;
+            take(other);
+        }
+        return *this;
+    }
+
+    // False, and the string unchanged, when out of memory
+    bool reserve(size_t capacity) noexcept;
+    bool append(StringView text) noexcept;
+    bool append(char c) noexcept { return append(StringView{ &c, 1 }); }
+    bool assign(StringView text) noexcept { clear(); return append(text); }
+    void clear() noexcept { m_size = 0; m_data[0] = '\0'; }
+
+    LA_NO_DISCARD const char* c_str() const noexcept { return m_data; }
+    LA_NO_DISCARD char* data() noexcept { return m_data; }
+    LA_NO_DISCARD size_t size() const noexcept { return m_size; }
+    LA_NO_DISCARD size_t capacity() const noexcept { return m_capacity; }
+    LA_NO_DISCARD bool empty() const noexcept { return m_size == 0; }
+    LA_NO_DISCARD char& operator[](size_t index) noexcept { return m_data[index]; }
+    LA_NO_DISCARD StringView view() const noexcept { return StringView{ m_data, m_size }; }
+    operator StringView() const noexcept { return view(); }
+
+private:
+    void release() noexcept {
+        if (m_data != m_inline) m_allocator.free(m_data, m_capacity + 1);
+    }
+    // Moves to a buffer of at least `capacity` chars and appends `tail` on the way
+    bool grow(size_t capacity, StringView tail) noexcept;
+    void take(String& other) noexcept;
+
+    char* m_data;
+    uint32_t m_size{ 0 };
+    uint32_t m_capacity{ INLINE_CAPACITY }; // Chars, the terminator not included
+    Allocator m_allocator;
+    char m_inline[INLINE_CAPACITY + 1];
+}; // struct String
+
+LA_NO_DISCARD inline bool operator==(const String& a, StringView b) noexcept { return a.view() == b; }
+LA_NO_DISCARD inline bool operator==(const String& a, const String& b) noexcept { return a.view() == b.view(); }
+
+namespace detail {
+    // Builds a new entry's key in place from what `find_or_insert()` got, copies in
+    // the container's allocator. False, and nothing built, when out of memory
+    template <typename K>
+    struct MakeKey {
+        template <typename Q>
+        static bool apply(K* at, Q&& key, const Allocator&) noexcept {
+            new (at, PlaceTag{}) K(::la::forward<Q>(key));
+            return true;
+        }
+    }; // struct MakeKey
+
+    template <>
+    struct MakeKey<String> {
+        static bool apply(String* at, String&& key, const Allocator&) noexcept {
+            new (at, PlaceTag{}) String(::la::move(key));
+            return true;
+        }
+        static bool apply(String* at, StringView key, const Allocator& allocator) noexcept {
+            String* made = new (at, PlaceTag{}) String(allocator);
+            if (made->append(key)) return true;
+            made->~String();
+            return false;
+        }
+    }; // struct MakeKey<String>
+} // namespace detail
+
+// --------------------------- Hashing ----------------------------------------
+
+// Every bit of the input reaches every bit of the result (MurmurHash3 finalizer)
+LA_NO_DISCARD inline uint64_t
+hash_u64(uint64_t x) noexcept {
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDull;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ull;
+    x ^= x >> 33;
+    return x;
+} // hash_u64
+
+LA_NO_DISCARD uint64_t hash_bytes(const void* data, size_t size) noexcept;
+
+/// Integers and enums; specialize for other key types
+template <typename T>
+struct Hash {
+    LA_NO_DISCARD uint64_t operator()(T value) const noexcept { return hash_u64(static_cast<uint64_t>(value)); }
+}; // struct Hash
+
+template <typename T>
+struct Hash<T*> {
+    LA_NO_DISCARD uint64_t operator()(const T* ptr) const noexcept {
+        return hash_u64(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr)));
+    }
+}; // struct Hash
+
+// `String` keys can be looked up by `StringView` and the other way round
+template <>
+struct Hash<StringView> {
+    LA_NO_DISCARD uint64_t operator()(StringView text) const noexcept { return hash_bytes(text.data(), text.size()); }
+}; // struct Hash
+
+template <>
+struct Hash<String> : Hash<StringView> {};
+
+// --------------------------- Hash Map ---------------------------------------
+
+namespace detail {
+    LA_CONSTEXPR_VAR size_t HASH_GROUP = 16;
+    LA_CONSTEXPR_VAR uint8_t CTRL_EMPTY = 0x80;
+    LA_CONSTEXPR_VAR uint8_t CTRL_DELETED = 0xFE; // Full slots hold the low 7 hash bits
+
+    /// Sixteen control bytes compared at once. Bit `i` of a mask stands for slot `i`
+    struct HashGroup {
+#if defined(LA_HASH_GROUP_SSE2)
+        explicit HashGroup(const uint8_t* ctrl) noexcept
+            : m_ctrl{ _mm_load_si128(reinterpret_cast<const __m128i*>(ctrl)) } {}
+
+        LA_NO_DISCARD uint32_t match(uint8_t h2) const noexcept {
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(m_ctrl, _mm_set1_epi8(static_cast<char>(h2)))));
+        }
+        LA_NO_DISCARD uint32_t match_empty() const noexcept { return match(CTRL_EMPTY); }
+        // Empty or deleted: the only bytes with the top bit set
+        LA_NO_DISCARD uint32_t match_free() const noexcept {
+            return static_cast<uint32_t>(_mm_movemask_epi8(m_ctrl));
+        }
+
+    private:
+        __m128i m_ctrl;
+#elif defined(LA_HASH_GROUP_NEON)
+        explicit HashGroup(const uint8_t* ctrl) noexcept : m_ctrl{ vld1q_u8(ctrl) } {}
+
+        LA_NO_DISCARD uint32_t match(uint8_t h2) const noexcept { return to_mask(vceqq_u8(m_ctrl, vdupq_n_u8(h2))); }
+        LA_NO_DISCARD uint32_t match_empty() const noexcept { return match(CTRL_EMPTY); }
+        LA_NO_DISCARD uint32_t match_free() const noexcept {
+            return to_mask(vcltq_s8(vreinterpretq_s8_u8(m_ctrl), vdupq_n_s8(0)));
+        }
+
+    private:
+        // No movemask: weigh each lane by its bit and add up each half
+        LA_NO_DISCARD static uint32_t to_mask(uint8x16_t lanes) noexcept {
+            static const uint8_t BITS[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+            const uint8x16_t weighted = vandq_u8(lanes, vld1q_u8(BITS));
+            return static_cast<uint32_t>(vaddv_u8(vget_low_u8(weighted))) |
+                   static_cast<uint32_t>(vaddv_u8(vget_high_u8(weighted))) << 8;
+        }
+
+        uint8x16_t m_ctrl;
+#else
+        // Two little-endian words, eight control bytes per operation
+        explicit HashGroup(const uint8_t* ctrl) noexcept : m_lo{ load(ctrl) }, m_hi{ load(ctrl + 8) } {}
+
+        // May report a full slot above a real match, `find()` compares keys anyway
+        LA_NO_DISCARD uint32_t match(uint8_t h2) const noexcept {
+            const uint64_t pattern = LSB * h2;
+            return to_mask(zero_bytes(m_lo ^ pattern)) | to_mask(zero_bytes(m_hi ^ pattern)) << 8;
+        }
+        // Exact: top bit set and bit 1 clear, 0x80 but not 0xFE
+        LA_NO_DISCARD uint32_t match_empty() const noexcept {
+            return to_mask(m_lo & ~(m_lo << 6) & MSB) | to_mask(m_hi & ~(m_hi << 6) & MSB) << 8;
+        }
+        LA_NO_DISCARD uint32_t match_free() const noexcept {
+            return to_mask(m_lo & MSB) | to_mask(m_hi & MSB) << 8;
+        }
+
+    private:
+        LA_CONSTEXPR_VAR static uint64_t LSB = 0x0101010101010101ull;
+        LA_CONSTEXPR_VAR static uint64_t MSB = 0x8080808080808080ull;
+
+        // Spelled out, compilers merge it into one load
+        LA_NO_DISCARD static uint64_t load(const uint8_t* p) noexcept {
+            return static_cast<uint64_t>(p[0])       | static_cast<uint64_t>(p[1]) << 8  |
+                   static_cast<uint64_t>(p[2]) << 16 | static_cast<uint64_t>(p[3]) << 24 |
+                   static_cast<uint64_t>(p[4]) << 32 | static_cast<uint64_t>(p[5]) << 40 |
+                   static_cast<uint64_t>(p[6]) << 48 | static_cast<uint64_t>(p[7]) << 56;
+        }
+        LA_NO_DISCARD static uint64_t zero_bytes(uint64_t x) noexcept { return (x - LSB) & ~x & MSB; }
+        // Top bit of byte `i` to bit `i`
+        LA_NO_DISCARD static uint32_t to_mask(uint64_t bytes) noexcept {
+            return static_cast<uint32_t>(((bytes >> 7) * 0x0102040810204080ull) >> 56);
+        }
+
+        uint64_t m_lo;
+        uint64_t m_hi;
+#endif
+    }; // struct HashGroup
+} // namespace detail
+
+/// Open addressing in the Swiss-table layout: one control byte per slot with
+/// 7 bits of the hash, probed 16 at a time, so most misses and hits touch one
+/// group of control bytes and one entry. Up to 7/8 full. Keys need `==` with
+/// whatever `find()` gets, and `H` must hash that to the same value
+template <typename K, typename V, typename H = Hash<K>>
+struct HashMap {
+    struct Entry {
+        K key;
+        V value;
+    }; // struct Entry
+
+    static_assert(alignof(Entry) <= 16, "HashMap entries are aligned to 16 bytes at most");
+
+    // Slots whose control bytes and entries still fit a `size_t`
+    LA_CONSTEXPR_VAR static size_t MAX_SLOTS = ~static_cast<size_t>(0) / (1 + sizeof(Entry));
+
+    explicit inline HashMap(Allocator allocator = Allocator::pool()) noexcept : m_allocator{ allocator } {}
+    inline ~HashMap() noexcept { clear(); release(); }
+
+    HashMap(const HashMap&) = delete;
+    HashMap& operator=(const HashMap&) = delete;
+    HashMap(HashMap&& other) noexcept : m_allocator{ other.m_allocator } { take(other); }
+    HashMap& operator=(HashMap&& other) noexcept {
+        if (this != &other) {
+            clear();
+            release();
+            m_allocator = other.m_allocator;
+            take(other);
+        }
+        return *this;
+    }
+
+    // ---------------------------- Lookup ------------------------------------
+
+    // Null when missing
+    template <typename Q>
+    LA_NO_DISCARD V* find(const Q& key) noexcept {
+        Entry* entry = find_entry(key, H{}(key));
+        return entry ? &entry->value : nullptr;
+    }
+    template <typename Q>
+    LA_NO_DISCARD const V* find(const Q& key) const noexcept { return const_cast<HashMap*>(this)->find(key); }
+    template <typename Q>
+    LA_NO_DISCARD bool contains(const Q& key) const noexcept { return find(key) != nullptr; }
+
+    // ---------------------------- Modifiers ---------------------------------
+
+    // Existing value, or a new value-initialized one. Null when out of memory
+    template <typename Q>
+    V* find_or_insert(Q&& key, bool* inserted = nullptr) noexcept;
+    // Insert or overwrite
+    template <typename Q>
+    V* insert(Q&& key, V value) noexcept {
+        V* slot = find_or_insert(::la::forward<Q>(key));
+        if (slot) *slot = ::la::move(value);
+        return slot;
+    }
+    template <typename Q>
+    bool erase(const Q& key) noexcept;
+    void clear() noexcept;
+    // Room for `count` entries without growing. False, and the map unchanged, when
+    // out of memory or when that would take more than `MAX_SLOTS`
+    bool reserve(size_t count) noexcept;
+
+    // ---------------------------- Iteration ---------------------------------
+
+    template <typename E>
+    struct Iterator {
+        Iterator& operator++() noexcept { ++m_index; skip(); return *this; }
+        E& operator*() const noexcept { return m_map->m_slots[m_index]; }
+        E* operator->() const noexcept { return &m_map->m_slots[m_index]; }
+        bool operator!=(const Iterator& other) const noexcept { return m_index != other.m_index; }
+
+    private:
+        friend struct HashMap;
+        Iterator(const HashMap* map, size_t index) noexcept : m_map{ map }, m_index{ index } { skip(); }
+        void skip() noexcept { while (m_index < m_map->m_capacity && (m_map->m_ctrl[m_index] & 0x80)) ++m_index; }
+
+        const HashMap* m_map;
+        size_t m_index;
+    }; // struct Iterator
+
+    // Slot order. Erasing during the walk is fine, inserting is not
+    LA_NO_DISCARD Iterator<Entry> begin() noexcept { return Iterator<Entry>{ this, 0 }; }
+    LA_NO_DISCARD Iterator<Entry> end() noexcept { return Iterator<Entry>{ this, m_capacity }; }
+    LA_NO_DISCARD Iterator<const Entry> begin() const noexcept { return Iterator<const Entry>{ this, 0 }; }
+    LA_NO_DISCARD Iterator<const Entry> end() const noexcept { return Iterator<const Entry>{ this, m_capacity }; }
+
+    LA_NO_DISCARD size_t size() const noexcept { return m_size; }
+    LA_NO_DISCARD size_t capacity() const noexcept { return m_capacity; }
+    LA_NO_DISCARD bool empty() const noexcept { return m_size == 0; }
+
+private:
+    // Top bits pick the group, the low 7 go to the control byte
+    LA_NO_DISCARD static uint8_t h2(uint64_t hash) noexcept { return static_cast<uint8_t>(hash & 0x7F); }
+    LA_NO_DISCARD size_t first_group(uint64_t hash) const noexcept {
+        return static_cast<size_t>(hash >> 7) & (m_capacity / detail::HASH_GROUP - 1);
+    }
+
+    template <typename Q>
+    Entry* find_entry(const Q& key, uint64_t hash) noexcept;
+    // First empty or deleted slot on `hash`'s probe sequence
+    LA_NO_DISCARD size_t find_free(uint64_t hash) const noexcept;
+    bool rehash(size_t capacity) noexcept;
+    void release() noexcept {
+        if (m_ctrl) m_allocator.free(m_ctrl, m_capacity + m_capacity * sizeof(Entry));
+    }
+    void take(HashMap& other) noexcept;
+
+    uint8_t* m_ctrl{ nullptr }; // `m_capacity` bytes, the entries right after
+    Entry* m_slots{ nullptr };
+    size_t m_capacity{ 0 };     // 0, or a power of two from 16
+    size_t m_size{ 0 };
+    size_t m_growth_left{ 0 };  // Empty slots that may still fill before a rehash
+    Allocator m_allocator;
+}; // struct HashMap
+
+template <typename K, typename V, typename H>
+template <typename Q>
+typename HashMap<K, V, H>::Entry* HashMap<K, V, H>::
+find_entry(const Q& key, uint64_t hash) noexcept {
+    if (!m_size) return nullptr;
+    const size_t mask = m_capacity / detail::HASH_GROUP - 1;
+    size_t group = first_group(hash);
+    // Triangular steps visit every group of a power-of-two table
+    for (size_t step = 1;; ++step) {
+        const detail::HashGroup ctrl{ m_ctrl + group * detail::HASH_GROUP };
+        for (uint32_t match = ctrl.match(h2(hash)); match; match &= match - 1) {
+            Entry& entry = m_slots[group * detail::HASH_GROUP + lowest_bit(match)];
+            if (entry.key == key) return &entry;
+        }
+        if (ctrl.match_empty()) return nullptr; // Never went past a group with room
+        group = (group + step) & mask;
+    }
+} // find_entry
+
+template <typename K, typename V, typename H>
+size_t HashMap<K, V, H>::
+find_free(uint64_t hash) const noexcept {
+    const size_t mask = m_capacity / detail::HASH_GROUP - 1;
+    size_t group = first_group(hash);
+    for (size_t step = 1;; ++step) {
+        const uint32_t free = detail::HashGroup{ m_ctrl + group * detail::HASH_GROUP }.match_free();
+        if (free) return group * detail::HASH_GROUP + lowest_bit(free);
+        group = (group + step) & mask;
+    }
+} // find_free
+
+template <typename K, typename V, typename H>
+template <typename Q>
+V* HashMap<K, V, H>::
+find_or_insert(Q&& key, bool* inserted) noexcept {
+    const uint64_t hash = H{}(key);
+    if (inserted) *inserted = false;
+    if (Entry* entry = find_entry(key, hash))
+        return &entry->value;
+
+    size_t index = m_capacity ? find_free(hash) : 0;
+    if (!m_capacity || (m_ctrl[index] == detail::CTRL_EMPTY && !m_growth_left)) {
+        // Mostly tombstones: same size. Otherwise double
+        const size_t capacity = !m_capacity ? detail::HASH_GROUP :
+                                m_size < m_capacity / 2 ? m_capacity : m_capacity * 2;
+        if (!rehash(capacity)) return nullptr;
+        index = find_free(hash);
+    }
+
+    // Key first: when its copy runs out of memory the slot stays free
+    Entry* entry = m_slots + index;
+    if (!detail::MakeKey<K>::apply(&entry->key, ::la::forward<Q>(key), m_allocator))
+        return nullptr;
+    new (&entry->value, detail::PlaceTag{}) V();
+    if (m_ctrl[index] == detail::CTRL_EMPTY) --m_growth_left;
+    m_ctrl[index] = h2(hash);
+    ++m_size;
+    if (inserted) *inserted = true;
+    return &entry->value;
+} // find_or_insert
+
+template <typename K, typename V, typename H>
+template <typename Q>
+bool HashMap<K, V, H>::
+erase(const Q& key) noexcept {
+    Entry* entry = find_entry(key, H{}(key));
+    if (!entry) return false;
+    entry->~Entry();
+    --m_size;
+
+    // A group with an empty slot never sent a probe further, so the slot can be
+    // empty again. Otherwise a tombstone keeps later probes going
+    const size_t index = static_cast<size_t>(entry - m_slots);
+    const size_t group = index & ~(detail::HASH_GROUP - 1);
+    if (detail::HashGroup{ m_ctrl + group }.match_empty()) {
+        m_ctrl[index] = detail::CTRL_EMPTY;
+        ++m_growth_left;
+    } else {
+        m_ctrl[index] = detail::CTRL_DELETED;
+    }
+    return true;
+} // erase
+
+template <typename K, typename V, typename H>
+void HashMap<K, V, H>::
+clear() noexcept {
+    for (size_t i = 0; i < m_capacity; ++i) {
+        if (!(m_ctrl[i] & 0x80)) m_slots[i].~Entry();
+        m_ctrl[i] = detail::CTRL_EMPTY; // Tombstones too
+    }
+    m_size = 0;
+    m_growth_left = m_capacity - m_capacity / 8;
+} // clear
+
+template <typename K, typename V, typename H>
+bool HashMap<K, V, H>::
+reserve(size_t count) noexcept {
+    size_t capacity = m_capacity ? m_capacity : detail::HASH_GROUP;
+    while (capacity - capacity / 8 < count) {
+        if (capacity > MAX_SLOTS / 2) return false;
+        capacity *= 2;
+    }
+    return capacity == m_capacity || rehash(capacity);
+} // reserve
+
+template <typename K, typename V, typename H>
+bool HashMap<K, V, H>::
+rehash(size_t capacity) noexcept {
+    if (capacity > MAX_SLOTS) return false;
+    uint8_t* ctrl = static_cast<uint8_t*>(m_allocator.alloc(capacity + capacity * sizeof(Entry)));
+    if (!ctrl) return false;
+    for (size_t i = 0; i < capacity; ++i) ctrl[i] = detail::CTRL_EMPTY;
+
+    uint8_t* old_ctrl = m_ctrl;
+    Entry* old_slots = m_slots;
+    const size_t old_capacity = m_capacity;
+    m_ctrl = ctrl;
+    m_slots = reinterpret_cast<Entry*>(ctrl + capacity);
+    m_capacity = capacity;
+    m_growth_left = capacity - capacity / 8 - m_size;
+
+    // Tombstones stay behind
+    for (size_t i = 0; i < old_capacity; ++i) {
+        if (old_ctrl[i] & 0x80) continue;
+        Entry& entry = old_slots[i];
+        const uint64_t hash = H{}(entry.key);
+        const size_t index = find_free(hash);
+        m_ctrl[index] = h2(hash);
+        new (m_slots + index, detail::PlaceTag{}) Entry(::la::move(entry));
+        entry.~Entry();
+    }
+    if (old_ctrl) m_allocator.free(old_ctrl, old_capacity + old_capacity * sizeof(Entry));
+    return true;
+} // rehash
+
+template <typename K, typename V, typename H>
+void HashMap<K, V, H>::
+take(HashMap& other) noexcept {
+    m_ctrl = other.m_ctrl;
+    m_slots = other.m_slots;
+    m_capacity = other.m_capacity;
+    m_size = other.m_size;
+    m_growth_left = other.m_growth_left;
+    other.m_ctrl = nullptr;
+    other.m_slots = nullptr;
+    other.m_capacity = other.m_size = other.m_growth_left = 0;
+} // take
+
+} // namespace la
+
+#endif // __LA_CONTAINERS_HEADER_GUARD
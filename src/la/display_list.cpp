@@ -0,0 +1,333 @@
+#include "display_list.hpp"
+#include "jobs.hpp"
+
+namespace la {
+
+// ------------------------------ Helpers -------------------------------------
+
+namespace detail {
+    LA_CONSTEXPR_VAR uint64_t FNV_OFFSET = 14695981039346656037ull;
+    LA_CONSTEXPR_VAR uint64_t FNV_PRIME = 1099511628211ull;
+
+    LA_NO_DISCARD static inline uint64_t
+    fnv1a(uint64_t hash, const void* data, size_t size) noexcept {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= p[i];
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    } // fnv1a
+
+    LA_NO_DISCARD static inline size_t
+    align8(size_t size) noexcept { return (size + 7) & ~static_cast<size_t>(7); }
+
+    // Hash over everything that affects the pixels, payload included
+    LA_NO_DISCARD static inline uint64_t
+    hash_cmd(const DrawCmd& cmd, const void* payload, size_t payload_size) noexcept {
+        uint64_t h = FNV_OFFSET;
+        h = fnv1a(h, &cmd.op, sizeof(cmd.op));
+        h = fnv1a(h, &cmd.scale, sizeof(cmd.scale));
+        h = fnv1a(h, &cmd.color, sizeof(cmd.color));
+        h = fnv1a(h, &cmd.bounds, sizeof(cmd.bounds));
+        h = fnv1a(h, &cmd.x, sizeof(cmd.x));
+        h = fnv1a(h, &cmd.y, sizeof(cmd.y));
+        // Field by field: `Image` has padding bytes
+        h = fnv1a(h, &cmd.image.pixels, sizeof(cmd.image.pixels));
+        h = fnv1a(h, &cmd.image.width, sizeof(cmd.image.width));
+        h = fnv1a(h, &cmd.image.height, sizeof(cmd.image.height));
+        h = fnv1a(h, &cmd.image.stride, sizeof(cmd.image.stride));
+        return fnv1a(h, payload, payload_size);
+    } // hash_cmd
+} // namespace detail
+
+// ------------------------------ Storage -------------------------------------
+
+void DisplayList::
+reset() noexcept {
+    m_arena.reset();
+    m_count = 0;
+    m_failed = false;
+} // reset
+
+DrawCmd* DisplayList::
+push(DrawOp op, uint32_t color, size_t payload) noexcept {
+    const size_t size = detail::align8(sizeof(DrawCmd) + payload);
+
+    DrawCmd* cmd = static_cast<DrawCmd*>(m_arena.alloc(size, 8));
+    if (!cmd) {
+        m_failed = true;
+        return nullptr;
+    }
+    ++m_count;
+
+    cmd->op = op;
+    cmd->scale = 1;
+    cmd->reserved = 0;
+    cmd->color = color;
+    cmd->size = static_cast<uint32_t>(size);
+    cmd->count = 0;
+    cmd->hash = 0;
+    cmd->bounds = Rect{};
+    cmd->x = cmd->y = 0;
+    cmd->image = Image{};
+    return cmd;
+} // push
+
+// ------------------------------ Recording -----------------------------------
+
+void DisplayList::
+clear(uint32_t color) noexcept {
+    DrawCmd* cmd = push(DrawOp::Clear, color, 0);
+    if (!cmd) return;
+    cmd->bounds = Rect::infinite();
+    cmd->hash = detail::hash_cmd(*cmd, nullptr, 0);
+} // clear
+
+void DisplayList::
+fill_rect(const Rect& r, uint32_t color) noexcept {
+    if (r.is_empty()) return;
+    DrawCmd* cmd = push(DrawOp::FillRect, color, 0);
+    if (!cmd) return;
+    cmd->bounds = r;
+    cmd->hash = detail::hash_cmd(*cmd, nullptr, 0);
+} // fill_rect
+
+void DisplayList::
+blit(const Image& image, int x, int y) noexcept {
+    if (!image.pixels) return;
+    DrawCmd* cmd = push(DrawOp::Blit, 0, 0);
+    if (!cmd) return;
+    cmd->x = x;
+    cmd->y = y;
+    cmd->image = image;
+    cmd->bounds = Rect::from_size(x, y, image.width, image.height);
+    cmd->hash = detail::hash_cmd(*cmd, nullptr, 0);
+} // blit
+
+void DisplayList::
+text(int x, int y, const char* str, size_t length, uint32_t color, int scale) noexcept {
+    if (!str || length == 0 || scale <= 0) return;
+    DrawCmd* cmd = push(DrawOp::Text, color, length);
+    if (!cmd) return;
+
+    char* dst = reinterpret_cast<char*>(cmd + 1);
+    for (size_t i = 0; i < length; ++i) dst[i] = str[i];
+
+    cmd->scale = static_cast<uint8_t>(scale > 255 ? 255 : scale);
+    cmd->count = static_cast<uint32_t>(length);
+    cmd->x = x;
+    cmd->y = y;
+    cmd->bounds = Canvas::text_bounds(x, y, str, length, cmd->scale);
+    cmd->hash = detail::hash_cmd(*cmd, dst, length);
+} // text
+
+void DisplayList::
+path(const Point* points, size_t count, uint32_t color) noexcept {
+    if (!points || count < 3) return;
+    DrawCmd* cmd = push(DrawOp::Path, color, count * sizeof(Point));
+    if (!cmd) return;
+
+    Point* dst = reinterpret_cast<Point*>(cmd + 1);
+    for (size_t i = 0; i < count; ++i) dst[i] = points[i];
+
+    cmd->count = static_cast<uint32_t>(count);
+    cmd->bounds = Canvas::path_bounds(points, count);
+    cmd->hash = detail::hash_cmd(*cmd, dst, count * sizeof(Point));
+} // path
+
+// ------------------------------ Playback ------------------------------------
+
+DisplayList::Reader::
+Reader(const DisplayList& list) noexcept
+    : m_block{ list.m_arena.first_block() }, m_offset{ 0 }, m_left{ list.m_count } {}
+
+const DrawCmd* DisplayList::Reader::
+next() noexcept {
+    if (m_left == 0) return nullptr;
+
+    // Skip exhausted blocks (the tail of a block may be unused)
+    while (m_block && m_offset >= m_block->used) {
+        m_block = m_block->next;
+        m_offset = 0;
+    }
+    if (!m_block) return nullptr;
+
+    const DrawCmd* cmd = reinterpret_cast<const DrawCmd*>(m_block->data() + m_offset);
+    m_offset += cmd->size;
+    --m_left;
+    return cmd;
+} // next
+
+void DisplayList::
+replay(Canvas& canvas, const DrawCmd& cmd) noexcept {
+    switch (cmd.op) {
+    case DrawOp::Clear:    canvas.clear(cmd.color); break;
+    case DrawOp::FillRect: canvas.fill_rect(cmd.bounds, cmd.color); break;
+    case DrawOp::Blit:     canvas.blit(cmd.image, cmd.x, cmd.y); break;
+    case DrawOp::Text:
+        canvas.draw_text(cmd.x, cmd.y, cmd.text(), cmd.count, cmd.color, cmd.scale);
+        break;
+    case DrawOp::Path:
+        canvas.fill_path(cmd.points(), cmd.count, cmd.color);
+        break;
+    } // switch
+} // replay
+
+void DisplayList::
+replay(Canvas& canvas) const noexcept {
+    Reader reader{ *this };
+    while (const DrawCmd* cmd = reader.next()) {
+        if (cmd->bounds.intersects(canvas.clip))
+            replay(canvas, *cmd);
+    }
+} // replay
+
+namespace detail {
+    struct BandReplay {
+        const DisplayList* list;
+        const Canvas* canvas;
+        int band_height;
+    }; // struct BandReplay
+
+    // Bands [begin, end) of the clip, one walk over the list
+    static void
+    replay_bands(void* context, uint32_t begin, uint32_t end) noexcept {
+        const BandReplay& r = *static_cast<const BandReplay*>(context);
+        Canvas band = *r.canvas;
+        const int top = band.clip.top;
+        band.clip.top = top + static_cast<int>(begin) * r.band_height;
+        if (band.clip.bottom > top + static_cast<int>(end) * r.band_height)
+            band.clip.bottom = top + static_cast<int>(end) * r.band_height;
+        r.list->replay(band);
+    } // replay_bands
+} // namespace detail
+
+void DisplayList::
+replay(Canvas& canvas, JobSystem& jobs, int band_height) const noexcept {
+    if (canvas.clip.is_empty()) return;
+    if (band_height < 1) band_height = 1;
+    detail::BandReplay bands{ this, &canvas, band_height };
+    const uint32_t count = static_cast<uint32_t>((canvas.clip.height() + band_height - 1) / band_height);
+    parallel_for(jobs, 0, count, 1, &detail::replay_bands, &bands);
+} // replay
+
+// ------------------------------ Damage --------------------------------------
+
+void Damage::
+add(const Rect& r) noexcept {
+    if (r.is_empty()) return;
+
+    // Already covered or overlapping: grow in place
+    int grown = -1;
+    for (int i = 0; i < count && grown < 0; ++i) {
+        if (rects[i].contains(r)) return;
+        if (rects[i].intersects(r)) {
+            rects[i] = rects[i].unite(r);
+            grown = i;
+        }
+    }
+
+    if (grown < 0) {
+        if (count < MAX_RECTS) {
+            rects[count++] = r;
+            return;
+        }
+
+        // Out of slots: merge into the rect that grows the least
+        int64_t best_growth = -1;
+        for (int i = 0; i < count; ++i) {
+            const int64_t growth = rects[i].unite(r).area() - rects[i].area();
+            if (best_growth < 0 || growth < best_growth) {
+                grown = i;
+                best_growth = growth;
+            }
+        }
+        rects[grown] = rects[grown].unite(r);
+    }
+
+    // The grown rect may now overlap others: fold them in until none does, so
+    // `RetainedRenderer` never re-rasterizes a pixel twice
+    for (int j = 0; j < count;) {
+        if (j == grown || !rects[grown].intersects(rects[j])) {
+            ++j;
+            continue;
+        }
+        rects[grown] = rects[grown].unite(rects[j]);
+        rects[j] = rects[--count];
+        if (grown == count) grown = j; // The last rect, the grown one, moved into `j`
+        j = 0;
+    }
+} // add
+
+Rect Damage::
+bounds() const noexcept {
+    Rect result{};
+    for (int i = 0; i < count; ++i)
+        result = result.unite(rects[i]);
+    return result;
+} // bounds
+
+// ------------------------------ Retained Renderer ---------------------------
+
+DisplayList& RetainedRenderer::
+begin_frame() noexcept {
+    m_current ^= 1;
+    m_lists[m_current].reset();
+    return m_lists[m_current];
+} // begin_frame
+
+const Damage& RetainedRenderer::
+end_frame(Canvas& target) noexcept {
+    LA_PROFILE_FUNCTION();
+    const DisplayList& current = m_lists[m_current];
+    const DisplayList& previous = m_lists[m_current ^ 1];
+
+    m_damage.reset();
+
+    // Canvas changed (resize, first frame, dropped commands): repaint everything
+    if (m_full || target.width != m_width || target.height != m_height ||
+        current.has_failed() || previous.has_failed()) {
+        m_damage.add(target.bounds());
+    }
+    else {
+        // Commands are compared in order, any mismatch damages old and new bounds
+        DisplayList::Reader now{ current };
+        DisplayList::Reader was{ previous };
+        const DrawCmd* a = now.next();
+        const DrawCmd* b = was.next();
+        while (a || b) {
+            if (a && b) {
+                if (a->hash != b->hash || a->bounds != b->bounds) {
+                    m_damage.add(a->bounds.intersect(target.bounds()));
+                    m_damage.add(b->bounds.intersect(target.bounds()));
+                }
+            }
+            else {
+                const DrawCmd* only = a ? a : b;
+                m_damage.add(only->bounds.intersect(target.bounds()));
+            }
+            a = a ? now.next() : nullptr;
+            b = b ? was.next() : nullptr;
+        }
+        for (int i = 0; i < m_extra.count; ++i)
+            m_damage.add(m_extra.rects[i].intersect(target.bounds()));
+    }
+
+    m_full = false;
+    m_extra.reset();
+    m_width = target.width;
+    m_height = target.height;
+
+    // Re-rasterize only inside the damage
+    const Rect saved_clip = target.clip;
+    for (int i = 0; i < m_damage.count; ++i) {
+        target.set_clip(m_damage.rects[i].intersect(saved_clip));
+        if (!target.clip.is_empty())
+            current.replay(target);
+    }
+    target.clip = saved_clip;
+    return m_damage;
+} // end_frame
+
+} // namespace la
@@ -0,0 +1,155 @@
+#ifndef __LA_DISPLAY_LIST_HEADER_GUARD
+#define __LA_DISPLAY_LIST_HEADER_GUARD
+
+#include "arena.hpp"
+#include "canvas.hpp"
+
+/*
+    Display lists: draw commands are recorded into chained memory blocks,
+    replayed onto a `Canvas`, and diffed frame-to-frame by `RetainedRenderer`
+    so only the bounds of changed commands get re-rasterized.
+*/
+
+namespace la {
+
+struct JobSystem;
+
+// --------------------------- Draw Command -----------------------------------
+
+enum class DrawOp : uint8_t {
+    Clear,
+    FillRect,
+    Blit,
+    Text,
+    Path,
+}; // enum class DrawOp
+
+// Fixed header, text bytes or path points follow it in the same block
+struct DrawCmd {
+    DrawOp   op;
+    uint8_t  scale;    // Text only
+    uint16_t reserved;
+    uint32_t color;
+    uint32_t size;     // Header + payload, offset to the next command
+    uint32_t count;    // Text bytes or path points
+    uint64_t hash;     // Content hash used for frame diffing
+    Rect     bounds;   // Conservative canvas-space bounds
+    int      x, y;     // Text/blit origin
+    Image    image;    // Blit only
+
+    LA_NO_DISCARD const char* text() const noexcept {
+        return reinterpret_cast<const char*>(this + 1);
+    }
+    LA_NO_DISCARD const Point* points() const noexcept {
+        return reinterpret_cast<const Point*>(this + 1);
+    }
+}; // struct DrawCmd
+
+// --------------------------- Display List -----------------------------------
+
+struct DisplayList {
+    // Arena blocks are reused across frames, so steady-state recording never allocates
+    LA_CONSTEXPR_VAR static size_t BLOCK_SIZE = 64 * 1024;
+
+    // Walks commands in recording order
+    struct Reader {
+        explicit Reader(const DisplayList& list) noexcept;
+        LA_NO_DISCARD const DrawCmd* next() noexcept;
+    private:
+        const Arena::Block* m_block;
+        size_t m_offset;
+        size_t m_left;
+    }; // struct Reader
+
+    explicit inline DisplayList() noexcept : m_arena{ BLOCK_SIZE } {}
+
+    DisplayList(const DisplayList&) = delete;
+    DisplayList& operator=(const DisplayList&) = delete;
+    DisplayList(DisplayList&&) = delete;
+    DisplayList& operator=(DisplayList&&) = delete;
+
+    // ---------------------------- Recording ---------------------------------
+
+    void clear(uint32_t color) noexcept;
+    void fill_rect(const Rect& r, uint32_t color) noexcept;
+    // `image.pixels` is referenced, not copied: record a new pointer (or
+    // invalidate the area) when its content changes
+    void blit(const Image& image, int x, int y) noexcept;
+    void text(int x, int y, const char* str, size_t length,
+              uint32_t color, int scale = 1) noexcept;
+    void path(const Point* points, size_t count, uint32_t color) noexcept;
+
+    // Forget all commands, keep the memory
+    void reset() noexcept;
+
+    // ---------------------------- Playback ----------------------------------
+
+    // Draw every command intersecting `canvas.clip`
+    void replay(Canvas& canvas) const noexcept;
+    // Same pixels, the clip cut into `band_height`-row bands rasterized in parallel
+    void replay(Canvas& canvas, JobSystem& jobs, int band_height = 64) const noexcept;
+    static void replay(Canvas& canvas, const DrawCmd& cmd) noexcept;
+
+    LA_NO_DISCARD size_t size() const noexcept { return m_count; }
+    LA_NO_DISCARD bool is_empty() const noexcept { return m_count == 0; }
+    LA_NO_DISCARD bool has_failed() const noexcept { return m_failed; }
+    LA_NO_DISCARD ArenaStats memory() const noexcept { return m_arena.stats(); }
+
+private:
+    DrawCmd* push(DrawOp op, uint32_t color, size_t payload) noexcept;
+
+    Arena  m_arena; // Commands only, 8-aligned: blocks hold them back to back
+    size_t m_count{ 0 };
+    bool   m_failed{ false }; // Out of memory, some commands were dropped
+}; // struct DisplayList
+
+// --------------------------- Damage -----------------------------------------
+
+// A few disjoint-ish rectangles, merged when the budget runs out
+struct Damage {
+    LA_CONSTEXPR_VAR static int MAX_RECTS = 8;
+
+    Rect rects[MAX_RECTS];
+    int count{ 0 };
+
+    void add(const Rect& r) noexcept;
+    void reset() noexcept { count = 0; }
+    LA_NO_DISCARD bool is_empty() const noexcept { return count == 0; }
+    LA_NO_DISCARD Rect bounds() const noexcept;
+}; // struct Damage
+
+// --------------------------- Retained Renderer ------------------------------
+
+/// Double-buffered display lists: record into `begin_frame()`, then
+/// `end_frame()` repaints only what differs from the previous frame.
+struct RetainedRenderer {
+    explicit inline RetainedRenderer() noexcept = default;
+
+    RetainedRenderer(const RetainedRenderer&) = delete;
+    RetainedRenderer& operator=(const RetainedRenderer&) = delete;
+
+    // Empty list to record the new frame into
+    LA_NO_DISCARD DisplayList& begin_frame() noexcept;
+    // Diff against the previous frame and re-rasterize the damage into `target`
+    const Damage& end_frame(Canvas& target) noexcept;
+
+    // Content the lists can't see changed (e.g. blitted pixels)
+    void invalidate(const Rect& r) noexcept { m_extra.add(r); }
+    void invalidate_all() noexcept { m_full = true; }
+
+    LA_NO_DISCARD const Damage& damage() const noexcept { return m_damage; }
+
+private:
+    DisplayList m_lists[2];
+    int m_current{ 0 };
+
+    Damage m_damage;
+    Damage m_extra;
+    int m_width{ 0 };
+    int m_height{ 0 };
+    bool m_full{ true };
+}; // struct RetainedRenderer
+
+} // namespace la
+
+#endif // __LA_DISPLAY_LIST_HEADER_GUARD
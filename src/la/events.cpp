@@ -0,0 +1,176 @@
+#include "la.hpp"
+
+// Platform-independent part of `la::EventQueue` and `la::InputState`
+
+namespace la {
+
+void
+dispatch_event(IWindowEvents& handler, const Event& e) noexcept {
+    switch (e.type) {
+    case EventType::MouseMove: handler.on_mouse_move(e.x, e.y);        break;
+    case EventType::Scroll:    handler.on_scroll_vertical(e.scroll);   break;
+    case EventType::KeyDown:   handler.on_key_down(e.key);             break;
+    case EventType::KeyUp:     handler.on_key_up(e.key);               break;
+    case EventType::Focus:     handler.on_focus_change(e.x != 0);      break;
+    case EventType::Resize:    handler.on_resize(e.x, e.y);            break;
+    } // switch
+} // dispatch_event
+
+void EventQueue::
+push(const Event& e) noexcept {
+    // Never dropped, only the latest size matters
+    if (e.type == EventType::Resize) {
+        m_resize_time.store_relaxed(e.time_ns);
+        m_resize.store(detail::pack_size(e.x, e.y));
+        return;
+    }
+    const bool coalesce = e.type == EventType::MouseMove || e.type == EventType::Scroll;
+
+    // Fold into the staged event: only the latest position and the summed scroll matter
+    if (coalesce && m_has_staged && m_staged.type == e.type) {
+        m_staged.time_ns = e.time_ns;
+        m_staged.x = e.x;
+        m_staged.y = e.y;
+        m_staged.scroll += e.scroll;
+        m_staged.merged += e.merged;
+        return;
+    }
+
+    flush();
+    if (coalesce) {
+        m_staged = e;
+        m_has_staged = true;
+    }
+    else publish(e);
+} // push
+
+void EventQueue::
+flush() noexcept {
+    if (!m_has_staged) return;
+    m_has_staged = false;
+    publish(m_staged);
+} // flush
+
+void EventQueue::
+publish(const Event& e) noexcept {
+    const unsigned key = static_cast<unsigned>(e.key) < KEYS ? static_cast<unsigned>(e.key) : 0;
+    uint64_t& down = m_keys_down[key / 64];
+    const uint64_t bit = 1ull << (key % 64);
+
+    // Only the release of a key-down or focus already published may take the reserve,
+    // so it never holds more than one entry per key plus one focus loss
+    const bool ends_published = (e.type == EventType::KeyUp && (down & bit)) ||
+                                (e.type == EventType::Focus && !e.x && m_focused);
+    const uint32_t tail = m_tail.load_relaxed();
+    if (tail - m_head.load() >= (ends_published ? CAPACITY : CAPACITY - RESERVED)) {
+        m_dropped.store_relaxed(m_dropped.load_relaxed() + 1); // Producer-only counter
+        return;
+    }
+
+    if (e.type == EventType::KeyDown)    down |= bit;
+    else if (e.type == EventType::KeyUp) down &= ~bit;
+    else if (e.type == EventType::Focus) m_focused = e.x != 0;
+    m_events[tail & (CAPACITY - 1)] = e;
+    m_tail.store(tail + 1);
+} // publish
+
+bool EventQueue::
+take_resize(Event& out) noexcept {
+    const uint64_t size = m_resize.exchange(0);
+    if (!size) return false;
+    out = Event{};
+    out.time_ns = m_resize_time.load_relaxed();
+    out.type = EventType::Resize;
+    detail::unpack_size(size, out.x, out.y);
+    return true;
+} // take_resize
+
+unsigned EventQueue::
+dispatch(IWindowEvents& handler) noexcept {
+    LA_PROFILE_FUNCTION();
+
+    // Stop at the tail seen on entry, so a handler that pumps messages can't loop forever
+    const uint32_t end = m_tail.load();
+    unsigned count = 0;
+    Event e;
+    while (m_head.load_relaxed() != end && pop(e)) {
+        dispatch_event(handler, e);
+        ++count;
+    }
+    if (take_resize(e)) {
+        dispatch_event(handler, e);
+        ++count;
+    }
+    return count;
+} // dispatch
+
+// ------------------------------ Input State ---------------------------------
+
+void InputState::
+key(Key k, bool down) noexcept {
+    const unsigned i = static_cast<unsigned>(k);
+    if (k == Key::__NONE__ || i >= static_cast<unsigned>(Key::__LAST__)) return;
+
+    const uint64_t bit = 1ull << (i % 64);
+    uint64_t& word = m_working.down[i / 64];
+    if (down && !(word & bit)) m_working.went_down[i / 64] |= bit; // Not auto-repeat
+    if (!down && (word & bit)) m_working.went_up[i / 64] |= bit;
+    word = down ? word | bit : word & ~bit;
+} // key
+
+void InputState::
+mouse_move(int x, int y) noexcept {
+    if (m_has_mouse) {
+        m_working.mouse_dx += x - m_working.mouse_x;
+        m_working.mouse_dy += y - m_working.mouse_y;
+    }
+    m_has_mouse = true;
+    m_working.mouse_x = x;
+    m_working.mouse_y = y;
+} // mouse_move
+
+void InputState::
+release_all() noexcept {
+    for (unsigned w = 0; w < InputSnapshot::WORDS; ++w) {
+        m_working.went_up[w] |= m_working.down[w];
+        m_working.down[w] = 0;
+    }
+} // release_all
+
+void InputState::
+publish() noexcept {
+    // Publish n writes buffer n & 1, so readers of publish n - 1 are undisturbed.
+    // The count turns odd before the buffer write starts and even after it ends
+    const uint64_t sequence = m_sequence.load_relaxed(); // Even, single writer
+    const uint64_t published = sequence / 2 + 1;
+    m_sequence.store(sequence + 1);
+    atomic_release_fence(); // The odd count is visible before any buffer write
+
+    m_working.sequence = published;
+    m_buffers[published & 1] = m_working;
+    m_sequence.store(sequence + 2);
+
+    // Edges and deltas restart, held keys and the position carry over
+    for (unsigned w = 0; w < InputSnapshot::WORDS; ++w)
+        m_working.went_down[w] = m_working.went_up[w] = 0;
+    m_working.mouse_dx = m_working.mouse_dy = 0;
+    m_working.scroll = 0.f;
+} // publish
+
+InputSnapshot InputState::
+snapshot() const noexcept {
+    InputSnapshot copy;
+    for (;;) {
+        // The last complete publish, also while the next one writes the other buffer
+        const uint64_t published = m_sequence.load() / 2;
+        copy = m_buffers[published & 1];
+        atomic_acquire_fence(); // Keep the copy above the re-check
+
+        // The buffer is rewritten by publish `published + 2`, which first makes
+        // the count 2 * published + 3
+        if (m_sequence.load_relaxed() < 2 * published + 3)
+            return copy;
+    }
+} // snapshot
+
+} // namespace la
@@ -0,0 +1,487 @@
+#include "jobs.hpp"
+#include "containers.hpp" // Placement new
+#include "pool.hpp"
+
+namespace la {
+
+// ------------------------------ Internals -----------------------------------
+
+struct JobSystem::Job {
+    TaskProc task;   // Either a task,
+    RangeProc range; // or a range that splits while it is longer than `grain`
+    void* context;
+    TaskGroup* group;
+    uint32_t begin;
+    uint32_t end;
+    uint32_t grain;
+}; // struct Job
+
+// Chase-Lev deque: the owner pushes and pops at `bottom`, thieves take from
+// `top`. Indices only grow, the slot is the index modulo the capacity
+struct JobSystem::Worker {
+    alignas(64) Atomic<int64_t> top{ 0 };
+    alignas(64) Atomic<int64_t> bottom{ 0 };
+    Atomic<uintptr_t>* slots{ nullptr };
+    int64_t mask{ 0 };
+
+    alignas(64) JobSystem* system{ nullptr };
+    unsigned index{ 0 };
+    uint32_t rng{ 0 };               // Victim choice
+    Atomic<uint32_t> sleeping{ 0 };  // 1 while `wake` may be waited on, cleared by the waker
+    Signal wake;
+    Thread thread;
+    Atomic<uint64_t> executed{ 0 };  // Written by the owner only
+    Atomic<uint64_t> stolen{ 0 };
+    Atomic<uint64_t> sleeps{ 0 };
+}; // struct Worker
+
+struct JobSystem::InjectSlot {
+    Atomic<uint64_t> sequence; // Position it may be written at, plus one once written
+    Atomic<uintptr_t> job;
+}; // struct InjectSlot
+
+thread_local JobSystem::Worker* JobSystem::t_current = nullptr;
+
+namespace detail {
+    using JobPool = Pool<JobSystem::Job>;
+
+    LA_NO_DISCARD static inline unsigned
+    pow2_at_least(unsigned value) noexcept {
+        return value <= 2 ? 2 : 2u << floor_log2(value - 1);
+    } // pow2_at_least
+
+    // Owner only. False when full
+    LA_NO_DISCARD static inline bool
+    deque_push(JobSystem::Worker& w, JobSystem::Job* job) noexcept {
+        const int64_t b = w.bottom.load_relaxed();
+        const int64_t t = w.top.load();
+        if (b - t > w.mask) return false;
+        w.slots[b & w.mask].store_relaxed(reinterpret_cast<uintptr_t>(job));
+        w.bottom.store(b + 1); // Releases the slot
+        return true;
+    } // deque_push
+
+    // Owner only, newest first
+    LA_NO_DISCARD static inline JobSystem::Job*
+    deque_pop(JobSystem::Worker& w) noexcept {
+        const int64_t b = w.bottom.load_relaxed() - 1;
+        w.bottom.store_relaxed(b);
+        atomic_fence(); // Thieves see the claim before we read `top`
+        int64_t t = w.top.load_relaxed();
+        if (t > b) { // Empty
+            w.bottom.store_relaxed(b + 1);
+            return nullptr;
+        }
+        JobSystem::Job* job = reinterpret_cast<JobSystem::Job*>(w.slots[b & w.mask].load_relaxed());
+        if (t == b) { // The last one: race the thieves for it
+            if (!w.top.compare_exchange(t, t + 1)) job = nullptr;
+            w.bottom.store_relaxed(b + 1);
+        }
+        return job;
+    } // deque_pop
+
+    // Any thread, oldest first. Null when empty or another thief won
+    LA_NO_DISCARD static inline JobSystem::Job*
+    deque_steal(JobSystem::Worker& w) noexcept {
+        int64_t t = w.top.load();
+        atomic_fence();
+        const int64_t b = w.bottom.load();
+        if (t >= b) return nullptr;
+        JobSystem::Job* job = reinterpret_cast<JobSystem::Job*>(w.slots[t & w.mask].load_relaxed());
+        return w.top.compare_exchange(t, t + 1) ? job : nullptr;
+    } // deque_steal
+
+    LA_NO_DISCARD static inline uint32_t
+    next_random(uint32_t& state) noexcept {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    } // next_random
+
+    static inline void
+    bump(Atomic<uint64_t>& counter) noexcept { counter.store_relaxed(counter.load_relaxed() + 1); }
+} // namespace detail
+
+// ------------------------------ Job System ----------------------------------
+
+JobSystem::
+JobSystem(const Config& config) noexcept : m_config{ config } {
+    m_config.deque_capacity = detail::pow2_at_least(m_config.deque_capacity);
+    m_config.inject_capacity = detail::pow2_at_least(m_config.inject_capacity);
+}
+
+bool JobSystem::
+start() noexcept {
+    if (m_block) return false;
+
+    unsigned count = m_config.workers;
+    if (!count) {
+        count = get_cpu_topology().cores;
+        if (count < 2) count = 2; // A background thread even on one core, for `then()` chains
+    }
+    if (count > MAX_JOB_WORKERS) count = MAX_JOB_WORKERS;
+
+    // [workers][injection slots][deques]
+    const size_t worker_bytes = sizeof(Worker) * count;
+    const size_t inject_bytes = sizeof(InjectSlot) * m_config.inject_capacity;
+    const size_t deque_bytes = sizeof(Atomic<uintptr_t>) * m_config.deque_capacity;
+    m_block_bytes = worker_bytes + inject_bytes + deque_bytes * count;
+    LA_ALLOC_TAG(AllocTag::Jobs);
+    unsigned char* block = static_cast<unsigned char*>(::la::alloc(m_block_bytes));
+    if (!block) return false;
+    m_block = block;
+
+    m_workers = reinterpret_cast<Worker*>(block);
+    m_inject = reinterpret_cast<InjectSlot*>(block + worker_bytes);
+    for (unsigned i = 0; i < m_config.inject_capacity; ++i) {
+        InjectSlot* slot = new (m_inject + i, detail::PlaceTag{}) InjectSlot();
+        slot->sequence.store_relaxed(i);
+    }
+    m_inject_head.store_relaxed(0);
+    m_inject_tail.store_relaxed(0);
+
+    for (unsigned i = 0; i < count; ++i) {
+        Worker* w = new (m_workers + i, detail::PlaceTag{}) Worker();
+        w->system = this;
+        w->index = i;
+        w->rng = 0x9E3779B9u * (i + 1);
+        w->mask = static_cast<int64_t>(m_config.deque_capacity) - 1;
+        w->slots = reinterpret_cast<Atomic<uintptr_t>*>(block + worker_bytes + inject_bytes + deque_bytes * i);
+        for (unsigned j = 0; j < m_config.deque_capacity; ++j)
+            (void)new (w->slots + j, detail::PlaceTag{}) Atomic<uintptr_t>();
+    }
+    m_worker_count = count;
+    t_current = &m_workers[0];
+    m_running.store(1);
+
+    // A worker whose thread didn't start just never has anything to steal
+    for (unsigned i = 1; i < count; ++i)
+        (void)m_workers[i].thread.start(&JobSystem::worker_main, &m_workers[i]);
+    return true;
+} // start
+
+void JobSystem::
+stop() noexcept {
+    if (!m_block) return;
+    while (help()) {}
+
+    // From here on, submitted jobs run inline
+    (void)m_running.exchange(0);
+    for (unsigned i = 1; i < m_worker_count; ++i) {
+        Worker& w = m_workers[i];
+        if (w.sleeping.exchange(0)) m_sleeping.fetch_add(static_cast<uint32_t>(-1));
+        w.wake.set();
+    }
+    for (unsigned i = 1; i < m_worker_count; ++i) m_workers[i].thread.join();
+
+    if (t_current && t_current->system == this) t_current = nullptr;
+    for (unsigned i = 0; i < m_worker_count; ++i) m_workers[i].~Worker();
+    LA_ALLOC_TAG(AllocTag::Jobs);
+    ::la::free(m_block, m_block_bytes);
+    m_block = nullptr;
+    m_workers = nullptr;
+    m_inject = nullptr;
+    m_worker_count = 0;
+} // stop
+
+JobSystem::Worker* JobSystem::
+current_worker() const noexcept {
+    return t_current && t_current->system == this ? t_current : nullptr;
+} // current_worker
+
+int JobSystem::
+worker_index() const noexcept {
+    const Worker* self = current_worker();
+    return self ? static_cast<int>(self->index) : -1;
+} // worker_index
+
+JobSystem::Stats JobSystem::
+stats() const noexcept {
+    Stats stats;
+    for (unsigned i = 0; i < m_worker_count; ++i) {
+        stats.executed += m_workers[i].executed.load_relaxed();
+        stats.stolen += m_workers[i].stolen.load_relaxed();
+        stats.sleeps += m_workers[i].sleeps.load_relaxed();
+    }
+    stats.injected = m_injected.load_relaxed();
+    stats.inlined = m_inlined.load_relaxed();
+    return stats;
+} // stats
+
+// ------------------------------ Injection Queue -----------------------------
+
+bool JobSystem::
+inject(Job* job) noexcept {
+    const uint64_t mask = m_config.inject_capacity - 1;
+    uint64_t pos = m_inject_tail.load_relaxed();
+    for (;;) {
+        const int64_t lag = static_cast<int64_t>(m_inject[pos & mask].sequence.load() - pos);
+        if (lag == 0) {
+            if (m_inject_tail.compare_exchange(pos, pos + 1)) break; // `pos` reloaded on failure
+        } else if (lag < 0) {
+            return false; // Full: the slot still holds a job from one lap ago
+        } else {
+            pos = m_inject_tail.load_relaxed();
+        }
+    }
+    InjectSlot& slot = m_inject[pos & mask];
+    slot.job.store_relaxed(reinterpret_cast<uintptr_t>(job));
+    slot.sequence.store(pos + 1);
+    return true;
+} // inject
+
+JobSystem::Job* JobSystem::
+take_injected() noexcept {
+    const uint64_t mask = m_config.inject_capacity - 1;
+    uint64_t pos = m_inject_head.load_relaxed();
+    for (;;) {
+        const int64_t lag = static_cast<int64_t>(m_inject[pos & mask].sequence.load() - (pos + 1));
+        if (lag == 0) {
+            if (m_inject_head.compare_exchange(pos, pos + 1)) break;
+        } else if (lag < 0) {
+            return nullptr; // Empty, or the producer is still writing
+        } else {
+            pos = m_inject_head.load_relaxed();
+        }
+    }
+    InjectSlot& slot = m_inject[pos & mask];
+    Job* job = reinterpret_cast<Job*>(slot.job.load_relaxed());
+    slot.sequence.store(pos + mask + 1); // Free for the next lap
+    return job;
+} // take_injected
+
+// ------------------------------ Scheduling ----------------------------------
+
+void JobSystem::
+submit(Job* job) noexcept {
+    if (!m_running.load()) { // Not started, or stopping
+        execute(current_worker(), job);
+        return;
+    }
+    Worker* self = current_worker();
+    const bool queued = self ? detail::deque_push(*self, job) : inject(job);
+    if (!queued) {
+        detail::bump(m_inlined);
+        execute(self, job);
+        return;
+    }
+    if (!self) (void)m_injected.fetch_add(1);
+    wake_one();
+} // submit
+
+void JobSystem::
+wake_one() noexcept {
+    // Pairs with `idle()`: either it sees our job, or we see its flag. A
+    // spinning worker will find the job by itself and wake the next one
+    atomic_fence();
+    if (m_spinning.load() || !m_sleeping.load()) return;
+    for (unsigned i = 1; i < m_worker_count; ++i) {
+        Worker& w = m_workers[i];
+        if (w.sleeping.load_relaxed() && w.sleeping.exchange(0)) {
+            m_sleeping.fetch_add(static_cast<uint32_t>(-1));
+            w.wake.set();
+            return;
+        }
+    }
+} // wake_one
+
+JobSystem::Job* JobSystem::
+find_job(Worker* self) noexcept {
+    if (self)
+        if (Job* job = detail::deque_pop(*self)) return job;
+    if (Job* job = take_injected()) return job;
+
+    // Start at a random victim so thieves spread out
+    const unsigned count = m_worker_count;
+    const unsigned first = self ? detail::next_random(self->rng) % count : 0;
+    for (unsigned i = 0; i < count; ++i) {
+        Worker& victim = m_workers[(first + i) % count];
+        if (&victim == self) continue;
+        if (Job* job = detail::deque_steal(victim)) {
+            if (self) detail::bump(self->stolen);
+            return job;
+        }
+    }
+    return nullptr;
+} // find_job
+
+bool JobSystem::
+has_work() const noexcept {
+    if (m_inject_tail.load() != m_inject_head.load()) return true;
+    for (unsigned i = 0; i < m_worker_count; ++i)
+        if (m_workers[i].bottom.load() > m_workers[i].top.load()) return true;
+    return false;
+} // has_work
+
+void JobSystem::
+execute(Worker* self, Job* job) noexcept {
+    Job local = *job;
+    detail::JobPool{}.free(job);
+
+    if (local.task) {
+        local.task(local.context);
+    } else {
+        // Lazy binary splitting: halves go to the deque, thieves take the
+        // biggest ones first since they are the oldest
+        while (local.end - local.begin > local.grain) {
+            Job* half = detail::JobPool{}.alloc();
+            if (!half) break; // Do the rest here
+            *half = local;
+            half->begin = local.begin + (local.end - local.begin) / 2;
+            local.end = half->begin;
+            (void)local.group->m_pending.fetch_add(1);
+            submit(half);
+        }
+        local.range(local.context, local.begin, local.end);
+    }
+    if (self) detail::bump(self->executed);
+    local.group->finish();
+} // execute
+
+bool JobSystem::
+help() noexcept {
+    if (!m_running.load()) return false;
+    Worker* self = current_worker();
+    Job* job = find_job(self);
+    if (!job) return false;
+    execute(self, job);
+    return true;
+} // help
+
+void JobSystem::
+idle(Worker& self) noexcept {
+    (void)m_sleeping.fetch_add(1);
+    (void)self.sleeping.exchange(1);
+    if (!m_running.load() || has_work()) {
+        if (self.sleeping.exchange(0)) m_sleeping.fetch_add(static_cast<uint32_t>(-1));
+        else self.wake.wait(); // A waker took the flag, its `set()` is on the way
+        return;
+    }
+    detail::bump(self.sleeps);
+    self.wake.wait();
+} // idle
+
+void JobSystem::
+work(Worker& self) noexcept {
+    uint64_t idle_since = 0; // 0 while busy, otherwise counted in `m_spinning`
+    for (;;) {
+        if (Job* job = find_job(&self)) {
+            // The last spinner to find work wakes a sleeper, more may be queued
+            if (idle_since && m_spinning.fetch_add(static_cast<uint32_t>(-1)) == 1) wake_one();
+            idle_since = 0;
+            execute(&self, job);
+            continue;
+        }
+        if (!m_running.load()) {
+            if (idle_since) (void)m_spinning.fetch_add(static_cast<uint32_t>(-1));
+            return;
+        }
+
+        const uint64_t now = get_monotonic_ns();
+        if (!idle_since) {
+            idle_since = now;
+            (void)m_spinning.fetch_add(1);
+        }
+        if (now - idle_since < m_config.spin_ns) {
+            for (unsigned i = 0; i < 32; ++i) cpu_relax();
+            continue;
+        }
+        (void)m_spinning.fetch_add(static_cast<uint32_t>(-1));
+        idle(self);
+        idle_since = 0;
+    }
+} // work
+
+void JobSystem::
+worker_main(void* worker) noexcept {
+    Worker& self = *static_cast<Worker*>(worker);
+    t_current = &self;
+    self.system->work(self);
+    t_current = nullptr;
+    pool_flush_thread();
+} // worker_main
+
+// ------------------------------ Task Group ----------------------------------
+
+void TaskGroup::
+run(TaskProc proc, void* context) noexcept {
+    JobSystem::Job* job = detail::JobPool{}.alloc();
+    if (!job) { // Out of memory: no parallelism, same result
+        proc(context);
+        return;
+    }
+    *job = JobSystem::Job{ proc, nullptr, context, this, 0, 1, 1 };
+    (void)m_pending.fetch_add(1);
+    m_jobs->submit(job);
+} // run
+
+void TaskGroup::
+run_range(uint32_t begin, uint32_t end, uint32_t grain, RangeProc proc, void* context) noexcept {
+    if (begin >= end) return;
+    JobSystem::Job* job = detail::JobPool{}.alloc();
+    if (!job) {
+        proc(context, begin, end);
+        return;
+    }
+    *job = JobSystem::Job{ nullptr, proc, context, this, begin, end, grain ? grain : 1 };
+    (void)m_pending.fetch_add(1);
+    m_jobs->submit(job);
+} // run_range
+
+void TaskGroup::
+finish() noexcept {
+    for (uint32_t count = m_pending.load();;) {
+        // Nobody else holds a reference: `m_then` was written before the
+        // owner's was released, and nothing can add jobs any more
+        if (count == 1 && m_then) {
+            const TaskProc proc = m_then;
+            m_then = nullptr;
+            JobSystem::Job* job = detail::JobPool{}.alloc();
+            if (job) { // Our reference becomes the continuation's
+                *job = JobSystem::Job{ proc, nullptr, m_then_context, this, 0, 1, 1 };
+                m_jobs->submit(job);
+                return;
+            }
+            proc(m_then_context);
+            continue;
+        }
+        if (m_pending.compare_exchange(count, count - 1)) return;
+    }
+} // finish
+
+void TaskGroup::
+wait() noexcept {
+    if (!m_sealed) finish(); // The owner's reference
+    // Help while there is anything to run, otherwise back off
+    for (uint64_t idle_since = 0; m_pending.load() != 0;) {
+        if (m_jobs->help()) {
+            idle_since = 0;
+            continue;
+        }
+        const uint64_t now = get_monotonic_ns();
+        if (!idle_since) idle_since = now;
+        if (now - idle_since < m_jobs->config().spin_ns) cpu_relax();
+        else yield_thread(); // The last jobs run elsewhere, maybe on this core
+    }
+    m_pending.store(1);
+    m_sealed = false;
+} // wait
+
+void TaskGroup::
+then(TaskProc proc, void* context) noexcept {
+    m_then = proc;
+    m_then_context = context;
+    m_sealed = true;
+    finish();
+} // then
+
+void
+parallel_for(JobSystem& jobs, uint32_t begin, uint32_t end, uint32_t grain,
+             RangeProc proc, void* context) noexcept {
+    TaskGroup group{ jobs };
+    group.run_range(begin, end, grain, proc, context);
+    group.wait();
+} // parallel_for
+
+} // namespace la
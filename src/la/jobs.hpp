@@ -0,0 +1,169 @@
+#ifndef __LA_JOBS_HEADER_GUARD
+#define __LA_JOBS_HEADER_GUARD
+
+#include "la.hpp"
+
+/*
+    Work-stealing job system. Every worker thread owns a Chase-Lev deque:
+    it pushes and pops its own jobs at the bottom, idle workers steal the
+    oldest from the top. Threads outside the system (the render thread, a
+    loader) submit through a shared injection queue instead. The thread that
+    calls `start()` is worker 0 and runs jobs whenever it waits.
+
+        la::JobSystem jobs;   // One worker per physical core
+        (void)jobs.start();
+
+        // Fork-join, e.g. in `on_render_software()`: 64-row bands of the frame
+        la::parallel_for(jobs, 0, h, 64, [](void* c, uint32_t y0, uint32_t y1) noexcept {
+            ... // Rows [y0, y1)
+        }, &frame);
+
+        // Asset loading: decode in the background, one upload once all are in
+        la::TaskGroup loads{ jobs };
+        for (Asset& asset : assets) loads.run(&decode, &asset);
+        loads.then(&assets_ready, &assets); // Doesn't block
+        ...
+        if (loads.done()) upload(assets);   // Next frames
+
+    A `TaskGroup` counts its unfinished jobs; that counter is the dependency:
+    `wait()` helps until it reaches zero, `then()` runs a continuation when it
+    does. Jobs may add jobs to their own group. Waiting helps with any queued
+    job, so keep jobs short: split long I/O and decoding into pieces.
+*/
+
+namespace la {
+
+LA_CONSTEXPR_VAR unsigned MAX_JOB_WORKERS = 64;
+
+using TaskProc = void (*)(void* context) noexcept;
+// Items [begin, end) of a `parallel_for`
+using RangeProc = void (*)(void* context, uint32_t begin, uint32_t end) noexcept;
+
+struct TaskGroup;
+
+// --------------------------- Job System -------------------------------------
+
+struct JobSystem {
+    struct Config {
+        unsigned workers{ 0 };            // Threads, worker 0 included. 0: one per physical core, at least 2
+        unsigned deque_capacity{ 4096 };  // Jobs per worker, a power of two. Jobs past it run inline
+        unsigned inject_capacity{ 1024 }; // Shared queue, a power of two
+        uint64_t spin_ns{ 50000 };        // Idle workers spin this long before they sleep
+    }; // struct Config
+
+    // Sums over the workers
+    struct Stats {
+        uint64_t executed{ 0 };
+        uint64_t stolen{ 0 };      // Taken from another worker's deque
+        uint64_t injected{ 0 };    // Submitted by threads outside the system
+        uint64_t inlined{ 0 };     // Queue full, run by the submitting thread
+        uint64_t sleeps{ 0 };
+    }; // struct Stats
+
+    explicit inline JobSystem() noexcept : JobSystem{ Config{} } {}
+    explicit JobSystem(const Config& config) noexcept;
+    inline ~JobSystem() noexcept { stop(); }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Spawn the workers, the calling thread becomes worker 0. False when out of
+    // memory; jobs then run inline on the submitting thread
+    LA_NO_DISCARD bool start() noexcept;
+    // Run what is still queued, then join the workers. From worker 0's thread
+    void stop() noexcept;
+
+    // Run one queued job on the calling thread, false when there was none.
+    // For loops that poll instead of waiting on a group
+    bool help() noexcept;
+
+    LA_NO_DISCARD unsigned worker_count() const noexcept { return m_worker_count; }
+    // The calling thread's worker, -1 outside this system
+    LA_NO_DISCARD int worker_index() const noexcept;
+    LA_NO_DISCARD Stats stats() const noexcept;
+    LA_NO_DISCARD const Config& config() const noexcept { return m_config; }
+
+    // Defined in jobs.cpp
+    struct Job;
+    struct Worker;
+    struct InjectSlot;
+
+private:
+    friend struct TaskGroup;
+
+    void submit(Job* job) noexcept;
+    void execute(Worker* self, Job* job) noexcept;
+    LA_NO_DISCARD Job* find_job(Worker* self) noexcept;
+    LA_NO_DISCARD Worker* current_worker() const noexcept;
+    void wake_one() noexcept;
+    void work(Worker& self) noexcept;
+    void idle(Worker& self) noexcept;
+    LA_NO_DISCARD bool has_work() const noexcept;
+    static void worker_main(void* worker) noexcept;
+
+    // Bounded multi-producer multi-consumer ring (Vyukov)
+    LA_NO_DISCARD bool inject(Job* job) noexcept;
+    LA_NO_DISCARD Job* take_injected() noexcept;
+
+    static thread_local Worker* t_current; // Of whichever system the thread works for
+
+    Config m_config;
+    void* m_block{ nullptr }; // Workers, injection slots and deques in one allocation
+    size_t m_block_bytes{ 0 };
+    Worker* m_workers{ nullptr };
+    unsigned m_worker_count{ 0 };
+    InjectSlot* m_inject{ nullptr };
+    alignas(64) Atomic<uint64_t> m_inject_head{ 0 };
+    alignas(64) Atomic<uint64_t> m_inject_tail{ 0 };
+    alignas(64) Atomic<uint32_t> m_sleeping{ 0 }; // Workers asleep or about to be
+    Atomic<uint32_t> m_spinning{ 0 }; // Idle workers still looking for jobs
+    Atomic<uint32_t> m_running{ 0 };
+    Atomic<uint64_t> m_injected{ 0 };
+    Atomic<uint64_t> m_inlined{ 0 };
+}; // struct JobSystem
+
+// --------------------------- Task Group -------------------------------------
+
+/// Jobs that finish together. Created, waited on and polled by one thread
+struct TaskGroup {
+    explicit TaskGroup(JobSystem& jobs) noexcept : m_jobs{ &jobs } {}
+    inline ~TaskGroup() noexcept { wait(); }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    // Queue `proc(context)`. From the owner, or from this group's own jobs
+    void run(TaskProc proc, void* context) noexcept;
+    // `proc` over [begin, end) in pieces of at most `grain` items. The range
+    // splits in halves as workers steal it, not up front
+    void run_range(uint32_t begin, uint32_t end, uint32_t grain, RangeProc proc, void* context) noexcept;
+
+    // Help run jobs until the group's are finished. The group is reusable after
+    void wait() noexcept;
+    // `proc(context)` runs as the group's last job once the others finish, without
+    // blocking the caller. Only the group's jobs may add to it afterwards
+    void then(TaskProc proc, void* context) noexcept;
+    // After `then()`: the continuation finished
+    LA_NO_DISCARD bool done() const noexcept { return m_pending.load() == 0; }
+
+private:
+    friend struct JobSystem;
+
+    // One reference less. The last one starts the continuation, if any
+    void finish() noexcept;
+
+    JobSystem* m_jobs;
+    // Unfinished jobs, plus the owner's reference until `wait()` or `then()`
+    Atomic<uint32_t> m_pending{ 1 };
+    TaskProc m_then{ nullptr };
+    void* m_then_context{ nullptr };
+    bool m_sealed{ false }; // `then()` released the owner's reference
+}; // struct TaskGroup
+
+// Fork-join: returns once `proc` covered [begin, end), the caller helps meanwhile
+void parallel_for(JobSystem& jobs, uint32_t begin, uint32_t end, uint32_t grain,
+                  RangeProc proc, void* context) noexcept;
+
+} // namespace la
+
+#endif // __LA_JOBS_HEADER_GUARD
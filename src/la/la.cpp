@@ -12,6 +12,14 @@ extern "C" void* __cdecl memset(void* dest, int ch, size_t count) {
     while (count--) *p++ = static_cast<unsigned char>(ch);
     return dest;
 }
+
+// Emitted for row copies (blits) just like `memset` is for fills
+extern "C" void* __cdecl memcpy(void* dest, const void* src, size_t count) {
+    unsigned char* d = static_cast<unsigned char*>(dest);
+    const unsigned char* s = static_cast<const unsigned char*>(src);
+    while (count--) *d++ = *s++;
+    return dest;
+}
 #endif
 
 // ------------------------------- INCLUDES -----------------------------------
@@ -44,14 +52,13 @@ LA_CONSTEXPR_VAR wchar_t WINDOW_CLASSNAME[] { L"_" };
 LA_CONSTEXPR_VAR LPCSTR DUMMY_CLASS_NAME{ "d" };
 LA_CONSTEXPR_VAR unsigned DRAW_COLOR_MODE = 4; // ARGB
 
-LA_CONSTEXPR_VAR unsigned char KEY_ARRAY_SIZE = static_cast<unsigned char>(::la::Key::__LAST__);
-unsigned char key_array[KEY_ARRAY_SIZE]{ 0 };
 
 namespace la {
     Simd::AddFloat  add_float = nullptr;
     Simd::AddInt32  add_int32 = nullptr;
     Simd::FillFloat fill_float = nullptr;
     Simd::FillInt32 fill_int32 = nullptr;
+    Simd::BlendArgb32 blend_argb32 = nullptr;
 
     void GlobalInitializer::init() noexcept {
         volatile GlobalInitializer _ {
@@ -268,12 +275,78 @@ namespace la {
         }
         detail::scalar_tail_unrolled(out + i, value, count - i);
     } // AVX2: int, 8
+
+    // ----------------------------- Blend ------------------------------------
+
+    // SSE2: 4 pixels, two per 16-bit register
+    void Simd::blend_t<4>::apply(uint32_t* LA_RESTRICT dst, const uint32_t* LA_RESTRICT src,
+                                 uint32_t opacity, size_t count) noexcept {
+        using reg = __m128i;
+        const reg zero = _mm_setzero_si128();
+        const reg bias = _mm_set1_epi16(128);
+        const reg full = _mm_set1_epi16(255);
+        const reg op   = _mm_set1_epi16(static_cast<short>(opacity));
+
+        // x * a / 255 on 16-bit lanes, same rounding as `mul_div255`
+        auto mul_div255 = [&](reg x, reg a) noexcept {
+            reg t = _mm_add_epi16(_mm_mullo_epi16(x, a), bias);
+            return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+        };
+        auto blend_half = [&](reg s, reg d) noexcept {
+            s = mul_div255(s, op);
+            // Broadcast alpha (lane 3 of every pixel) and invert it
+            reg a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)),
+                                        _MM_SHUFFLE(3, 3, 3, 3));
+            return _mm_add_epi16(s, mul_div255(d, _mm_sub_epi16(full, a)));
+        };
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            reg s = _mm_loadu_si128((const __m128i*)(src + i));
+            reg d = _mm_loadu_si128((const __m128i*)(dst + i));
+            reg lo = blend_half(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero));
+            reg hi = blend_half(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+        }
+        blend_t<1>::apply(dst + i, src + i, opacity, count - i);
+    } // SSE2: 4 pixels
+
+    // AVX2: 8 pixels, unpack/pack work per 128-bit lane so pixel order is kept
+    void Simd::blend_t<8>::apply(uint32_t* LA_RESTRICT dst, const uint32_t* LA_RESTRICT src,
+                                 uint32_t opacity, size_t count) noexcept {
+        using reg = __m256i;
+        const reg zero = _mm256_setzero_si256();
+        const reg bias = _mm256_set1_epi16(128);
+        const reg full = _mm256_set1_epi16(255);
+        const reg op   = _mm256_set1_epi16(static_cast<short>(opacity));
+
+        auto mul_div255 = [&](reg x, reg a) noexcept {
+            reg t = _mm256_add_epi16(_mm256_mullo_epi16(x, a), bias);
+            return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+        };
+        auto blend_half = [&](reg s, reg d) noexcept {
+            s = mul_div255(s, op);
+            reg a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)),
+                                           _MM_SHUFFLE(3, 3, 3, 3));
+            return _mm256_add_epi16(s, mul_div255(d, _mm256_sub_epi16(full, a)));
+        };
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            reg s = _mm256_loadu_si256((const __m256i*)(src + i));
+            reg d = _mm256_loadu_si256((const __m256i*)(dst + i));
+            reg lo = blend_half(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero));
+            reg hi = blend_half(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero));
+            _mm256_storeu_si256((__m256i*)(dst + i), _mm256_packus_epi16(lo, hi));
+        }
+        blend_t<4>::apply(dst + i, src + i, opacity, count - i);
+    } // AVX2: 8 pixels
 } // namespace la
 
 // ---------------------------- Native Declarations ---------------------------
 
     LA_NO_DISCARD ::la::AboutError
-create_gl_context(HDC main_dc) noexcept;
+create_gl_context(HDC main_dc, HGLRC& out_context) noexcept;
 
     static LRESULT CALLBACK
 win_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam) noexcept;
@@ -282,15 +355,33 @@ win_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam) noexcept;
 
 #if defined(LA_NOSTD) && defined(_MSC_VER) // Hacks for MSVC
 extern "C" int _fltused = 0;
-void __cdecl operator delete(void* ptr, unsigned int size) {
-    ::la::panic_process(::la::what(::la::AboutError::Win32_Freestanding_DeleteOperatorCalled), -1);
-}
+// `operator new`/`delete` live in pool.cpp, on top of `la::heap_alloc()`
 
-#if defined(_M_X64) || defined(_M_ARM64) // Exclusive for 64-bit targets
-void __cdecl operator delete(void* ptr, size_t size) {
-    ::la::panic_process(::la::what(::la::AboutError::Win32_Freestanding_DeleteOperatorCalled), -1);
-}
-#endif // 64-bit
+// `thread_local` needs the TLS directory the CRT normally links in (tlssup.obj)
+extern "C" {
+ULONG _tls_index = 0;
+
+#pragma data_seg(".tls")
+char _tls_start = 0;
+#pragma data_seg(".tls$ZZZ")
+char _tls_end = 0;
+#pragma data_seg()
+
+#pragma section(".CRT$XLA", long, read)
+#pragma section(".CRT$XLZ", long, read)
+__declspec(allocate(".CRT$XLA")) PIMAGE_TLS_CALLBACK __xl_a = nullptr;
+__declspec(allocate(".CRT$XLZ")) PIMAGE_TLS_CALLBACK __xl_z = nullptr;
+
+#pragma section(".rdata$T", long, read)
+__declspec(allocate(".rdata$T")) extern const IMAGE_TLS_DIRECTORY _tls_used = {
+    reinterpret_cast<ULONG_PTR>(&_tls_start),
+    reinterpret_cast<ULONG_PTR>(&_tls_end),
+    reinterpret_cast<ULONG_PTR>(&_tls_index),
+    reinterpret_cast<ULONG_PTR>(&__xl_a + 1),
+    0, // SizeOfZeroFill
+    0, // Characteristics
+};
+} // extern "C"
 #endif // LA_NOSTD && _MSC_VER
 
 // ---------------------------- OpenGL Loader ---------------------------------
@@ -413,8 +504,11 @@ public:
                              /* hbrBackground */ nullptr,
                              /*  lpszMenuName */ nullptr,
                              /* lpszClassName */ DUMMY_CLASS_NAME };
-        if (!RegisterClassA(&win_class))
+        // Classes are per process: the first dummy on any thread registers it
+        if (!RegisterClassA(&win_class) && GetLastError() != ERROR_CLASS_ALREADY_EXISTS) {
+            m_histance = nullptr;
             return;
+        }
 
         m_hwnd = CreateWindowExA( /*    dwExStyle */ 0,
                                   /*  lpClassName */ DUMMY_CLASS_NAME,
@@ -434,6 +528,18 @@ public:
         m_hdc = GetDC(m_hwnd);
     } // constructor 
 
+    inline ~DummyWindow() noexcept {
+        if (m_ctx) {
+            if (wglGetCurrentContext() == m_ctx) wglMakeCurrent(nullptr, nullptr);
+            wglDeleteContext(m_ctx);
+        }
+        if (m_hdc)  ReleaseDC(m_hwnd, m_hdc);
+        if (m_hwnd) DestroyWindow(m_hwnd);
+    } // destructor
+
+    DummyWindow(const DummyWindow&) = delete;
+    DummyWindow& operator=(const DummyWindow&) = delete;
+
     // Getters
 
     LA_NO_DISCARD inline HINSTANCE histance() const noexcept { return m_histance; }
@@ -537,17 +643,96 @@ has_avx512bw() noexcept {
 // --------------------------- Allocate/Free ---------------------------
 void*
 alloc(size_t size) noexcept {
-    return VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
-}
+    void* ptr = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (ptr) detail::telemetry_alloc(detail::current_alloc_tag(), size);
+    return ptr;
+} // alloc
 
 void
-free(void* ptr, size_t /* size */) noexcept { VirtualFree(ptr, 0, MEM_RELEASE); }
+free(void* ptr, size_t size) noexcept {
+    if (!ptr) return;
+    detail::telemetry_free(detail::current_alloc_tag(), size);
+    VirtualFree(ptr, 0, MEM_RELEASE);
+} // free
+
+// Large pages need SeLockMemoryPrivilege ("Lock pages in memory"), granted to few
+// accounts and disabled in the token until enabled. Tried once, a lost race just
+// tries twice
+static Atomic<uint32_t> g_large_pages{ 0 }; // 0 untried, 1 usable, 2 unavailable
+
+LA_NO_DISCARD static bool
+large_pages_usable() noexcept {
+    uint32_t state = g_large_pages.load_relaxed();
+    if (state) return state == 1;
+
+    state = 2;
+    HANDLE token = nullptr;
+    if (GetLargePageMinimum() &&
+        OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) {
+        TOKEN_PRIVILEGES privileges{};
+        privileges.PrivilegeCount = 1;
+        privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+        // Succeeds with ERROR_NOT_ALL_ASSIGNED when the account lacks the privilege
+        if (LookupPrivilegeValueW(nullptr, L"SeLockMemoryPrivilege", &privileges.Privileges[0].Luid) &&
+            AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr) &&
+            GetLastError() == ERROR_SUCCESS)
+            state = 1;
+        CloseHandle(token);
+    }
+    g_large_pages.store_relaxed(state);
+    return state == 1;
+} // large_pages_usable
+
+size_t
+get_large_page_size() noexcept {
+    return large_pages_usable() ? GetLargePageMinimum() : 0;
+} // get_large_page_size
+
+// One write per page commits it now, the values stay zero
+static void
+touch_pages(void* ptr, size_t size) noexcept {
+    volatile unsigned char* bytes = static_cast<volatile unsigned char*>(ptr);
+    for (size_t at = 0; at < size; at += 4096) bytes[at] = 0;
+} // touch_pages
+
+void*
+alloc(size_t size, uint32_t flags, int numa_node) noexcept {
+    const DWORD node = (flags & ALLOC_NUMA_NODE) && numa_node >= 0 ?
+                       static_cast<DWORD>(numa_node) : NUMA_NO_PREFERRED_NODE;
+
+    // Large pages are always resident and locked, and come in whole pages only
+    if (flags & ALLOC_LARGE_PAGES) {
+        const size_t large = get_large_page_size();
+        if (large && size >= large) {
+            const size_t rounded = (size + large - 1) & ~(large - 1);
+            if (void* ptr = VirtualAllocExNuma(GetCurrentProcess(), nullptr, rounded,
+                    MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES, PAGE_READWRITE, node)) {
+                detail::telemetry_alloc(detail::current_alloc_tag(), size);
+                return ptr;
+            }
+            // Physical memory too fragmented for contiguous large pages, use small ones
+        }
+    }
+
+    void* ptr = VirtualAllocExNuma(GetCurrentProcess(), nullptr, size,
+                                   MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE, node);
+    if (!ptr) return nullptr;
+    // Locking faults the pages in too. Bounded by the working-set minimum
+    const bool locked = (flags & ALLOC_LOCK) && VirtualLock(ptr, size);
+    if ((flags & ALLOC_POPULATE) && !locked)
+        touch_pages(ptr, size);
+    detail::telemetry_alloc(detail::current_alloc_tag(), size);
+    return ptr;
+} // alloc
 
 // --------------------------- Processing ---------------------------
 
 void
 exit_process(int error_code) noexcept { ExitProcess(error_code); }
 
+uint32_t
+get_thread_id() noexcept { return static_cast<uint32_t>(GetCurrentThreadId()); }
+
 void
 panic_process(const char* explain_msg, int error_code) noexcept {
     ::la::Out out;
@@ -561,6 +746,43 @@ panic_process(const char* explain_msg, int error_code) noexcept {
 void
 sleep(unsigned ms) noexcept { Sleep(ms); }
 
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#   define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002 // Windows 10 1803 SDK
+#endif
+
+// `Sleep` rounds up to the timer tick (up to 15.6 ms). High-resolution waitable
+// timers wake within ~0.5 ms without raising the system-wide timer resolution.
+// One timer per thread, kept until the process exits
+static thread_local HANDLE t_sleep_timer = nullptr;
+
+// Arms the calling thread's timer `ns` from now, null when there is no timer
+LA_NO_DISCARD static HANDLE
+arm_sleep_timer(uint64_t ns) noexcept {
+    if (!t_sleep_timer) {
+        t_sleep_timer = CreateWaitableTimerExW(nullptr, nullptr,
+            CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (!t_sleep_timer) // Older systems, tick resolution
+            t_sleep_timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+        if (!t_sleep_timer)
+            return nullptr;
+    }
+
+    LARGE_INTEGER due; // Negative: relative, in 100 ns units
+    due.QuadPart = -static_cast<LONGLONG>((ns + 99) / 100);
+    return SetWaitableTimer(t_sleep_timer, &due, 0, nullptr, nullptr, FALSE) ? t_sleep_timer : nullptr;
+} // arm_sleep_timer
+
+void native::
+sleep_until(uint64_t deadline_ns) noexcept {
+    const uint64_t now = ::la::get_monotonic_ns();
+    if (now >= deadline_ns) return;
+
+    if (HANDLE timer = arm_sleep_timer(deadline_ns - now))
+        WaitForSingleObject(timer, INFINITE);
+    else
+        Sleep(static_cast<DWORD>((deadline_ns - now + 999999) / 1000000));
+} // sleep_until
+
 double get_monotonic_secs() noexcept {
     static LARGE_INTEGER frequency = [] {
         LARGE_INTEGER freq;
@@ -574,6 +796,86 @@ double get_monotonic_secs() noexcept {
     return static_cast<double>(counter.QuadPart) / static_cast<double>(frequency.QuadPart);
 }
 
+uint64_t
+get_monotonic_ns() noexcept {
+    // Racing first calls store the same values. Usually 10 MHz: one multiply
+    static uint64_t frequency = 0, ns_per_tick = 0;
+    if (!frequency) {
+        LARGE_INTEGER freq;
+        QueryPerformanceFrequency(&freq);
+        ns_per_tick = 1000000000ull % freq.QuadPart == 0 ? 1000000000ull / freq.QuadPart : 0;
+        frequency = static_cast<uint64_t>(freq.QuadPart);
+    }
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    const uint64_t ticks = static_cast<uint64_t>(counter.QuadPart);
+    if (ns_per_tick)
+        return ticks * ns_per_tick;
+    // Split so `ticks * 1e9` can't overflow
+    return ticks / frequency * 1000000000ull + ticks % frequency * 1000000000ull / frequency;
+} // get_monotonic_ns
+
+void
+cpu_relax() noexcept { YieldProcessor(); }
+
+void
+yield_thread() noexcept { (void)SwitchToThread(); }
+
+// --------------------------- Performance Counters ---------------------------
+
+// No user-mode counter API without a driver, every sample is empty
+bool
+PerfCounters::open() noexcept { return false; }
+
+void
+PerfCounters::close() noexcept {}
+
+PerfSample
+PerfCounters::read() const noexcept { return PerfSample{}; }
+
+// --------------------------- Threads ---------------------------
+
+struct ThreadEntry {
+    static DWORD WINAPI run(LPVOID thread) noexcept {
+        Thread& t = *static_cast<Thread*>(thread);
+        t.m_proc(t.m_arg);
+        return 0;
+    }
+}; // struct ThreadEntry
+
+bool Thread::
+start(Proc proc, void* arg) noexcept {
+    if (m_handle) return false;
+    m_proc = proc;
+    m_arg = arg;
+    // `CreateThread`, not `_beginthreadex`: freestanding builds have no CRT to set up
+    HANDLE thread = CreateThread(nullptr, 0, &ThreadEntry::run, this, 0, nullptr);
+    m_handle = reinterpret_cast<uintptr_t>(thread);
+    return thread != nullptr;
+} // start
+
+void Thread::
+join() noexcept {
+    if (!m_handle) return;
+    HANDLE thread = reinterpret_cast<HANDLE>(m_handle);
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+    m_handle = 0;
+} // join
+
+Signal::
+Signal() noexcept : m_event{ CreateEventW(nullptr, FALSE, FALSE, nullptr) } {}
+
+Signal::
+~Signal() noexcept { if (m_event) CloseHandle(reinterpret_cast<HANDLE>(m_event)); }
+
+void Signal::
+set() noexcept { SetEvent(reinterpret_cast<HANDLE>(m_event)); }
+
+void Signal::
+wait() noexcept { WaitForSingleObject(reinterpret_cast<HANDLE>(m_event), INFINITE); }
+
 // --------------------------- Misc Functions ---------------------------
 
 bool
@@ -596,6 +898,82 @@ reset_workset() noexcept {
 #endif
 } // reset_workset
 
+size_t
+get_resident_bytes() noexcept {
+#ifdef _PSAPI_H_
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.WorkingSetSize;
+#endif
+    return 0;
+} // get_resident_bytes
+
+// Pages fully inside the range, none when it is smaller than one
+LA_NO_DISCARD static bool
+inner_pages(void* ptr, size_t size, uintptr_t& begin, uintptr_t& end) noexcept {
+    const uintptr_t page = 4096;
+    begin = (reinterpret_cast<uintptr_t>(ptr) + page - 1) & ~(page - 1);
+    end = (reinterpret_cast<uintptr_t>(ptr) + size) & ~(page - 1);
+    return begin < end;
+} // inner_pages
+
+void
+discard_pages(void* ptr, size_t size) noexcept {
+    uintptr_t begin, end;
+    if (!inner_pages(ptr, size, begin, end)) return;
+    // Still committed, the system may just not write the pages out any more
+    VirtualAlloc(reinterpret_cast<void*>(begin), end - begin, MEM_RESET, PAGE_READWRITE);
+} // discard_pages
+
+void
+page_out(void* ptr, size_t size) noexcept {
+    uintptr_t begin, end;
+    if (!inner_pages(ptr, size, begin, end)) return;
+    // Unlocking pages that aren't locked removes them from the working set
+    // (and fails with ERROR_NOT_LOCKED). Unlocks `ALLOC_LOCK` memory for good
+    VirtualUnlock(reinterpret_cast<void*>(begin), end - begin);
+} // page_out
+
+bool
+get_memory_stall(MemoryStall&) noexcept { return false; }
+
+CpuTopology
+get_cpu_topology() noexcept {
+    CpuTopology topology;
+    DWORD bytes = 0;
+    (void)GetLogicalProcessorInformationEx(RelationAll, nullptr, &bytes);
+    const size_t capacity = bytes;
+    unsigned char* buffer = capacity ? static_cast<unsigned char*>(::la::alloc(capacity)) : nullptr;
+    if (buffer && GetLogicalProcessorInformationEx(
+            RelationAll, reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer), &bytes)) {
+        // Variable-size records back to back
+        for (DWORD at = 0; at < bytes;) {
+            const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX& info =
+                *reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer + at);
+            switch (info.Relationship) {
+            case RelationProcessorCore:
+                ++topology.cores;
+                for (WORD group = 0; group < info.Processor.GroupCount; ++group)
+                    for (KAFFINITY mask = info.Processor.GroupMask[group].Mask; mask; mask &= mask - 1)
+                        ++topology.logical;
+                break;
+            case RelationProcessorPackage: ++topology.packages; break;
+            case RelationNumaNode:         ++topology.numa_nodes; break;
+            default: break;
+            }
+            at += info.Size;
+        }
+    }
+    if (buffer) ::la::free(buffer, capacity);
+
+    if (!topology.logical) topology.logical = GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+    if (!topology.logical) topology.logical = 1;
+    if (!topology.cores) topology.cores = topology.logical;
+    if (!topology.packages) topology.packages = 1;
+    if (!topology.numa_nodes) topology.numa_nodes = 1;
+    return topology;
+} // get_cpu_topology
+
 // --------------------------- Input/Output ---------------------------
 
 // TODO: I don't like this mess
@@ -623,13 +1001,72 @@ void print(const char* msg, size_t msg_length) noexcept {
 #endif // LA_CONSOLE
 } // print
 
+bool
+write_file(const char* path, const void* data, size_t size) noexcept {
+    HANDLE file = CreateFileA(path, GENERIC_WRITE, 0, nullptr,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    // `WriteFile` takes 32-bit sizes
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    bool ok = true;
+    while (ok && size) {
+        const DWORD chunk = size > 0x40000000 ? 0x40000000 : static_cast<DWORD>(size);
+        DWORD written = 0;
+        ok = WriteFile(file, bytes, chunk, &written, nullptr) && written == chunk;
+        bytes += written;
+        size -= written;
+    }
+    CloseHandle(file);
+    return ok;
+} // write_file
+
+void*
+read_file(const char* path, size_t* size) noexcept {
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return nullptr;
+
+    LARGE_INTEGER file_size;
+    void* data = nullptr;
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0 &&
+        static_cast<uint64_t>(file_size.QuadPart) <= static_cast<size_t>(-1)) {
+        const size_t total = static_cast<size_t>(file_size.QuadPart);
+        data = ::la::alloc(total);
+
+        unsigned char* bytes = static_cast<unsigned char*>(data);
+        size_t left = data ? total : 0;
+        while (left) {
+            const DWORD chunk = left > 0x40000000 ? 0x40000000 : static_cast<DWORD>(left);
+            DWORD read = 0;
+            if (!ReadFile(file, bytes, chunk, &read, nullptr) || read == 0) {
+                ::la::free(data, total);
+                data = nullptr;
+                break;
+            }
+            bytes += read;
+            left -= read;
+        }
+        if (data) *size = total;
+    }
+    CloseHandle(file);
+    return data;
+} // read_file
+
 // --------------------------- Native Window ---------------------------
 
 native::Window::
 ~Window() noexcept {
     if (hdc)  ReleaseDC(reinterpret_cast<HWND>(hwnd), 
                         reinterpret_cast<HDC>(hdc));
-    if (hwnd) DestroyWindow(reinterpret_cast<HWND>(hwnd));
+    if (hwnd) {
+        // The owning `la::Window` is mid-destruction, `win_proc()` must not reach it
+        SetWindowLongPtrW(reinterpret_cast<HWND>(hwnd), GWLP_USERDATA, 0);
+        DestroyWindow(reinterpret_cast<HWND>(hwnd));
+    }
+    if (wake_event) CloseHandle(reinterpret_cast<HANDLE>(wake_event));
 
 #ifdef LA_DEBUG_DESTRUCTORS
     out << "~Window" << endl;
@@ -637,60 +1074,89 @@ native::Window::
 }
 
 // --------------------------- Native Framebuffer ---------------------------
+
+// Grow by 1.5x so a live-resize drag reallocates O(log n) times, not per event
+LA_NO_DISCARD static inline int
+grow_capacity(int current, int wanted) noexcept {
+    if (wanted <= current) return current;
+    const int next = current + current / 2;
+    return next > wanted ? next : wanted;
+} // grow_capacity
+
 void native::Framebuffer::
 clear(uint32_t color, int win_width, int win_height) const noexcept {
+    LA_PROFILE_FUNCTION();
     if (!pixels) return;
 
-    const size_t pixel_count = win_width * win_height;
+    const int w = win_width < width ? win_width : width;
+    const int h = win_height < height ? win_height : height;
+    if (w <= 0 || h <= 0) return;
+
+    // Padding between rows is invisible, so one contiguous fill beats a per-row loop
+    const size_t pixel_count = static_cast<size_t>(stride) * (h - 1) + w;
     int32_t* out = reinterpret_cast<int32_t*>(pixels);
     int32_t fill = static_cast<int32_t>(color);
 
     ::la::fill_int32(out, fill, pixel_count); // Using the best found SIMD
 } // clear
 
-native::Framebuffer::
-~Framebuffer() noexcept {
+void native::Framebuffer::
+release() noexcept {
+    if (pixels) {
+        detail::telemetry_free(AllocTag::Framebuffer,
+                               static_cast<size_t>(stride) * capacity_height * 4);
+    }
     if (bmp) DeleteObject(reinterpret_cast<HBITMAP>(bmp));
     if (hdc) DeleteDC(reinterpret_cast<HDC>(hdc));
+    hdc = nullptr;
+    bmp = nullptr;
+    pixels = nullptr;
+    width = height = stride = capacity_height = 0;
+} // release
+
+native::Framebuffer::
+~Framebuffer() noexcept {
+    release();
 #ifdef LA_DEBUG_DESTRUCTORS
     out << "~Framebuffer" << endl;
 #endif
 } // ~Framebuffer
 
 LA_NO_DISCARD ::la::AboutError native::Framebuffer::
-recreate(
-    const ::la::Window& win, int width_, int height_) noexcept {
+resize(int width_, int height_) noexcept {
+    LA_PROFILE_FUNCTION();
 
-    // Free old resources
-    if (bmp) {
-        DeleteObject(reinterpret_cast<HBITMAP>(bmp));
-        bmp = nullptr;
-    }
-    if (hdc) {
-        DeleteDC(reinterpret_cast<HDC>(hdc));
-        hdc = nullptr;
+    // Reject invalid dimensions (e.g. minimized), keep the allocation for later
+    if (width_ <= 0 || height_ <= 0) {
+        width = height = 0;
+        return ::la::AboutError::None;
     }
 
-    // Reject invalid dimensions
-    if (width_ <= 0 || height_ <= 0)
-        return ::la::AboutError::None; // Exit without recreating
+    // Fits into the current DIB: only the visible size changes
+    if (pixels && width_ <= stride && height_ <= capacity_height) {
+        width = width_;
+        height = height_;
+        return ::la::AboutError::None;
+    }
 
-    // Create compatible DC
-    HDC device = GetDC(reinterpret_cast<HWND>(win.native().hwnd));
-    if (!device)
-        return ::la::AboutError::Win32_GetCurrentDC;
+    // Rows are padded to 8 pixels (32 bytes) so every row start suits AVX stores
+    const int new_stride = (grow_capacity(stride, width_) + 7) & ~7;
+    const int new_rows   = grow_capacity(capacity_height, height_);
 
-    hdc = CreateCompatibleDC(device);
-    ReleaseDC(reinterpret_cast<HWND>(win.native().hwnd), device);
+    // Free old resources
+    release();
 
+    // Memory DC for the screen, which every window is blitted to. A 32-bit DIB
+    // section doesn't depend on the DC it is selected into
+    hdc = CreateCompatibleDC(nullptr);
     if (!hdc)
         return ::la::AboutError::Win32_CreateCompatibleDc;
 
     // Prepare bitmap info (top-down DIB)
     BITMAPINFO bmi{};
     bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
-    bmi.bmiHeader.biWidth = width_;
-    bmi.bmiHeader.biHeight = -height_; // top-down
+    bmi.bmiHeader.biWidth = new_stride;
+    bmi.bmiHeader.biHeight = -new_rows; // top-down
     bmi.bmiHeader.biPlanes = 1;
     bmi.bmiHeader.biBitCount = 32;
     bmi.bmiHeader.biCompression = BI_RGB;
@@ -707,9 +1173,20 @@ recreate(
                       reinterpret_cast<HBITMAP>(bmp)))
         return ::la::AboutError::Win32_SelectObject;
 
+    // Pages are otherwise faulted in by the first clear, mid-frame
+    const size_t bytes = static_cast<size_t>(new_stride) * new_rows * 4;
+    const bool locked = (alloc_flags & ALLOC_LOCK) && VirtualLock(ppv_bits, bytes);
+    if ((alloc_flags & ALLOC_POPULATE) && !locked)
+        touch_pages(ppv_bits, bytes);
+
+    detail::telemetry_alloc(AllocTag::Framebuffer, bytes);
     pixels = ppv_bits;
+    width = width_;
+    height = height_;
+    stride = new_stride;
+    capacity_height = new_rows;
     return ::la::AboutError::None;
-} // recreate
+} // resize
 
 void native::Framebuffer::
 draw_pixel(int x, int y, int width, int height, uint32_t color) const noexcept {
@@ -717,8 +1194,8 @@ draw_pixel(int x, int y, int width, int height, uint32_t color) const noexcept {
     if (x < 0 || x >= width || y < 0 || y >= height || !pixels)
         return;
 
-    // Each pixel is 4 bytes (BGRA32)
-    const int pitch = width * 4;
+    // Each pixel is 4 bytes (BGRA32), rows are `stride` pixels apart
+    const int pitch = stride * 4;
     uint8_t* dst = static_cast<uint8_t*>(pixels);
     uint32_t* pixel_ptr = reinterpret_cast<uint32_t*>(dst + y * pitch + x * 4);
 
@@ -738,6 +1215,7 @@ native::OpenglContext::
     // Delete OpenGL rendering context
     if (ctx)
         wglDeleteContext(ctx);
+    hglrc = nullptr;
 
 #ifdef LA_DEBUG_DESTRUCTORS
     out << "~OpenglContext" << endl;
@@ -748,6 +1226,15 @@ native::OpenglContext::
 
 void native::
 render_software(const ::la::Window& win) noexcept {
+    if (!win.native().hwnd) return; // Closed by the user
+    if (win.is_render_threaded()) {
+        // No WM_PAINT to answer off the message thread: blit through the class DC
+        BitBlt(reinterpret_cast<HDC>(win.native().hdc), 0, 0, win.width(), win.height(),
+               reinterpret_cast<HDC>(win.fb().hdc), 0, 0, SRCCOPY);
+        GdiFlush(); // GDI batches calls per thread
+        return;
+    }
+
     HWND hwnd = reinterpret_cast<HWND>(win.native().hwnd);
     PAINTSTRUCT ps;
     BeginPaint(hwnd, &ps);
@@ -765,6 +1252,8 @@ render_software(const ::la::Window& win) noexcept {
 
     void native::
 render_opengl(const ::la::Window& win) noexcept {
+    if (win.is_render_threaded() || !win.native().hwnd) return; // `WM_PAINT` validated the window already
+
     HWND hwnd = reinterpret_cast<HWND>(win.native().hwnd);
     PAINTSTRUCT ps;
     BeginPaint(hwnd, &ps);
@@ -773,8 +1262,8 @@ render_opengl(const ::la::Window& win) noexcept {
 
     void native::
 on_geometry_change(::la::Window& win, int w, int h) noexcept {
-    win.m_width = w;
-    win.m_height = h;
+    LA_PROFILE_FUNCTION();
+    win.m_size.store(detail::pack_size(w, h));
 
     Error      error = Error::None;
     AboutError about = AboutError::None;
@@ -784,14 +1273,18 @@ on_geometry_change(::la::Window& win, int w, int h) noexcept {
     {
     case RendererApi::Software: {
         error = Error::CreateFramebuffer;
-        about = win.fb().recreate(win, w, h);
+        about = win.fb().resize(win, w, h);
         break;
     } // software
 
     case RendererApi::Opengl: {
-        ::la::sleep(7); // hack
-        error = Error::CreateOpenglContext;
-        about = create_gl_context(reinterpret_cast<HDC>(win.native().hdc));
+        // The context survives resizes, only the viewport follows the window
+        if (!win.gl().hglrc) {
+            HGLRC ctx{ nullptr };
+            error = Error::CreateOpenglContext;
+            about = create_gl_context(reinterpret_cast<HDC>(win.native().hdc), ctx);
+            win.gl().hglrc = reinterpret_cast<void*>(ctx);
+        }
 
         if (about == AboutError::None)
             gl::viewport(0, 0, w, h);
@@ -808,53 +1301,81 @@ on_geometry_change(::la::Window& win, int w, int h) noexcept {
         win.handler().on_error(error, about);
 
     win.handler().on_resize(w, h);
-    win.render();
 } // native::on_geometry_change
 
+    void native::
+request_geometry_change(::la::Window& win, int w, int h) noexcept {
+    // Only remember the latest size; `Window::render()` applies it once per frame,
+    // possibly on the render thread
+    win.m_pending_geometry.store(detail::pack_size(w, h));
+} // native::request_geometry_change
+
+    void native::
+make_context_current(const ::la::Window& win, bool current) noexcept {
+    if (win.renderer_api() != RendererApi::Opengl || !win.gl().hglrc || !win.native().hdc) return;
+    if (current) {
+        // Several GL windows on one thread take turns; a switch flushes, a no-op switch is skipped
+        if (wglGetCurrentContext() != reinterpret_cast<HGLRC>(win.gl().hglrc))
+            wglMakeCurrent(reinterpret_cast<HDC>(win.native().hdc), reinterpret_cast<HGLRC>(win.gl().hglrc));
+    }
+    else
+        wglMakeCurrent(nullptr, nullptr);
+} // native::make_context_current
+
 // --------------------------- Window ---------------------------
 
+// Window classes are per process, windows (and their messages) per thread:
+// the class is registered once, the quit message waits for the thread's last window
+static Atomic<uint32_t> g_window_class{ 0 };
+static thread_local uint32_t t_open_windows = 0;
+
+LA_NO_DISCARD static bool
+register_window_class() noexcept {
+    if (g_window_class.load()) return true;
+
+    WNDCLASS wc{};
+    wc.style = CS_OWNDC | CS_HREDRAW | CS_VREDRAW;
+    wc.lpfnWndProc = win_proc;
+    wc.hInstance = GetModuleHandleW(nullptr);
+    wc.lpszClassName = WINDOW_CLASSNAME;
+
+    // Two threads may race here, the loser finds the class already registered
+    if (!RegisterClassW(&wc) && GetLastError() != ERROR_CLASS_ALREADY_EXISTS)
+        return false;
+    g_window_class.store(1);
+    return true;
+} // register_window_class
+
+    void native::
+on_window_closed(::la::Window& win) noexcept {
+    // The OS window is gone: the render thread must not present to it anymore
+    win.stop_render_thread();
+    win.m_open.store(0);
+
+    // The handles die with this WM_DESTROY: nothing, `~Window()` included, may
+    // use them afterwards. No later message reaches `win` either
+    HWND hwnd = reinterpret_cast<HWND>(win.m_native.hwnd);
+    HDC hdc = reinterpret_cast<HDC>(win.m_native.hdc);
+    if (hdc) {
+        if (wglGetCurrentDC() == hdc) wglMakeCurrent(nullptr, nullptr);
+        ReleaseDC(hwnd, hdc);
+    }
+    SetWindowLongPtrW(hwnd, GWLP_USERDATA, 0);
+    win.m_native.hdc = nullptr;
+    win.m_native.hwnd = nullptr;
+} // native::on_window_closed
+
 Window::
 Window(IWindowEvents& handler, int w, int h,
     RendererApi api,
     bool shown,
     bool bordless) noexcept
-    : m_handler{ handler }, m_width{ w }, m_height{ h },
+    : m_handler{ &handler }, m_size{ detail::pack_size(w, h) },
       m_fb{} {
-#ifdef LA_NOSTD
-    static bool is_registered = false;
-    if (!is_registered) {
-        WNDCLASS wc{};
-        wc.style = CS_OWNDC | CS_HREDRAW | CS_VREDRAW;
-        wc.lpfnWndProc = win_proc;
-        wc.hInstance = GetModuleHandleW(nullptr);
-        wc.lpszClassName = WINDOW_CLASSNAME;
-
-        if (!RegisterClassW(&wc))
-            m_handler.on_error(Error::CreateWindow, AboutError::Win32_WindowClass);
-        is_registered = true;
-    }
-#else // has STD
-    static thread_local
-    struct ThreadInstance {
-        HMODULE hinstance;
-
-        ThreadInstance() noexcept : hinstance{ GetModuleHandleW(nullptr) } {
-            WNDCLASS wc{};
-            wc.style = CS_OWNDC | CS_HREDRAW | CS_VREDRAW;
-            wc.lpfnWndProc = win_proc;
-            wc.hInstance = hinstance;
-            wc.lpszClassName = WINDOW_CLASSNAME;
-
-            if (!RegisterClassW(&wc))
-                hinstance = nullptr;
-        }
-    } thread_ctx;
-
-    if (!thread_ctx.hinstance) {
-        m_handler.on_error(Error::CreateWindow, AboutError::Win32_WindowClass);
+    if (!register_window_class()) {
+        m_handler->on_error(Error::CreateWindow, AboutError::Win32_WindowClass);
         return;
     }
-#endif // LA_NOSTD
 
     // Window
     m_native.hwnd = reinterpret_cast<void *>(
@@ -875,25 +1396,26 @@ Window(IWindowEvents& handler, int w, int h,
         /* height       */ h,
         /* hWndParent   */ nullptr,
         /* hMenu        */ nullptr,
-#ifdef LA_NOSTD
         /* hInstance    */ GetModuleHandleW(nullptr),
-#else // NOT freestanding
-        /* hInstance    */ thread_ctx.hinstance,
-#endif
         /* lpParam      */ this));
     if (!native().hwnd) {
-        m_handler.on_error(Error::CreateWindow, AboutError::Win32_Window);
+        m_handler->on_error(Error::CreateWindow, AboutError::Win32_Window);
         return;
     }
+    m_open.store(1);
+    ++t_open_windows;
 
     // DC
     m_native.hdc = reinterpret_cast<void *>(
         GetDC(reinterpret_cast<HWND>((native().hwnd))));
 
     if (!native().hdc) {
-        m_handler.on_error(Error::CreateWindow, AboutError::Win32_WindowDc);
+        m_handler->on_error(Error::CreateWindow, AboutError::Win32_WindowDc);
         return;
     }
+
+    // Without it `wait_events()` still wakes on input and timeouts, just not on `wake()`
+    m_native.wake_event = reinterpret_cast<void*>(CreateEventW(nullptr, FALSE, FALSE, nullptr));
 } // Window
 
 // --------------------------- Window Procedures ---------------------------
@@ -902,16 +1424,24 @@ Window(IWindowEvents& handler, int w, int h,
 
 void Window::
 swap_buffer_software() const noexcept {
+    LA_PROFILE_FUNCTION();
+    if (!m_native.hwnd) return; // Closed: a null window would repaint every window
+    const uint64_t begin = FrameTimings::now_ns();
     InvalidateRect(reinterpret_cast<HWND>(m_native.hwnd), nullptr, FALSE);
     UpdateWindow(reinterpret_cast<HWND>(m_native.hwnd));
+    m_timings.present_ns += FrameTimings::now_ns() - begin;
 }
 void Window::
 swap_buffer_opengl() const noexcept {
+    LA_PROFILE_FUNCTION();
 #ifdef __LA_CXX17 // Wrap it in macro: Cannot access PF_DESCRIPTOR at runtime
     static_assert(wingl::PF_DESCRIPTOR.dwFlags & PFD_DOUBLEBUFFER,
         "OpenGL renderer requires double buffering");
 #endif
+    if (!m_native.hdc) return; // Closed
+    const uint64_t begin = FrameTimings::now_ns();
     SwapBuffers(reinterpret_cast<HDC>(m_native.hdc));
+    m_timings.present_ns += FrameTimings::now_ns() - begin;
 }
 
 // Public procedures
@@ -930,16 +1460,143 @@ quit() const noexcept {
 
 bool Window::
 poll_events() const noexcept {
+    LA_PROFILE_FUNCTION();
+    const uint64_t begin = FrameTimings::now_ns();
     MSG msg{};
+    bool any = false;
     while (PeekMessageW(&msg, nullptr, 0, 0, PM_REMOVE)) {
-        if (msg.message == WM_QUIT)
+        if (msg.message == WM_QUIT) {
+            m_events.flush();
             return false;
+        }
         TranslateMessage(&msg);
         DispatchMessageW(&msg);
+        any = true;
     }
+    m_events.flush(); // Publish the last coalesced move or scroll
+    m_input.publish();
+
+    // Other windows on this thread keep running, only this one's loop ends
+    if (!is_open())
+        return false;
+
+    // Threaded, the timings belong to the render thread
+    if (m_render_threaded) {
+        if (any) m_render_signal.set();
+    }
+    else m_timings.poll_ns += FrameTimings::now_ns() - begin;
     return true;
 } // poll_events
 
+bool Window::
+wait_events(uint64_t timeout_ns) const noexcept {
+    if (timeout_ns) {
+        LA_PROFILE_ZONE("Window::wait_events");
+        HANDLE handles[2];
+        DWORD count = 0;
+        if (m_native.wake_event)
+            handles[count++] = reinterpret_cast<HANDLE>(m_native.wake_event);
+
+        // The timer keeps sub-millisecond timeouts, the wait's own timeout is whole ms
+        DWORD timeout_ms = INFINITE;
+        HANDLE timer = nullptr;
+        if (timeout_ns != WAIT_FOREVER) {
+            timer = arm_sleep_timer(timeout_ns);
+            if (timer) handles[count++] = timer;
+            else       timeout_ms = static_cast<DWORD>((timeout_ns + 999999) / 1000000);
+        }
+
+        // MWMO_INPUTAVAILABLE: also return for messages that arrived before the call
+        MsgWaitForMultipleObjectsEx(count, handles, timeout_ms, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+        if (timer) CancelWaitableTimer(timer);
+    }
+    return poll_events();
+} // wait_events
+
+void Window::
+wake() const noexcept {
+    if (m_native.wake_event)
+        SetEvent(reinterpret_cast<HANDLE>(m_native.wake_event));
+} // wake
+
+// --------------------------- Render Thread ---------------------------
+
+// From the message thread. The render thread may be stuck in a `SendMessage` to
+// one of our windows (GL and GDI calls can send), so serve sent messages until it
+// exits: a plain join there deadlocks, e.g. in WM_DESTROY
+static void
+join_serving_sent_messages(Thread& thread) noexcept {
+    HANDLE handle = reinterpret_cast<HANDLE>(thread.native_handle());
+    while (handle && MsgWaitForMultipleObjectsEx(1, &handle, INFINITE, QS_SENDMESSAGE, 0) == WAIT_OBJECT_0 + 1) {
+        MSG msg;
+        PeekMessageW(&msg, nullptr, 0, 0, PM_NOREMOVE | PM_QS_SENDMESSAGE); // Runs the sent ones only
+    }
+    thread.join(); // Exited, closes the handle
+} // join_serving_sent_messages
+
+void Window::
+render_thread_main(void* window) noexcept {
+    Window& win = *static_cast<Window*>(window);
+    native::make_context_current(win, true);
+
+    while (!win.m_render_stop.load()) {
+        if (!win.m_render_continuous)
+            win.m_render_signal.wait();
+        if (win.m_render_stop.load()) break;
+
+        win.drain_render_messages();
+        win.render();
+    }
+    native::make_context_current(win, false); // Back to the thread that stops us
+} // render_thread_main
+
+void Window::
+drain_render_messages() noexcept {
+    Event e;
+    while (m_events.pop(e)) {
+        if (e.type == EventType::Resize) // Coalesced, `render()` reallocates once
+            native::request_geometry_change(*this, e.x, e.y);
+        else
+            dispatch_event(*m_handler, e);
+    }
+} // drain_render_messages
+
+bool Window::
+start_render_thread(bool continuous) noexcept {
+    if (m_render_threaded) return true;
+
+    m_render_continuous = continuous;
+    m_render_stop.store(0);
+    m_buffer_events_before = m_buffer_events;
+    m_buffer_events = true;
+    m_render_threaded = true;
+
+    // The render thread binds the context itself, a context is current on one thread only
+    native::make_context_current(*this, false);
+    if (!m_render_thread.start(&render_thread_main, this)) {
+        m_render_threaded = false;
+        m_buffer_events = m_buffer_events_before;
+        native::make_context_current(*this, true);
+        return false;
+    }
+    m_render_signal.set(); // First frame
+    return true;
+} // start_render_thread
+
+void Window::
+stop_render_thread() noexcept {
+    if (!m_render_threaded) return;
+
+    m_render_stop.store(1);
+    m_render_signal.set();
+    join_serving_sent_messages(m_render_thread);
+
+    m_render_threaded = false;
+    m_buffer_events = m_buffer_events_before;
+    drain_render_messages(); // Input queued after the last frame
+    native::make_context_current(*this, true);
+} // stop_render_thread
+
 // --------------------------- Window Setters ---------------------------
 
 void Window::
@@ -1023,7 +1680,6 @@ set_fullscreen(bool value) const noexcept {
 
 // ------------------------------- Key ----------------------------------------
 
-LA_NO_DISCARD bool is_pressed(Key k) noexcept { return key_array[static_cast<unsigned int>(k)]; }
 
 LA_NO_DISCARD const char* get_key_name(Key k) noexcept {
     using K = Key;
@@ -1124,56 +1780,71 @@ LA_NO_DISCARD const char* get_key_name(Key k) noexcept {
 
 // --------------------------- Create Opengl Context --------------------------
 
-LA_NO_DISCARD ::la::AboutError
-create_gl_context(HDC main_dc) noexcept {
-    wingl::PFNWGLCHOOSEPIXELFORMATARBPROC    
-        wglChoosePixelFormatARB = nullptr;
+// WGL entry points belong to the driver, not to a context: load them once per
+// process through a throwaway window, every window on every thread shares them
+static wingl::PFNWGLCHOOSEPIXELFORMATARBPROC    g_wglChoosePixelFormatARB = nullptr;
+static wingl::PFNWGLCREATECONTEXTATTRIBSARBPROC g_wglCreateContextAttribsARB = nullptr;
+static ::la::AboutError g_wgl_error = ::la::AboutError::None;
 
-    wingl::PFNWGLCREATECONTEXTATTRIBSARBPROC 
-        wglCreateContextAttribsARB = nullptr;
+enum : uint32_t { WGL_UNLOADED, WGL_LOADING, WGL_LOADED };
+static ::la::Atomic<uint32_t> g_wgl_state{ WGL_UNLOADED };
 
-    // 1. Create a dummy window for loading WGL extensions
-#if !defined(LA_NOSTD)
-    static thread_local
-#endif
+LA_NO_DISCARD static ::la::AboutError
+load_wgl_extensions() noexcept {
+    // 1.1 Dummy window, destroyed with its context on return
     DummyWindow dummy{};
-    if (!dummy.ctx()) {
+    if (!dummy.histance()) return ::la::AboutError::Win32_Dummy_WindowClass;
+    if (!dummy.hwnd())     return ::la::AboutError::Win32_Dummy_Window;
+    if (!dummy.hdc())      return ::la::AboutError::Win32_Dummy_WindowDc;
+
+    // 1.2. Dummy context for loading WGL extensions
+    { // Choose and set pixel format
+        int format = ChoosePixelFormat(dummy.hdc(), &wingl::PF_DESCRIPTOR);
+        if (format == 0)
+            return ::la::AboutError::Win32_Dummy_ChoosePixelFormat;
+
+        if (!SetPixelFormat(dummy.hdc(), format, &wingl::PF_DESCRIPTOR))
+            return ::la::AboutError::Win32_Dummy_SetPixelFormat;
+    }
 
-        // 1.1 Dummy window
-        if (!dummy.histance()) return ::la::AboutError::Win32_Dummy_WindowClass;
-        if (!dummy.hwnd())     return ::la::AboutError::Win32_Dummy_Window;
-        if (!dummy.hdc())      return ::la::AboutError::Win32_Dummy_WindowDc;
+    // 1.3. Load WGL extensions
+    // Dummy Context
+    dummy.set_ctx(wglCreateContext(dummy.hdc()));
 
-        // 1.2. Dummy context for loading WGL extensions
-        { // Choose and set pixel format
-            int format = ChoosePixelFormat(dummy.hdc(), &wingl::PF_DESCRIPTOR);
-            if (format == 0)
-                return ::la::AboutError::Win32_Dummy_ChoosePixelFormat;
+    if (!wglMakeCurrent(dummy.hdc(), dummy.ctx()))
+        return ::la::AboutError::Win32_Dummy_CreateContext;
 
-            if (!SetPixelFormat(dummy.hdc(), format, &wingl::PF_DESCRIPTOR))
-                return ::la::AboutError::Win32_Dummy_SetPixelFormat;
-        }
+    // wgl functions
+    g_wglChoosePixelFormatARB =
+        (wingl::PFNWGLCHOOSEPIXELFORMATARBPROC)
+        (void*)wglGetProcAddress("wglChoosePixelFormatARB");
 
-        // 1.3. Load WGL extensions
-        // Dummy Context
-        dummy.set_ctx(wglCreateContext(dummy.hdc()));
+    g_wglCreateContextAttribsARB =
+        (wingl::PFNWGLCREATECONTEXTATTRIBSARBPROC)
+        (void*)wglGetProcAddress("wglCreateContextAttribsARB");
+    // Loaded wgl functions
 
-        if (!wglMakeCurrent(dummy.hdc(), dummy.ctx()))
-            return ::la::AboutError::Win32_Dummy_CreateContext;
+    if (!g_wglChoosePixelFormatARB)    return ::la::AboutError::Win32_Missing_ChoosePixelFormatARB;
+    if (!g_wglCreateContextAttribsARB) return ::la::AboutError::Win32_Missing_CreateContextAttribsARB;
+    return ::la::AboutError::None;
+} // load_wgl_extensions
 
-        // wgl functions
-        wglChoosePixelFormatARB =
-            (wingl::PFNWGLCHOOSEPIXELFORMATARBPROC)
-            (void*)wglGetProcAddress("wglChoosePixelFormatARB");
+LA_NO_DISCARD ::la::AboutError
+create_gl_context(HDC main_dc, HGLRC& out_context) noexcept {
+    // 1. First caller loads, windows created meanwhile on other threads wait for it
+    uint32_t state = WGL_UNLOADED;
+    if (g_wgl_state.compare_exchange(state, WGL_LOADING)) {
+        g_wgl_error = load_wgl_extensions();
+        g_wgl_state.store(WGL_LOADED);
+    }
+    else while (g_wgl_state.load() != WGL_LOADED)
+        ::la::sleep(1);
 
-        wglCreateContextAttribsARB =
-            (wingl::PFNWGLCREATECONTEXTATTRIBSARBPROC)
-            (void*)wglGetProcAddress("wglCreateContextAttribsARB");
-        // Loaded wgl functions
-    } // if (!dummy.ctx())
+    if (g_wgl_error != ::la::AboutError::None)
+        return g_wgl_error;
 
-    if (!wglChoosePixelFormatARB) return ::la::AboutError::Win32_Missing_ChoosePixelFormatARB;
-    if (!wglCreateContextAttribsARB) return ::la::AboutError::Win32_Missing_CreateContextAttribsARB;
+    const wingl::PFNWGLCHOOSEPIXELFORMATARBPROC    wglChoosePixelFormatARB = g_wglChoosePixelFormatARB;
+    const wingl::PFNWGLCREATECONTEXTATTRIBSARBPROC wglCreateContextAttribsARB = g_wglCreateContextAttribsARB;
 
     // 3. Set modern pixel format for the main window
     { // Choose and set pixel format using ARB
@@ -1189,6 +1860,7 @@ create_gl_context(HDC main_dc) noexcept {
     // 4. Create OpenGL 3.3 Core Profile context
     HGLRC gl_context = wglCreateContextAttribsARB(main_dc, nullptr, wingl::CONTEXT_ATTRS);
     if (!gl_context)                          return ::la::AboutError::Win32_CreateContextAttribsARB;
+    out_context = gl_context;
     if (!wglMakeCurrent(main_dc, gl_context)) return ::la::AboutError::Win32_CreateModernContext;
 
     // Enable VSync
@@ -1280,32 +1952,51 @@ static ::la::Key map_key(WPARAM wparam) noexcept {
     } // switch
 } // map_key
 
-static inline ::la::Key handle_key(WPARAM wparam, bool pressed) noexcept {
-    ::la::Key k;
-
-#ifdef LA_CXX_17
-    static_assert(sizeof(::la::Key) == sizeof(int));
-    static_assert(sizeof(k) == sizeof(int));
-#endif
-    // Try to search for general key, otherwise returns `__NONE__` (0) as flag.
-    k = map_key(wparam);
 
-    // No needs to check out for `__NONE__`, we simply write the value.
-    key_array[static_cast<int>(k)] = pressed ? 1 : 0;
-    return k;
-} // handle_key
+// --------------------------- Win Proc ---------------------------
 
+// Straight to the handler, or into the window's queue while buffering
+static void
+emit_event(::la::Window* win, ::la::EventType type, ::la::Key key,
+           int x = 0, int y = 0, float scroll = 0.f) noexcept {
+    ::la::Event e;
+    e.time_ns = ::la::get_monotonic_ns();
+    e.type = type;
+    e.key = key;
+    e.x = x;
+    e.y = y;
+    e.scroll = scroll;
+
+    // The snapshot state sees every event, buffered or not
+    ::la::InputState& input = win->input_state();
+    switch (type) {
+    case ::la::EventType::MouseMove: input.mouse_move(x, y);        break;
+    case ::la::EventType::Scroll:    input.scroll(scroll);          break;
+    case ::la::EventType::KeyDown:   input.key(key, true);          break;
+    case ::la::EventType::KeyUp:     input.key(key, false);         break;
+    case ::la::EventType::Focus:     if (!x) input.release_all();   break;
+    case ::la::EventType::Resize:                                   break;
+    } // switch
 
-// --------------------------- Win Proc ---------------------------
+    if (win->is_event_buffering()) win->events().push(e);
+    else                           ::la::dispatch_event(win->handler(), e);
+} // emit_event
 
 static LRESULT CALLBACK
 win_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam) noexcept {
     ::la::Window* win = reinterpret_cast<::la::Window*>(
         GetWindowLongPtrW(hwnd, GWLP_USERDATA));
+    // No `la::Window` before `WM_NCCREATE`, nor once its destructor began
+    if (!win && msg != WM_NCCREATE && msg != WM_DESTROY)
+        return DefWindowProc(hwnd, msg, wparam, lparam);
 
     switch (msg) {
     case WM_PAINT: {
-        win->render();
+        if (win->is_render_threaded()) {
+            ValidateRect(hwnd, nullptr); // The render thread presents on its own
+            win->request_redraw();
+        }
+        else win->render();
         return 0;
     } // WM_PAINT
 
@@ -1315,55 +2006,61 @@ win_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam) noexcept {
 
         // Window Minimized
         if (wparam == SIZE_MINIMIZED) {
-            win->handler().on_focus_change(false);
+            emit_event(win, ::la::EventType::Focus, ::la::Key::__NONE__, 0);
             return 0; // Handled
         }
-        // Window Resized
+        // Window Resized: coalesced, the following WM_PAINT applies the latest size
         RECT rect;
         GetClientRect(reinterpret_cast<HWND>(win->native().hwnd), &rect);
-        ::la::native::on_geometry_change(*win, static_cast<int>(rect.right - rect.left),
-                                               static_cast<int>(rect.bottom - rect.top));
+        const int w = static_cast<int>(rect.right - rect.left);
+        const int h = static_cast<int>(rect.bottom - rect.top);
+        // Threaded: the render thread owns the framebuffer, the size travels as a message
+        if (win->is_render_threaded())
+            emit_event(win, ::la::EventType::Resize, ::la::Key::__NONE__, w, h);
+        else
+            ::la::native::request_geometry_change(*win, w, h);
         return 0;
     } // WM_SIZE
 
     case WM_MOUSEMOVE:
-        win->handler().on_mouse_move(/* X pos */ LOWORD(lparam),
-                                     /* Y pos */ HIWORD(lparam));
+        emit_event(win, ::la::EventType::MouseMove, ::la::Key::__NONE__,
+                   /* X pos */ LOWORD(lparam),
+                   /* Y pos */ HIWORD(lparam));
         return 0;
 
     case WM_SETFOCUS:
-        win->handler().on_focus_change(true);
+        emit_event(win, ::la::EventType::Focus, ::la::Key::__NONE__, 1);
         return 0;
 
     case WM_KILLFOCUS:
-        win->handler().on_focus_change(false);
+        emit_event(win, ::la::EventType::Focus, ::la::Key::__NONE__, 0);
         return 0;
 
     case WM_MOUSEWHEEL: {
         int delta = GET_WHEEL_DELTA_WPARAM(wparam); // +120 or -120
-        win->handler().on_scroll_vertical(delta / 120.f);
+        emit_event(win, ::la::EventType::Scroll, ::la::Key::__NONE__, 0, 0, delta / 120.f);
         return 0;
     }
 
     case WM_KEYDOWN: {
-        ::la::Key k = handle_key(wparam, true);
-        win->handler().on_key_down(k);
+        ::la::Key k = map_key(wparam); // `__NONE__` for unmapped keys
+        emit_event(win, ::la::EventType::KeyDown, k);
         return 0;
     }
     case WM_KEYUP: {
-        ::la::Key k = handle_key(wparam, false);
-        win->handler().on_key_up(k);
+        ::la::Key k = map_key(wparam);
+        emit_event(win, ::la::EventType::KeyUp, k);
         return 0;
     }
 
     case WM_SYSKEYDOWN:
-        if (wparam == VK_F10)       win->handler().on_key_down(::la::Key::F10);
-        else if (wparam == VK_MENU) win->handler().on_key_down(::la::Key::Alt);
+        if (wparam == VK_F10)       emit_event(win, ::la::EventType::KeyDown, ::la::Key::F10);
+        else if (wparam == VK_MENU) emit_event(win, ::la::EventType::KeyDown, ::la::Key::Alt);
         return 0;
 
     case WM_SYSKEYUP:
-        if (wparam == VK_F10)       win->handler().on_key_up(::la::Key::F10);
-        else if (wparam == VK_MENU) win->handler().on_key_up(::la::Key::Alt);
+        if (wparam == VK_F10)       emit_event(win, ::la::EventType::KeyUp, ::la::Key::F10);
+        else if (wparam == VK_MENU) emit_event(win, ::la::EventType::KeyUp, ::la::Key::Alt);
         return 0;
 
     case WM_NCCREATE: {
@@ -1373,11 +2070,1251 @@ win_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam) noexcept {
     } // WM_NCCREATE
 
     case WM_DESTROY:
-        PostQuitMessage(0);
+        if (win) ::la::native::on_window_closed(*win);
+        if (::la::t_open_windows && --::la::t_open_windows == 0)
+            PostQuitMessage(0);
         return 0;
     } // switch (msg)
 
     return DefWindowProc(hwnd, msg, wparam, lparam);
 } // win_proc
 
-#endif // _WIN32
\ No newline at end of file
+#elif defined(__linux__)
+
+#include "la.hpp"
+
+// Kernel UAPI headers only. System calls are made directly, so the same code
+// runs on top of glibc/musl and in freestanding (`LA_NOSTD`) builds
+#include <asm/unistd.h> // __NR_*
+#include <linux/errno.h>
+#include <linux/fcntl.h>
+#include <linux/futex.h>
+#include <linux/mman.h>
+#include <linux/perf_event.h>
+#include <linux/prctl.h>
+
+#if defined(LA_NOSTD)
+#   include <linux/elf.h>   // vDSO symbols, TLS image
+#   include <linux/sched.h> // CLONE_*
+#else
+#   include <pthread.h>
+#   include <stdlib.h>      // exit
+#   include <time.h>        // clock_gettime
+#   if !defined(__x86_64__) && !defined(__aarch64__)
+#       include <errno.h>
+#       include <unistd.h>  // syscall
+#   endif
+#endif
+
+#ifndef MADV_POPULATE_WRITE
+#   define MADV_POPULATE_WRITE 23 // Linux 5.14
+#endif
+#ifndef MADV_PAGEOUT
+#   define MADV_PAGEOUT 21 // Linux 5.4
+#endif
+#ifndef PR_SET_VMA
+#   define PR_SET_VMA 0x53564d41 // Linux 5.17
+#   define PR_SET_VMA_ANON_NAME 0
+#endif
+
+namespace la {
+
+// --------------------------- System Calls ---------------------------
+
+namespace detail {
+    // Kernel convention for every wrapper: the result, or -errno
+#if defined(__x86_64__)
+    static inline long
+    sys(long n, long a = 0, long b = 0, long c = 0, long d = 0, long e = 0, long f = 0) noexcept {
+        register long r10 __asm__("r10") = d;
+        register long r8 __asm__("r8") = e;
+        register long r9 __asm__("r9") = f;
+        long result;
+        __asm__ __volatile__("syscall"
+                             : "=a"(result)
+                             : "a"(n), "D"(a), "S"(b), "d"(c), "r"(r10), "r"(r8), "r"(r9)
+                             : "rcx", "r11", "memory");
+        return result;
+    } // sys
+#elif defined(__aarch64__)
+    static inline long
+    sys(long n, long a = 0, long b = 0, long c = 0, long d = 0, long e = 0, long f = 0) noexcept {
+        register long x8 __asm__("x8") = n;
+        register long x0 __asm__("x0") = a;
+        register long x1 __asm__("x1") = b;
+        register long x2 __asm__("x2") = c;
+        register long x3 __asm__("x3") = d;
+        register long x4 __asm__("x4") = e;
+        register long x5 __asm__("x5") = f;
+        __asm__ __volatile__("svc #0"
+                             : "+r"(x0)
+                             : "r"(x8), "r"(x1), "r"(x2), "r"(x3), "r"(x4), "r"(x5)
+                             : "memory");
+        return x0;
+    } // sys
+#elif !defined(LA_NOSTD)
+    static inline long
+    sys(long n, long a = 0, long b = 0, long c = 0, long d = 0, long e = 0, long f = 0) noexcept {
+        const long result = syscall(n, a, b, c, d, e, f);
+        return result == -1 ? -errno : result;
+    } // sys
+#else
+#   error "LA_NOSTD on Linux supports x86-64 and AArch64"
+#endif
+
+    LA_NO_DISCARD static inline long
+    as_arg(const volatile void* ptr) noexcept { return reinterpret_cast<long>(ptr); }
+
+    // Errors are the top 4095 values
+    LA_NO_DISCARD static inline bool
+    sys_failed(long result) noexcept { return static_cast<unsigned long>(result) > -4096ul; }
+
+    LA_NO_DISCARD static inline void*
+    sys_mmap(size_t length, long extra_flags) noexcept {
+        const long result = sys(__NR_mmap, 0, static_cast<long>(length), PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS | extra_flags, -1, 0);
+        return sys_failed(result) ? nullptr : reinterpret_cast<void*>(result);
+    } // sys_mmap
+
+    static inline long
+    sys_munmap(void* ptr, size_t length) noexcept {
+        return sys(__NR_munmap, as_arg(ptr), static_cast<long>(length));
+    } // sys_munmap
+
+    // Whole buffer, retrying short writes and EINTR
+    LA_NO_DISCARD static bool
+    sys_write_all(int fd, const void* data, size_t size) noexcept {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        while (size) {
+            const long written = sys(__NR_write, fd, as_arg(bytes), static_cast<long>(size));
+            if (written == -EINTR) continue;
+            if (written <= 0) return false;
+            bytes += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    } // sys_write_all
+
+    // 64-bit `struct timespec`, without pulling in <time.h>
+    struct KernelTimespec {
+        long sec;
+        long nsec;
+    }; // struct KernelTimespec
+
+    LA_CONSTEXPR_VAR long LINUX_CLOCK_MONOTONIC = 1;
+    LA_CONSTEXPR_VAR long LINUX_TIMER_ABSTIME = 1;
+} // namespace detail
+
+// --------------------------- SIMD ---------------------------
+
+// The SSE/AVX kernels are only built in the Win32 section: the scalar ones
+// run everywhere and are left to the compiler's vectorizer
+Simd::AddFloat  add_float = &Simd::add_t<float, 1>::apply;
+Simd::AddInt32  add_int32 = &Simd::add_t<int32_t, 1>::apply;
+Simd::FillFloat fill_float = &Simd::fill_t<float, 1>::apply;
+Simd::FillInt32 fill_int32 = &Simd::fill_t<int32_t, 1>::apply;
+Simd::BlendArgb32 blend_argb32 = &Simd::blend_t<1>::apply;
+
+// Nothing to detect, the kernels above are already in place
+void GlobalInitializer::
+init() noexcept {}
+
+#if defined(LA_NOSTD)
+// --------------------------- Freestanding Runtime ---------------------------
+
+/*
+    No libc: `_start` below is the entry point. It sets up thread-local storage,
+    finds `clock_gettime` in the vDSO, runs static constructors and calls `main`.
+    Link statically and without PIE, for example:
+
+        g++ -std=c++14 -DLA_NOSTD -static -nostdlib -fno-pie -no-pie -ffreestanding
+            -fno-exceptions -fno-rtti -fno-threadsafe-statics -fno-stack-protector ...
+
+    Destructors of globals don't run, `exit_process()` ends the process at once.
+*/
+
+// What the compiler emits calls to, even in freestanding code. Loops kept from
+// being turned back into calls to themselves
+#if defined(__GNUC__) && !defined(__clang__)
+#   define LA_NO_LOOP_IDIOMS __attribute__((optimize("no-tree-loop-distribute-patterns")))
+#else
+#   define LA_NO_LOOP_IDIOMS
+#endif
+
+extern "C" LA_NO_LOOP_IDIOMS void*
+memset(void* dest, int ch, size_t count) {
+#if defined(__x86_64__)
+    void* d = dest;
+    __asm__ __volatile__("rep stosb" : "+D"(d), "+c"(count) : "a"(ch) : "memory");
+#else
+    unsigned char* p = static_cast<unsigned char*>(dest);
+    while (count--) *p++ = static_cast<unsigned char>(ch);
+#endif
+    return dest;
+}
+
+extern "C" LA_NO_LOOP_IDIOMS void*
+memcpy(void* dest, const void* src, size_t count) {
+#if defined(__x86_64__)
+    void* d = dest;
+    __asm__ __volatile__("rep movsb" : "+D"(d), "+S"(src), "+c"(count) : : "memory");
+#else
+    unsigned char* d = static_cast<unsigned char*>(dest);
+    const unsigned char* s = static_cast<const unsigned char*>(src);
+    while (count--) *d++ = *s++;
+#endif
+    return dest;
+}
+
+extern "C" LA_NO_LOOP_IDIOMS void*
+memmove(void* dest, const void* src, size_t count) {
+    unsigned char* d = static_cast<unsigned char*>(dest);
+    const unsigned char* s = static_cast<const unsigned char*>(src);
+    if (d <= s || d >= s + count)
+        return memcpy(dest, src, count); // Forward copies are safe
+    while (count--) d[count] = s[count];
+    return dest;
+}
+
+extern "C" LA_NO_LOOP_IDIOMS int
+memcmp(const void* a, const void* b, size_t count) {
+    const unsigned char* x = static_cast<const unsigned char*>(a);
+    const unsigned char* y = static_cast<const unsigned char*>(b);
+    for (size_t i = 0; i < count; ++i)
+        if (x[i] != y[i]) return x[i] < y[i] ? -1 : 1;
+    return 0;
+}
+
+// C++ ABI hooks: static destructors are dropped, pure calls are bugs
+extern "C" {
+void* __dso_handle = &__dso_handle;
+int __cxa_atexit(void (*)(void*), void*, void*) { return 0; }
+void __cxa_pure_virtual() { ::la::panic_process("Pure virtual function called", -1); }
+}
+
+namespace detail {
+    LA_CONSTEXPR_VAR unsigned long AUX_PHDR = 3;
+    LA_CONSTEXPR_VAR unsigned long AUX_PHNUM = 5;
+    LA_CONSTEXPR_VAR unsigned long AUX_SYSINFO_EHDR = 33;
+
+    using VdsoClockGettime = int (*)(long clock, KernelTimespec* ts);
+    static VdsoClockGettime g_vdso_clock_gettime = nullptr;
+
+    // PT_TLS of the executable: every thread gets a copy
+    struct TlsImage {
+        const unsigned char* data;
+        size_t file_size; // Initialized part, the rest is zero
+        size_t mem_size;
+        size_t align;
+    }; // struct TlsImage
+
+    static TlsImage g_tls_image{ nullptr, 0, 0, 16 };
+
+    LA_NO_DISCARD static inline size_t
+    align_up(size_t value, size_t to) noexcept { return (value + to - 1) & ~(to - 1); }
+
+    LA_NO_DISCARD static bool
+    equal_strings(const char* a, const char* b) noexcept {
+        while (*a && *a == *b) { ++a; ++b; }
+        return *a == *b;
+    } // equal_strings
+
+    // Symbol table walk through DT_HASH, which both vDSOs carry. Without it
+    // the time functions fall back to the system call
+    static void
+    find_vdso_clock(uintptr_t base) noexcept {
+#if defined(__x86_64__)
+        const char* NAME = "__vdso_clock_gettime";
+#else
+        const char* NAME = "__kernel_clock_gettime";
+#endif
+        const Elf64_Ehdr* header = reinterpret_cast<const Elf64_Ehdr*>(base);
+        const Elf64_Phdr* program = reinterpret_cast<const Elf64_Phdr*>(base + header->e_phoff);
+        uintptr_t bias = 0;
+        bool loaded = false;
+        const Elf64_Dyn* dynamic = nullptr;
+        for (unsigned i = 0; i < header->e_phnum; ++i) {
+            if (program[i].p_type == PT_LOAD && !loaded) {
+                bias = base + program[i].p_offset - program[i].p_vaddr;
+                loaded = true;
+            }
+            else if (program[i].p_type == PT_DYNAMIC)
+                dynamic = reinterpret_cast<const Elf64_Dyn*>(base + program[i].p_offset);
+        }
+        if (!dynamic) return;
+
+        const Elf64_Sym* symbols = nullptr;
+        const char* strings = nullptr;
+        const uint32_t* hash = nullptr;
+        for (const Elf64_Dyn* d = dynamic; d->d_tag != DT_NULL; ++d) {
+            if (d->d_tag == DT_SYMTAB) symbols = reinterpret_cast<const Elf64_Sym*>(bias + d->d_un.d_ptr);
+            if (d->d_tag == DT_STRTAB) strings = reinterpret_cast<const char*>(bias + d->d_un.d_ptr);
+            if (d->d_tag == DT_HASH)   hash = reinterpret_cast<const uint32_t*>(bias + d->d_un.d_ptr);
+        }
+        if (!symbols || !strings || !hash) return;
+
+        const uint32_t count = hash[1]; // `nchain`, one per symbol
+        for (uint32_t i = 0; i < count; ++i) {
+            const Elf64_Sym& symbol = symbols[i];
+            if ((symbol.st_info & 0xF) != STT_FUNC || !symbol.st_shndx) continue;
+            if (equal_strings(strings + symbol.st_name, NAME)) {
+                g_vdso_clock_gettime = reinterpret_cast<VdsoClockGettime>(bias + symbol.st_value);
+                return;
+            }
+        }
+    } // find_vdso_clock
+
+    static void
+    find_tls_image(const Elf64_Phdr* program, unsigned long count) noexcept {
+        // Non-PIE is linked at its run address, PT_PHDR still gives the bias
+        uintptr_t bias = 0;
+        for (unsigned long i = 0; i < count; ++i)
+            if (program[i].p_type == PT_PHDR)
+                bias = reinterpret_cast<uintptr_t>(program) - program[i].p_vaddr;
+        for (unsigned long i = 0; i < count; ++i) {
+            if (program[i].p_type != PT_TLS) continue;
+            g_tls_image.data = reinterpret_cast<const unsigned char*>(bias + program[i].p_vaddr);
+            g_tls_image.file_size = program[i].p_filesz;
+            g_tls_image.mem_size = program[i].p_memsz;
+            if (program[i].p_align > g_tls_image.align) g_tls_image.align = program[i].p_align;
+        }
+    } // find_tls_image
+
+    LA_CONSTEXPR_VAR size_t TLS_TCB_SIZE = 64; // Self pointer, stack protector canary at 0x28
+
+    // Room for `tls_setup()`, from any 16-byte aligned address
+    LA_NO_DISCARD static inline size_t
+    tls_area_size() noexcept {
+        return align_up(g_tls_image.mem_size, g_tls_image.align) + 2 * g_tls_image.align + TLS_TCB_SIZE;
+    } // tls_area_size
+
+    // Lays a fresh TLS block out in `area`, returns the thread pointer. x86-64
+    // puts the block below the thread pointer, AArch64 above a 16-byte TCB
+    LA_NO_DISCARD static uintptr_t
+    tls_setup(unsigned char* area) noexcept {
+        const size_t block_size = align_up(g_tls_image.mem_size, g_tls_image.align);
+#if defined(__x86_64__)
+        const uintptr_t tp = align_up(reinterpret_cast<uintptr_t>(area) + block_size, g_tls_image.align);
+        unsigned char* block = reinterpret_cast<unsigned char*>(tp - block_size);
+        *reinterpret_cast<uintptr_t*>(tp) = tp; // %fs:0 reads the thread pointer
+#else
+        const uintptr_t tp = align_up(reinterpret_cast<uintptr_t>(area), g_tls_image.align);
+        unsigned char* block = reinterpret_cast<unsigned char*>(tp + align_up(16, g_tls_image.align));
+#endif
+        for (size_t i = 0; i < g_tls_image.file_size; ++i) block[i] = g_tls_image.data[i];
+        for (size_t i = g_tls_image.file_size; i < block_size; ++i) block[i] = 0;
+        return tp;
+    } // tls_setup
+
+    static void
+    set_thread_pointer(uintptr_t tp) noexcept {
+#if defined(__x86_64__)
+        (void)sys(__NR_arch_prctl, 0x1002 /* ARCH_SET_FS */, static_cast<long>(tp));
+#else
+        __asm__ __volatile__("msr tpidr_el0, %0" : : "r"(tp) : "memory");
+#endif
+    } // set_thread_pointer
+} // namespace detail
+
+using InitFunction = void (*)(int, char**, char**);
+extern "C" InitFunction __init_array_start[] __attribute__((weak));
+extern "C" InitFunction __init_array_end[] __attribute__((weak));
+
+// Called by `_start` with the initial stack: argc, argv, envp and the aux vector
+extern "C" __attribute__((used)) void
+la_linux_start(long* stack) noexcept {
+    const int argc = static_cast<int>(stack[0]);
+    char** argv = reinterpret_cast<char**>(stack + 1);
+    char** envp = argv + argc + 1;
+    char** env = envp;
+    while (*env) ++env;
+
+    const Elf64_Phdr* program = nullptr;
+    unsigned long program_count = 0;
+    for (const unsigned long* aux = reinterpret_cast<const unsigned long*>(env + 1); aux[0]; aux += 2) {
+        if (aux[0] == detail::AUX_PHDR)         program = reinterpret_cast<const Elf64_Phdr*>(aux[1]);
+        if (aux[0] == detail::AUX_PHNUM)        program_count = aux[1];
+        if (aux[0] == detail::AUX_SYSINFO_EHDR) detail::find_vdso_clock(aux[1]);
+    }
+    if (program) detail::find_tls_image(program, program_count);
+
+    // Main thread's TLS before any `thread_local` is touched, `la::alloc` included
+    void* area = detail::sys_mmap(detail::tls_area_size(), 0);
+    if (!area) exit_process(-1);
+    detail::set_thread_pointer(detail::tls_setup(static_cast<unsigned char*>(area)));
+
+    if (__init_array_start)
+        for (InitFunction* init = __init_array_start; init != __init_array_end; ++init)
+            (*init)(argc, argv, envp);
+} // la_linux_start
+
+#define LA_STRINGIFY_(x) #x
+#define LA_STRINGIFY(x) LA_STRINGIFY_(x)
+
+// Entry point: `la_linux_start()`, then `exit_group(main(argc, argv, envp))`
+#if defined(__x86_64__)
+__asm__(
+    ".text\n"
+    ".global _start\n"
+    ".type _start, @function\n"
+    "_start:\n"
+    "    xor %ebp, %ebp\n"
+    "    mov %rsp, %r12\n"
+    "    and $-16, %rsp\n"
+    "    mov %r12, %rdi\n"
+    "    call la_linux_start\n"
+    "    mov (%r12), %edi\n"
+    "    lea 8(%r12), %rsi\n"
+    "    lea 16(%r12, %rdi, 8), %rdx\n"
+    "    call main\n"
+    "    mov %eax, %edi\n"
+    "    mov $" LA_STRINGIFY(__NR_exit_group) ", %eax\n"
+    "    syscall\n"
+    "    hlt\n");
+#else
+__asm__(
+    ".text\n"
+    ".global _start\n"
+    ".type _start, %function\n"
+    "_start:\n"
+    "    mov x29, #0\n"
+    "    mov x30, #0\n"
+    "    mov x19, sp\n"
+    "    and x0, x19, #-16\n"
+    "    mov sp, x0\n"
+    "    mov x0, x19\n"
+    "    bl la_linux_start\n"
+    "    ldr x0, [x19]\n"
+    "    add x1, x19, #8\n"
+    "    add x2, x1, x0, lsl #3\n"
+    "    add x2, x2, #8\n"
+    "    bl main\n"
+    "    mov x8, #" LA_STRINGIFY(__NR_exit_group) "\n"
+    "    svc #0\n");
+#endif
+#endif // LA_NOSTD
+
+// --------------------------- Allocate/Free ---------------------------
+
+// PMD size, used by both `MAP_HUGETLB` (default pool) and transparent huge pages
+LA_CONSTEXPR_VAR size_t LINUX_HUGE_PAGE = 2 * 1024 * 1024;
+LA_CONSTEXPR_VAR size_t LINUX_PAGE = 4096;
+
+LA_NO_DISCARD static inline size_t
+round_up(size_t size, size_t to) noexcept { return (size + to - 1) & ~(to - 1); }
+
+size_t
+get_large_page_size() noexcept { return LINUX_HUGE_PAGE; }
+
+void*
+alloc(size_t size) noexcept { return alloc(size, ALLOC_DEFAULT, -1); }
+
+// Transparent huge pages only back 2 MB-aligned extents: over-map, trim both ends
+LA_NO_DISCARD static void*
+map_huge_aligned(size_t length) noexcept {
+    unsigned char* start = static_cast<unsigned char*>(detail::sys_mmap(length + LINUX_HUGE_PAGE, 0));
+    if (!start) return nullptr;
+
+    unsigned char* aligned = reinterpret_cast<unsigned char*>(
+        round_up(reinterpret_cast<uintptr_t>(start), LINUX_HUGE_PAGE));
+    const size_t head = static_cast<size_t>(aligned - start);
+    if (head) detail::sys_munmap(start, head);
+    if (head != LINUX_HUGE_PAGE) detail::sys_munmap(aligned + length, LINUX_HUGE_PAGE - head);
+
+    // Needed unless THP is "always"
+    (void)detail::sys(__NR_madvise, detail::as_arg(aligned), static_cast<long>(length), MADV_HUGEPAGE);
+    return aligned;
+} // map_huge_aligned
+
+void*
+alloc(size_t size, uint32_t flags, int numa_node) noexcept {
+    if (!size) return nullptr;
+    size_t length = round_up(size, LINUX_PAGE);
+    const bool large = (flags & ALLOC_LARGE_PAGES) && size >= LINUX_HUGE_PAGE;
+
+    // Reserved huge pages first (`vm.nr_hugepages`, usually 0), then THP
+    void* ptr = nullptr;
+    if (large) {
+        ptr = detail::sys_mmap(round_up(size, LINUX_HUGE_PAGE), MAP_HUGETLB);
+        if (ptr) length = round_up(size, LINUX_HUGE_PAGE);
+        else     ptr = map_huge_aligned(length);
+    }
+    else ptr = detail::sys_mmap(length, 0);
+    if (!ptr) return nullptr;
+
+    // Shows as "[anon:la]" in /proc/self/maps, the mappings `reset_workset()` pages out.
+    // Needs CONFIG_ANON_VMA_NAME, without it nothing is named
+    (void)detail::sys(__NR_prctl, PR_SET_VMA, PR_SET_VMA_ANON_NAME, detail::as_arg(ptr),
+                      static_cast<long>(length), detail::as_arg("la"));
+
+    // Policy before the first fault, or it only applies to later ones.
+    // MPOL_BIND = 2, called directly so there is no libnuma dependency
+    if ((flags & ALLOC_NUMA_NODE) && numa_node >= 0 && numa_node < 64) {
+        const unsigned long mask = 1ul << numa_node;
+        (void)detail::sys(__NR_mbind, detail::as_arg(ptr), static_cast<long>(length), 2,
+                          detail::as_arg(&mask), 65, 0);
+    }
+
+    // Locking faults the pages in too. Bounded by RLIMIT_MEMLOCK
+    const bool locked = (flags & ALLOC_LOCK) &&
+                        detail::sys(__NR_mlock, detail::as_arg(ptr), static_cast<long>(length)) == 0;
+    if ((flags & ALLOC_POPULATE) && !locked &&
+        detail::sys(__NR_madvise, detail::as_arg(ptr), static_cast<long>(length), MADV_POPULATE_WRITE) != 0) {
+        volatile unsigned char* bytes = static_cast<volatile unsigned char*>(ptr); // Older kernels: by hand
+        for (size_t at = 0; at < length; at += LINUX_PAGE) bytes[at] = 0;
+    }
+    detail::telemetry_alloc(detail::current_alloc_tag(), size);
+    return ptr;
+} // alloc
+
+void
+free(void* ptr, size_t size) noexcept {
+    if (!ptr) return;
+    detail::telemetry_free(detail::current_alloc_tag(), size);
+    // `MAP_HUGETLB` mappings unmap in whole huge pages only
+    if (detail::sys_munmap(ptr, size) != 0)
+        detail::sys_munmap(ptr, round_up(size, LINUX_HUGE_PAGE));
+} // free
+
+// --------------------------- Processing ---------------------------
+
+void
+exit_process(int error_code) noexcept {
+#if defined(LA_NOSTD)
+    for (;;) (void)detail::sys(__NR_exit_group, error_code);
+#else
+    exit(error_code); // Flushes and runs the static destructors
+#endif
+} // exit_process
+
+uint32_t
+get_thread_id() noexcept { return static_cast<uint32_t>(detail::sys(__NR_gettid)); }
+
+void
+panic_process(const char* explain_msg, int error_code) noexcept {
+    // Straight to stderr, `la::Out` is silent without LA_CONSOLE
+    size_t length = 0;
+    while (explain_msg[length]) ++length;
+    (void)detail::sys_write_all(2, explain_msg, length);
+    (void)detail::sys_write_all(2, "\n", 1);
+    exit_process(error_code);
+} // panic_process
+
+// --------------------------- Time ---------------------------
+
+void native::
+sleep_until(uint64_t deadline_ns) noexcept {
+    const detail::KernelTimespec ts{ static_cast<long>(deadline_ns / 1000000000ull),
+                                     static_cast<long>(deadline_ns % 1000000000ull) };
+    // Absolute, so signals don't stretch the total
+    while (detail::sys(__NR_clock_nanosleep, detail::LINUX_CLOCK_MONOTONIC, detail::LINUX_TIMER_ABSTIME,
+                       detail::as_arg(&ts), 0) == -EINTR) {}
+} // sleep_until
+
+void
+sleep(unsigned ms) noexcept {
+    ::la::native::sleep_until(::la::get_monotonic_ns() + ms * 1000000ull);
+} // sleep
+
+// Answered from the vDSO, no system call: by libc, or by the pointer the
+// freestanding startup looked up
+LA_NO_DISCARD static inline detail::KernelTimespec
+monotonic_now() noexcept {
+    detail::KernelTimespec now{ 0, 0 };
+#if defined(LA_NOSTD)
+    if (detail::g_vdso_clock_gettime)
+        detail::g_vdso_clock_gettime(detail::LINUX_CLOCK_MONOTONIC, &now);
+    else
+        (void)detail::sys(__NR_clock_gettime, detail::LINUX_CLOCK_MONOTONIC, detail::as_arg(&now));
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    now.sec = static_cast<long>(ts.tv_sec);
+    now.nsec = ts.tv_nsec;
+#endif
+    return now;
+} // monotonic_now
+
+uint64_t
+get_monotonic_ns() noexcept {
+    const detail::KernelTimespec now = monotonic_now();
+    return static_cast<uint64_t>(now.sec) * 1000000000ull + static_cast<uint64_t>(now.nsec);
+} // get_monotonic_ns
+
+double
+get_monotonic_secs() noexcept {
+    const detail::KernelTimespec now = monotonic_now();
+    return static_cast<double>(now.sec) + static_cast<double>(now.nsec) * 1e-9;
+} // get_monotonic_secs
+
+void
+cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+} // cpu_relax
+
+void
+yield_thread() noexcept { (void)detail::sys(__NR_sched_yield); }
+
+// --------------------------- Threads ---------------------------
+
+#if defined(LA_NOSTD)
+struct ThreadEntry {
+    static void run(void* thread) noexcept {
+        Thread& t = *static_cast<Thread*>(thread);
+        t.m_proc(t.m_arg);
+    }
+}; // struct ThreadEntry
+
+namespace detail {
+    LA_CONSTEXPR_VAR size_t THREAD_STACK_SIZE = 1024 * 1024; // Committed on touch
+
+    // Above the stack in the thread's mapping, TLS follows it
+    struct alignas(16) CloneThread {
+        Atomic<uint32_t> tid; // Cleared and futex-woken by the kernel at thread exit
+        size_t bytes;         // Whole mapping: guard page, stack, this, TLS
+    }; // struct CloneThread
+
+    // clone() with the child starting on `stack`, where `ThreadEntry::run` and
+    // its argument wait to be popped. The child never returns here
+    LA_NO_DISCARD static long
+    clone_thread(unsigned long flags, void** stack, Atomic<uint32_t>* tid, uintptr_t tp) noexcept {
+#if defined(__x86_64__)
+        register long r10 __asm__("r10") = as_arg(tid); // Child tid
+        register long r8 __asm__("r8") = static_cast<long>(tp);
+        long result;
+        __asm__ __volatile__(
+            "syscall\n\t"
+            "test %%rax, %%rax\n\t"
+            "jnz 1f\n\t"
+            "xor %%ebp, %%ebp\n\t"
+            "pop %%rax\n\t"
+            "pop %%rdi\n\t"
+            "call *%%rax\n\t"
+            "mov %[exit], %%eax\n\t"
+            "xor %%edi, %%edi\n\t"
+            "syscall\n\t"
+            "1:"
+            : "=a"(result)
+            : "a"(__NR_clone), "D"(flags), "S"(stack), "d"(tid), "r"(r10), "r"(r8),
+              [exit] "i"(__NR_exit)
+            : "rcx", "r11", "memory");
+        return result;
+#else
+        register long x8 __asm__("x8") = __NR_clone;
+        register long x0 __asm__("x0") = static_cast<long>(flags);
+        register long x1 __asm__("x1") = as_arg(stack);
+        register long x2 __asm__("x2") = as_arg(tid); // Parent tid
+        register long x3 __asm__("x3") = static_cast<long>(tp);
+        register long x4 __asm__("x4") = as_arg(tid); // Child tid
+        __asm__ __volatile__(
+            "svc #0\n\t"
+            "cbnz x0, 1f\n\t"
+            "mov x29, xzr\n\t"
+            "ldp x1, x0, [sp], #16\n\t"
+            "blr x1\n\t"
+            "mov x8, %[exit]\n\t"
+            "mov x0, xzr\n\t"
+            "svc #0\n\t"
+            "1:"
+            : "+r"(x0)
+            : "r"(x8), "r"(x1), "r"(x2), "r"(x3), "r"(x4), [exit] "i"(__NR_exit)
+            : "x30", "memory");
+        return x0;
+#endif
+    } // clone_thread
+} // namespace detail
+
+bool Thread::
+start(Proc proc, void* arg) noexcept {
+    if (m_handle) return false;
+    m_proc = proc;
+    m_arg = arg;
+
+    // [guard page][stack][CloneThread][TLS]
+    const size_t top_bytes = round_up(sizeof(detail::CloneThread) + detail::tls_area_size(), LINUX_PAGE);
+    const size_t bytes = LINUX_PAGE + detail::THREAD_STACK_SIZE + top_bytes;
+    unsigned char* base = static_cast<unsigned char*>(detail::sys_mmap(bytes, MAP_STACK));
+    if (!base) return false;
+    (void)detail::sys(__NR_mprotect, detail::as_arg(base), LINUX_PAGE, PROT_NONE);
+
+    unsigned char* top = base + LINUX_PAGE + detail::THREAD_STACK_SIZE;
+    detail::CloneThread* control = reinterpret_cast<detail::CloneThread*>(top);
+    control->bytes = bytes;
+    const uintptr_t tp = detail::tls_setup(top + sizeof(detail::CloneThread));
+
+    void** stack = reinterpret_cast<void**>(top) - 2;
+    stack[0] = reinterpret_cast<void*>(&ThreadEntry::run);
+    stack[1] = this;
+
+    const unsigned long flags = CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND | CLONE_THREAD |
+                                CLONE_SYSVSEM | CLONE_SETTLS | CLONE_PARENT_SETTID | CLONE_CHILD_CLEARTID;
+    if (detail::sys_failed(detail::clone_thread(flags, stack, &control->tid, tp))) {
+        detail::sys_munmap(base, bytes);
+        return false;
+    }
+    m_handle = reinterpret_cast<uintptr_t>(control);
+    return true;
+} // start
+
+void Thread::
+join() noexcept {
+    if (!m_handle) return;
+    detail::CloneThread* control = reinterpret_cast<detail::CloneThread*>(m_handle);
+    // The tid was set before clone() returned, 0 means the thread is gone for good
+    for (uint32_t tid = control->tid.load(); tid; tid = control->tid.load())
+        (void)detail::sys(__NR_futex, detail::as_arg(&control->tid), FUTEX_WAIT, tid, 0, 0, 0);
+
+    const size_t bytes = control->bytes;
+    detail::sys_munmap(reinterpret_cast<unsigned char*>(control) - detail::THREAD_STACK_SIZE - LINUX_PAGE, bytes);
+    m_handle = 0;
+} // join
+#else
+struct ThreadEntry {
+    static void* run(void* thread) noexcept {
+        Thread& t = *static_cast<Thread*>(thread);
+        t.m_proc(t.m_arg);
+        return nullptr;
+    }
+}; // struct ThreadEntry
+
+bool Thread::
+start(Proc proc, void* arg) noexcept {
+    if (m_handle) return false;
+    m_proc = proc;
+    m_arg = arg;
+    pthread_t thread;
+    if (pthread_create(&thread, nullptr, &ThreadEntry::run, this) != 0)
+        return false;
+    m_handle = static_cast<uintptr_t>(thread);
+    return true;
+} // start
+
+void Thread::
+join() noexcept {
+    if (!m_handle) return;
+    pthread_join(static_cast<pthread_t>(m_handle), nullptr);
+    m_handle = 0;
+} // join
+#endif // LA_NOSTD
+
+Signal::
+Signal() noexcept = default;
+
+Signal::
+~Signal() noexcept = default;
+
+void Signal::
+set() noexcept {
+    if (m_state.exchange(1) == 0)
+        (void)detail::sys(__NR_futex, detail::as_arg(&m_state), FUTEX_WAKE_PRIVATE, 1);
+} // set
+
+void Signal::
+wait() noexcept {
+    // Sleeps only while the word is still 0, so a `set()` in between isn't lost
+    while (m_state.exchange(0) == 0)
+        (void)detail::sys(__NR_futex, detail::as_arg(&m_state), FUTEX_WAIT_PRIVATE, 0, 0);
+} // wait
+
+// --------------------------- Misc Functions ---------------------------
+
+namespace detail {
+    // procfs files report no size, read until EOF into a fixed buffer
+    LA_NO_DISCARD static size_t
+    read_proc(const char* path, char* buffer, size_t capacity) noexcept {
+        const long fd = sys(__NR_openat, AT_FDCWD, as_arg(path), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return 0;
+        size_t length = 0;
+        while (length + 1 < capacity) {
+            const long got = sys(__NR_read, fd, as_arg(buffer + length), static_cast<long>(capacity - 1 - length));
+            if (got == -EINTR) continue;
+            if (got <= 0) break;
+            length += static_cast<size_t>(got);
+        }
+        (void)sys(__NR_close, fd);
+        buffer[length] = '\0';
+        return length;
+    } // read_proc
+
+    LA_NO_DISCARD static uint64_t
+    parse_unsigned(const char*& at, unsigned base = 10) noexcept {
+        uint64_t value = 0;
+        for (;; ++at) {
+            unsigned digit;
+            if (*at >= '0' && *at <= '9')                  digit = static_cast<unsigned>(*at - '0');
+            else if (base == 16 && *at >= 'a' && *at <= 'f') digit = static_cast<unsigned>(*at - 'a' + 10);
+            else break;
+            value = value * base + digit;
+        }
+        return value;
+    } // parse_unsigned
+
+    // "12.34", PSI prints two decimals
+    LA_NO_DISCARD static float
+    parse_decimal(const char* at) noexcept {
+        float value = static_cast<float>(parse_unsigned(at));
+        if (*at == '.')
+            for (float scale = 0.1f; *++at >= '0' && *at <= '9'; scale *= 0.1f)
+                value += static_cast<float>(*at - '0') * scale;
+        return value;
+    } // parse_decimal
+
+    LA_NO_DISCARD static const char*
+    find_text(const char* text, const char* what) noexcept {
+        for (; *text; ++text) {
+            size_t i = 0;
+            while (what[i] && text[i] == what[i]) ++i;
+            if (!what[i]) return text;
+        }
+        return nullptr;
+    } // find_text
+
+    // Start of the next space-separated field
+    LA_NO_DISCARD static const char*
+    next_field(const char* at, const char* end) noexcept {
+        while (at < end && *at != ' ') ++at;
+        while (at < end && *at == ' ') ++at;
+        return at;
+    } // next_field
+
+    LA_NO_DISCARD static bool
+    has_prefix(const char* at, const char* end, const char* prefix) noexcept {
+        for (; *prefix; ++at, ++prefix)
+            if (at == end || *at != *prefix) return false;
+        return true;
+    } // has_prefix
+
+    // One /proc/self/maps line: "start-end perms offset dev inode   path".
+    // Only `la::alloc` mappings, named by it: thread stacks, the libc heap and
+    // other libraries' memory are left alone
+    static void
+    page_out_mapping(const char* line, const char* end) noexcept {
+        const uint64_t start = parse_unsigned(line, 16);
+        if (*line++ != '-') return;
+        const uint64_t stop = parse_unsigned(line, 16);
+        const char* perms = next_field(line, end);
+        if (end - perms < 4 || perms[0] != 'r' || perms[1] != 'w' || perms[3] != 'p') return;
+
+        const char* path = next_field(next_field(next_field(next_field(perms, end), end), end), end);
+        static const char NAME[] = "[anon:la]"; // Set by `la::alloc()`
+        if (!has_prefix(path, end, NAME) || path + sizeof(NAME) - 1 != end) return;
+
+        (void)sys(__NR_madvise, static_cast<long>(start), static_cast<long>(stop - start), MADV_PAGEOUT);
+    } // page_out_mapping
+} // namespace detail
+
+namespace detail {
+    // `struct linux_dirent64`, the name runs to `reclen`
+    struct LinuxDirent64 {
+        uint64_t ino;
+        int64_t off;
+        unsigned short reclen;
+        unsigned char type;
+        char name[1];
+    }; // struct LinuxDirent64
+
+    // /sys/class/power_supply/<supply>/<file>
+    LA_NO_DISCARD static size_t
+    read_power_supply(const char* supply, const char* file, char* buffer, size_t capacity) noexcept {
+        char path[320];
+        size_t length = 0;
+        for (const char* at = "/sys/class/power_supply/"; *at;) path[length++] = *at++;
+        while (*supply && length + 2 < sizeof(path)) path[length++] = *supply++;
+        path[length++] = '/';
+        while (*file && length + 1 < sizeof(path)) path[length++] = *file++;
+        path[length] = '\0';
+        return read_proc(path, buffer, capacity);
+    } // read_power_supply
+} // namespace detail
+
+// A system battery discharging while no mains adapter is online. Batteries of
+// peripherals (scope "Device": mice, headsets) don't count
+bool
+is_battery_in_use() noexcept {
+    using namespace detail;
+    const long fd = sys(__NR_openat, AT_FDCWD, as_arg("/sys/class/power_supply"),
+                        O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    bool discharging = false;
+    bool mains = false;
+    alignas(8) char entries[2048];
+    for (long got; (got = sys(__NR_getdents64, fd, as_arg(entries), sizeof(entries))) > 0;) {
+        for (long at = 0; at < got;) {
+            const LinuxDirent64& entry = *reinterpret_cast<const LinuxDirent64*>(entries + at);
+            at += entry.reclen;
+            if (entry.name[0] == '.') continue;
+
+            char text[32];
+            const size_t length = read_power_supply(entry.name, "type", text, sizeof(text));
+            if (has_prefix(text, text + length, "Mains") || has_prefix(text, text + length, "USB")) {
+                if (read_power_supply(entry.name, "online", text, sizeof(text)) && text[0] == '1')
+                    mains = true;
+            } else if (has_prefix(text, text + length, "Battery")) {
+                const size_t scope = read_power_supply(entry.name, "scope", text, sizeof(text));
+                if (scope && has_prefix(text, text + scope, "Device")) continue;
+                const size_t status = read_power_supply(entry.name, "status", text, sizeof(text));
+                if (has_prefix(text, text + status, "Discharging")) discharging = true;
+            }
+        }
+    }
+    (void)sys(__NR_close, fd);
+    return discharging && !mains;
+} // is_battery_in_use
+
+// The `la::alloc` mappings go to swap (or zram), if any. Needs Linux 5.4 for the
+// advice and CONFIG_ANON_VMA_NAME (5.17) for the names that tell those mappings
+// apart, without them nothing is paged out
+void
+reset_workset() noexcept {
+    const long fd = detail::sys(__NR_openat, AT_FDCWD, detail::as_arg("/proc/self/maps"), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+
+    char buffer[4096];
+    size_t kept = 0; // Partial line carried over from the last read
+    for (;;) {
+        const long got = detail::sys(__NR_read, fd, detail::as_arg(buffer + kept),
+                                     static_cast<long>(sizeof(buffer) - kept));
+        if (got == -EINTR) continue;
+        if (got <= 0) break;
+
+        const size_t length = kept + static_cast<size_t>(got);
+        size_t line = 0;
+        for (size_t i = 0; i < length; ++i) {
+            if (buffer[i] != '\n') continue;
+            detail::page_out_mapping(buffer + line, buffer + i);
+            line = i + 1;
+        }
+        kept = length - line;
+        if (kept == sizeof(buffer)) kept = 0; // A path longer than the buffer
+        for (size_t i = 0; i < kept; ++i) buffer[i] = buffer[line + i];
+    }
+    (void)detail::sys(__NR_close, fd);
+} // reset_workset
+
+size_t
+get_resident_bytes() noexcept {
+    char statm[128]; // "size resident shared ..." in pages
+    if (!detail::read_proc("/proc/self/statm", statm, sizeof(statm))) return 0;
+    const char* at = statm;
+    (void)detail::parse_unsigned(at);
+    ++at;
+    return static_cast<size_t>(detail::parse_unsigned(at)) * LINUX_PAGE;
+} // get_resident_bytes
+
+// Pages fully inside the range, none when it is smaller than one
+LA_NO_DISCARD static bool
+inner_pages(void* ptr, size_t size, uintptr_t& begin, uintptr_t& end) noexcept {
+    begin = round_up(reinterpret_cast<uintptr_t>(ptr), LINUX_PAGE);
+    end = (reinterpret_cast<uintptr_t>(ptr) + size) & ~static_cast<uintptr_t>(LINUX_PAGE - 1);
+    return begin < end;
+} // inner_pages
+
+void
+discard_pages(void* ptr, size_t size) noexcept {
+    uintptr_t begin, end;
+    if (inner_pages(ptr, size, begin, end))
+        (void)detail::sys(__NR_madvise, static_cast<long>(begin), static_cast<long>(end - begin), MADV_DONTNEED);
+} // discard_pages
+
+void
+page_out(void* ptr, size_t size) noexcept {
+    uintptr_t begin, end;
+    if (inner_pages(ptr, size, begin, end))
+        (void)detail::sys(__NR_madvise, static_cast<long>(begin), static_cast<long>(end - begin), MADV_PAGEOUT);
+} // page_out
+
+bool
+get_memory_stall(MemoryStall& out) noexcept {
+    // "some avg10=1.23 avg60=... total=...\nfull avg10=..."
+    char pressure[256];
+    if (!detail::read_proc("/proc/pressure/memory", pressure, sizeof(pressure))) return false;
+    const char* some = detail::find_text(pressure, "some avg10=");
+    const char* full = detail::find_text(pressure, "full avg10=");
+    if (!some) return false;
+    out.some = detail::parse_decimal(some + 11);
+    out.full = full ? detail::parse_decimal(full + 11) : 0.0f;
+    return true;
+} // get_memory_stall
+
+namespace detail {
+    LA_CONSTEXPR_VAR unsigned MAX_CPUS = 1024;
+    LA_CONSTEXPR_VAR unsigned CPU_WORDS = MAX_CPUS / 64;
+
+    // "0-3,8,10-11" into a bit per CPU
+    static void
+    parse_cpu_list(const char* at, uint64_t (&mask)[CPU_WORDS]) noexcept {
+        while (*at >= '0' && *at <= '9') {
+            const uint64_t first = parse_unsigned(at);
+            uint64_t last = first;
+            if (*at == '-') last = parse_unsigned(++at);
+            for (uint64_t cpu = first; cpu <= last && cpu < MAX_CPUS; ++cpu)
+                mask[cpu / 64] |= 1ull << (cpu % 64);
+            if (*at++ != ',') break;
+        }
+    } // parse_cpu_list
+
+    LA_NO_DISCARD static uint32_t
+    count_bits(const uint64_t* words, unsigned count) noexcept {
+        uint32_t bits = 0;
+        for (unsigned i = 0; i < count; ++i)
+            for (uint64_t word = words[i]; word; word &= word - 1) ++bits;
+        return bits;
+    } // count_bits
+
+    // /sys/devices/system/cpu/cpu<N>/topology/<file>
+    LA_NO_DISCARD static size_t
+    read_cpu_topology(unsigned cpu, const char* file, char* buffer, size_t capacity) noexcept {
+        char path[96];
+        size_t length = 0;
+        for (const char* at = "/sys/devices/system/cpu/cpu"; *at;) path[length++] = *at++;
+        char digits[10];
+        unsigned count = 0;
+        do { digits[count++] = static_cast<char>('0' + cpu % 10); } while (cpu /= 10);
+        while (count) path[length++] = digits[--count];
+        for (const char* at = "/topology/"; *at;) path[length++] = *at++;
+        while (*file && length + 1 < sizeof(path)) path[length++] = *file++;
+        path[length] = '\0';
+        return read_proc(path, buffer, capacity);
+    } // read_cpu_topology
+} // namespace detail
+
+CpuTopology
+get_cpu_topology() noexcept {
+    using namespace detail;
+    CpuTopology topology;
+    uint64_t allowed[CPU_WORDS] = {};
+    if (sys(__NR_sched_getaffinity, 0, sizeof(allowed), as_arg(allowed)) <= 0)
+        allowed[0] = 1;
+    topology.logical = count_bits(allowed, CPU_WORDS);
+
+    // A core counts once, through the first allowed CPU among its siblings
+    uint64_t seen[CPU_WORDS] = {};
+    uint64_t packages = 0; // Package ids modulo 64
+    char text[256];
+    for (unsigned cpu = 0; cpu < MAX_CPUS; ++cpu) {
+        const uint64_t bit = 1ull << (cpu % 64);
+        if (!(allowed[cpu / 64] & bit) || (seen[cpu / 64] & bit)) continue;
+        ++topology.cores;
+        seen[cpu / 64] |= bit;
+        if (read_cpu_topology(cpu, "thread_siblings_list", text, sizeof(text)))
+            parse_cpu_list(text, seen);
+        if (read_cpu_topology(cpu, "physical_package_id", text, sizeof(text))) {
+            const char* at = text;
+            packages |= 1ull << (parse_unsigned(at) % 64);
+        }
+    }
+    topology.packages = count_bits(&packages, 1);
+
+    uint64_t nodes[CPU_WORDS] = {};
+    if (read_proc("/sys/devices/system/node/online", text, sizeof(text)))
+        parse_cpu_list(text, nodes);
+    topology.numa_nodes = count_bits(nodes, CPU_WORDS);
+
+    if (!topology.cores) topology.cores = topology.logical;
+    if (!topology.packages) topology.packages = 1;
+    if (!topology.numa_nodes) topology.numa_nodes = 1;
+    return topology;
+} // get_cpu_topology
+
+// --------------------------- Input/Output ---------------------------
+
+void
+print(const char* msg, size_t msg_length) noexcept { (void)detail::sys_write_all(1, msg, msg_length); }
+
+bool
+write_file(const char* path, const void* data, size_t size) noexcept {
+    const long fd = detail::sys(__NR_openat, AT_FDCWD, detail::as_arg(path),
+                                O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return false;
+
+    const bool ok = detail::sys_write_all(static_cast<int>(fd), data, size);
+    return detail::sys(__NR_close, fd) == 0 && ok;
+} // write_file
+
+void*
+read_file(const char* path, size_t* size) noexcept {
+    const long fd = detail::sys(__NR_openat, AT_FDCWD, detail::as_arg(path), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return nullptr;
+
+    // Size by seeking, no `struct stat` layout to depend on
+    const long end = detail::sys(__NR_lseek, fd, 0, 2 /* SEEK_END */);
+    void* data = nullptr;
+    if (end > 0 && detail::sys(__NR_lseek, fd, 0, 0 /* SEEK_SET */) == 0) {
+        const size_t total = static_cast<size_t>(end);
+        data = ::la::alloc(total);
+
+        unsigned char* bytes = static_cast<unsigned char*>(data);
+        size_t left = data ? total : 0;
+        while (left) {
+            const long got = detail::sys(__NR_read, fd, detail::as_arg(bytes), static_cast<long>(left));
+            if (got == -EINTR) continue;
+            if (got <= 0) { // Error, or the file shrank meanwhile
+                ::la::free(data, total);
+                data = nullptr;
+                break;
+            }
+            bytes += got;
+            left -= static_cast<size_t>(got);
+        }
+        if (data) *size = total;
+    }
+    (void)detail::sys(__NR_close, fd);
+    return data;
+} // read_file
+
+// --------------------------- Native Framebuffer ---------------------------
+
+// Grow by 1.5x so a live-resize drag reallocates O(log n) times, not per event
+LA_NO_DISCARD static inline int
+grow_capacity(int current, int wanted) noexcept {
+    if (wanted <= current) return current;
+    const int next = current + current / 2;
+    return next > wanted ? next : wanted;
+} // grow_capacity
+
+void native::Framebuffer::
+clear(uint32_t color, int win_width, int win_height) const noexcept {
+    LA_PROFILE_FUNCTION();
+    if (!pixels) return;
+
+    const int w = win_width < width ? win_width : width;
+    const int h = win_height < height ? win_height : height;
+    if (w <= 0 || h <= 0) return;
+
+    // Padding between rows is invisible, so one contiguous fill beats a per-row loop
+    const size_t pixel_count = static_cast<size_t>(stride) * (h - 1) + w;
+    ::la::fill_int32(static_cast<int32_t*>(pixels), static_cast<int32_t>(color), pixel_count);
+} // clear
+
+void native::Framebuffer::
+release() noexcept {
+    if (pixels) {
+        LA_ALLOC_TAG(AllocTag::Framebuffer);
+        ::la::free(pixels, static_cast<size_t>(stride) * capacity_height * 4);
+    }
+    pixels = nullptr;
+    width = height = stride = capacity_height = 0;
+} // release
+
+native::Framebuffer::
+~Framebuffer() noexcept { release(); }
+
+LA_NO_DISCARD ::la::AboutError native::Framebuffer::
+resize(int width_, int height_) noexcept {
+    LA_PROFILE_FUNCTION();
+
+    // Reject invalid dimensions (e.g. minimized), keep the allocation for later
+    if (width_ <= 0 || height_ <= 0) {
+        width = height = 0;
+        return ::la::AboutError::None;
+    }
+
+    // Fits into the current allocation: only the visible size changes
+    if (pixels && width_ <= stride && height_ <= capacity_height) {
+        width = width_;
+        height = height_;
+        return ::la::AboutError::None;
+    }
+
+    // Rows are padded to 8 pixels (32 bytes) so every row start suits AVX stores
+    const int new_stride = (grow_capacity(stride, width_) + 7) & ~7;
+    const int new_rows   = grow_capacity(capacity_height, height_);
+    release();
+
+    LA_ALLOC_TAG(AllocTag::Framebuffer);
+    pixels = ::la::alloc(static_cast<size_t>(new_stride) * new_rows * 4, alloc_flags);
+    if (!pixels)
+        return ::la::AboutError::Linux_AllocFramebuffer;
+    width = width_;
+    height = height_;
+    stride = new_stride;
+    capacity_height = new_rows;
+    return ::la::AboutError::None;
+} // resize
+
+void native::Framebuffer::
+draw_pixel(int x, int y, int width_, int height_, uint32_t color) const noexcept {
+    if (x < 0 || x >= width_ || y < 0 || y >= height_ || !pixels)
+        return;
+    static_cast<uint32_t*>(pixels)[static_cast<size_t>(stride) * y + x] = color;
+} // draw_pixel
+
+// --------------------------- Performance Counters ---------------------------
+
+bool
+PerfCounters::open() noexcept {
+    static const struct { uint32_t type; uint64_t config; } EVENTS[PerfSample::COUNT] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    };
+
+    close();
+    long leader = -1; // First counter that opens, the others join its group
+    for (unsigned i = 0; i < PerfSample::COUNT; ++i) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = EVENTS[i].type;
+        attr.config = EVENTS[i].config;
+        attr.exclude_kernel = 1; // Allowed at perf_event_paranoid 2
+        attr.exclude_hv = 1;
+        // The leader reads the whole group at once, with its schedule
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                           PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        // Calling thread, any CPU. Fails with EACCES/ENOENT/ENODEV when restricted
+        const long fd = detail::sys(__NR_perf_event_open, detail::as_arg(&attr), 0, -1, leader,
+                                    PERF_FLAG_FD_CLOEXEC);
+        if (fd < 0) continue;
+        if (leader < 0) leader = fd;
+        m_fds[i] = static_cast<int>(fd);
+        m_valid |= static_cast<uint8_t>(1u << i);
+    }
+    return m_valid != 0;
+} // open
+
+void
+PerfCounters::close() noexcept {
+    // Members before the leader, though the kernel copes either way
+    for (unsigned i = PerfSample::COUNT; i-- > 0;) {
+        if (m_fds[i] >= 0) (void)detail::sys(__NR_close, m_fds[i]);
+        m_fds[i] = -1;
+    }
+    m_valid = 0;
+} // close
+
+PerfSample
+PerfCounters::read() const noexcept {
+    PerfSample sample;
+    if (!m_valid) return sample;
+
+    // { nr, time_enabled, time_running, value per member in the order they joined }
+    uint64_t group[3 + PerfSample::COUNT];
+    const uint64_t members = static_cast<uint64_t>(m_valid);
+    const long expected = static_cast<long>((3 + detail::count_bits(&members, 1)) * sizeof(uint64_t));
+    const int leader = m_fds[lowest_bit(m_valid)];
+    if (detail::sys(__NR_read, leader, detail::as_arg(group), sizeof(group)) != expected)
+        return sample;
+
+    sample.time_enabled = group[1];
+    sample.time_running = group[2];
+    unsigned member = 0;
+    for (unsigned i = 0; i < PerfSample::COUNT; ++i)
+        if ((m_valid >> i) & 1) sample.values[i] = group[3 + member++];
+    sample.valid = m_valid;
+    return sample;
+} // read
+
+} // namespace la
+
+#endif // _WIN32, __linux__
@@ -3,6 +3,8 @@
 
 /*
     Use `LA_NOSTD` macro for freestanding mode builds: no std libraries, pure bare metal.
+    On Linux (x86-64, AArch64) la.cpp then brings its own `_start`, TLS and threads;
+    link with `-static -nostdlib -no-pie`, see the "Freestanding Runtime" section there.
     Use `LA_CONSOLE` macro to enable terminal output.
 */
 
@@ -21,6 +23,7 @@
 // I FUCKING HATE MICROSOFT PRODUCTS.
 #if defined(_MSC_VER) && defined(LA_NOSTD)
     extern "C" void* __cdecl memset(void* dest, int ch, size_t count);
+    extern "C" void* __cdecl memcpy(void* dest, const void* src, size_t count);
 #endif // msvc
 
 // -------------------- C++17 feature detection -------------------------------
@@ -85,11 +88,26 @@
 #   define LA_FALLTHROUGH ((void)0)
 #endif
 
+// Callbacks are `noexcept` function pointers (`Thread::Proc`, `TaskProc`, ...), which
+// C++17 makes part of the type and so of mangled names. Every file of the library
+// is built with one standard, the C++14 warning about it is noise
+#if !defined(LA_CXX_17) && defined(__clang__)
+#   pragma clang diagnostic ignored "-Wc++17-compat-mangling"
+#elif !defined(LA_CXX_17) && defined(__GNUC__) && __GNUC__ >= 7
+#   pragma GCC diagnostic ignored "-Wnoexcept-type"
+#endif
+
 // ------------------- Freestanding-friendly Includes -------------------------
 
 #include <stddef.h> // size_t
 #include <stdint.h> // uint32_t
 
+#if defined(_MSC_VER)
+#   include <intrin.h> // _Interlocked*, _BitScanReverse, __rdtsc (compiler-provided)
+#elif defined(__x86_64__) || defined(__i386__)
+#   include <x86intrin.h> // __rdtsc
+#endif
+
 // -------------------- Attribute/constexpr defines ---------------------------
 
 #ifdef LA_CXX_17 // Define `LA_CXX_17` macro if C++17 or above used
@@ -156,6 +174,14 @@ namespace la {
         void render_software(const ::la::Window&) noexcept;
         void render_opengl(const ::la::Window&) noexcept;
         void on_geometry_change(::la::Window&, int w, int h) noexcept;
+        void request_geometry_change(::la::Window&, int w, int h) noexcept;
+        // Binds (or releases) the GL context to the calling thread, no-op for software
+        void make_context_current(const ::la::Window&, bool current) noexcept;
+        // The OS destroyed the window (closed by the user, or `~Window()`)
+        void on_window_closed(::la::Window&) noexcept;
+
+        // Kernel sleep until `get_monotonic_ns()` reaches the deadline, no spinning
+        void sleep_until(uint64_t deadline_ns) noexcept;
 
     } // namespace native
 
@@ -169,27 +195,100 @@ namespace la {
     LA_NO_DISCARD void* alloc(size_t size) noexcept;
     void free(void* ptr, size_t size) noexcept;
 
+    // Placement hints for big, long-lived buffers (framebuffers, layer surfaces,
+    // arena blocks). Each one is best effort: what the system refuses is skipped
+    // and the memory is returned anyway
+    enum AllocFlags : uint32_t {
+        ALLOC_DEFAULT     = 0,
+        ALLOC_LARGE_PAGES = 1u << 0, // `get_large_page_size()` pages, fewer TLB misses. Sizes below one get small pages
+        ALLOC_POPULATE    = 1u << 1, // Fault every page in now rather than on first touch
+        ALLOC_LOCK        = 1u << 2, // Keep resident, never paged out (`VirtualLock`/`mlock` limits apply)
+        ALLOC_NUMA_NODE   = 1u << 3, // Take the pages from node `numa_node`
+    }; // enum AllocFlags
+
+    // Zeroed like `alloc(size)`, freed with the same `la::free(ptr, size)`
+    LA_NO_DISCARD void* alloc(size_t size, uint32_t flags, int numa_node = -1) noexcept;
+    // 0 when the process can't get large pages at all
+    LA_NO_DISCARD size_t get_large_page_size() noexcept;
+
 
     // --------------------------- Processing ---------------------------------
 
     void exit_process(int error_code) noexcept; // Exit current process
     void panic_process(const char* explain_msg, int error_code) noexcept;
+    LA_NO_DISCARD uint32_t get_thread_id() noexcept;
 
 
     // --------------------------- Time ---------------------------------------
 
     void sleep(unsigned ms) noexcept;
     LA_NO_DISCARD double get_monotonic_secs() noexcept;
+    // Exact at any uptime, unlike the `double` above. Prefer it for durations
+    LA_NO_DISCARD uint64_t get_monotonic_ns() noexcept;
+    void cpu_relax() noexcept; // Spin-wait hint
+    void yield_thread() noexcept; // Rest of the time slice to another ready thread, if any
+
+    // Deadlines on the `get_monotonic_ns()` clock. The last `spin_ns` are spun with
+    // `cpu_relax()` instead of slept, which hides the OS wake-up latency at the cost
+    // of a busy core; 0 sleeps all the way
+    void sleep_until(uint64_t deadline_ns, uint64_t spin_ns = 0) noexcept;
+    void sleep_for(uint64_t ns, uint64_t spin_ns = 0) noexcept;
+
+    struct SleepError {
+        uint64_t p50_ns{ 0 };
+        uint64_t p99_ns{ 0 };
+        uint64_t max_ns{ 0 };
+    }; // struct SleepError
+
+    // Oversleep of `samples` (up to 256) plain sleeps of `interval_ns` each, blocks for
+    // about their sum. `p99_ns` is a good `spin_ns` for this machine
+    LA_NO_DISCARD SleepError measure_sleep_error(uint64_t interval_ns, unsigned samples) noexcept;
 
 
     // --------------------------- Misc Functions -----------------------------
 
     LA_NO_DISCARD bool is_battery_in_use() noexcept;
+    // Push the process's pages out of RAM, they fault back in on use. Linux pages
+    // out `la::alloc` memory only, Windows empties the whole working set
     void reset_workset() noexcept;
+    // Resident set, 0 when unknown
+    LA_NO_DISCARD size_t get_resident_bytes() noexcept;
+
+    // Whole pages inside [ptr, ptr + size) of `la::alloc` memory. Discarded pages
+    // stay mapped but lose their contents (zero on Linux, undefined on Windows);
+    // paged-out ones keep them and only leave RAM. Without swap, Linux can page
+    // out file-backed memory only
+    void discard_pages(void* ptr, size_t size) noexcept;
+    void page_out(void* ptr, size_t size) noexcept;
+
+    // Share of the last 10 seconds, in percent, that some / all non-idle tasks
+    // spent waiting for memory (Linux PSI)
+    struct MemoryStall {
+        float some{ 0.0f };
+        float full{ 0.0f };
+    }; // struct MemoryStall
+
+    // False when the OS doesn't report it
+    LA_NO_DISCARD bool get_memory_stall(MemoryStall& out) noexcept;
+
+    struct CpuTopology {
+        uint32_t logical{ 0 };    // Hardware threads (Linux: those in the affinity mask)
+        uint32_t cores{ 0 };      // Physical cores holding them
+        uint32_t packages{ 0 };   // Sockets
+        uint32_t numa_nodes{ 0 };
+    }; // struct CpuTopology
+
+    // Every field is at least 1. Reads sysfs on Linux, call it once
+    LA_NO_DISCARD CpuTopology get_cpu_topology() noexcept;
 
     // --------------------------- Input/Output -------------------------------
 
     void print(const char* msg, size_t msg_length) noexcept;
+    // Create or truncate `path`, false when the file couldn't be fully written
+    LA_NO_DISCARD bool write_file(const char* path, const void* data, size_t size) noexcept;
+    // Whole file in `la::alloc` memory, free it with `la::free(data, *size)`. Null on
+    // failure and for empty files
+    LA_NO_DISCARD void* read_file(const char* path, size_t* size) noexcept;
 
     // ---------------------- SIMD system -------------------------------------
 
@@ -207,6 +306,12 @@ public:
     using FillFloat = void (*)(float* out, float value, size_t count);
     using FillInt32 = void (*)(int32_t* out, int32_t value, size_t count);
 
+    // Premultiplied ARGB32 source-over: dst = src * opacity + dst * (1 - src.a * opacity)
+    using BlendArgb32 = void (*)(uint32_t* LA_RESTRICT dst,
+                                 const uint32_t* LA_RESTRICT src,
+                                 uint32_t opacity, // 0..255
+                                 size_t count);
+
     Simd() = delete;
 
     // ======= Hardware dependent =======
@@ -216,29 +321,12 @@ public:
     LA_NO_DISCARD static bool has_avx2() noexcept;
     LA_NO_DISCARD static bool has_avx512bw() noexcept;
 
-    AddFloat static inline choose_add_float(bool sse, bool avx) noexcept {
-        if (avx) return &add_t<float, 8>::apply;
-        if (sse) return &add_t<float, 4>::apply;
-                 return &add_t<float, 1>::apply;
-    }
-
-    AddInt32 static inline choose_add_int32(bool sse2, bool avx2) noexcept {
-        if (avx2) return &add_t<int32_t, 8>::apply;
-        if (sse2) return &add_t<int32_t, 4>::apply;
-                  return &add_t<int32_t, 1>::apply;
-    }
-
-    FillFloat static inline choose_fill_float(bool sse, bool avx) noexcept {
-        if (avx)  return &fill_t<float, 8>::apply;
-        if (sse)  return &fill_t<float, 4>::apply;
-                  return &fill_t<float, 1>::apply;
-    }
-
-    FillInt32 static inline choose_fill_int32(bool sse2, bool avx2) noexcept {
-        if (avx2) return &fill_t<int32_t, 8>::apply;
-        if (sse2) return &fill_t<int32_t, 4>::apply;
-                  return &fill_t<int32_t, 1>::apply;
-    }
+    // Widest available kernel, defined below the specializations
+    LA_NO_DISCARD static inline AddFloat choose_add_float(bool sse, bool avx) noexcept;
+    LA_NO_DISCARD static inline AddInt32 choose_add_int32(bool sse2, bool avx2) noexcept;
+    LA_NO_DISCARD static inline FillFloat choose_fill_float(bool sse, bool avx) noexcept;
+    LA_NO_DISCARD static inline FillInt32 choose_fill_int32(bool sse2, bool avx2) noexcept;
+    LA_NO_DISCARD static inline BlendArgb32 choose_blend_argb32(bool sse2, bool avx2) noexcept;
 
     // ----------------------------- Add --------------------------------------
 
@@ -249,51 +337,427 @@ public:
         } // apply
     }; // struct add_t
 
+    // ----------------------------- Fill -------------------------------------
+
+    // None: T, Width
+    template<typename T, size_t Width> struct fill_t {
+        static inline void apply(T* out, T value, size_t count) noexcept {
+            for (size_t i = 0; i < count; ++i) out[i] = value;
+        }
+    };
+
+    // ----------------------------- Blend ------------------------------------
+
+    // x * a / 255, exact for 8-bit inputs
+    static inline uint32_t mul_div255(uint32_t x, uint32_t a) noexcept {
+        const uint32_t t = x * a + 128;
+        return (t + (t >> 8)) >> 8;
+    }
+
+    // None: Width
+    template<size_t Width> struct blend_t {
+        static inline void apply(uint32_t* LA_RESTRICT dst, const uint32_t* LA_RESTRICT src,
+                                 uint32_t opacity, size_t count) noexcept {
+            for (size_t i = 0; i < count; ++i) {
+                const uint32_t s = src[i];
+                const uint32_t d = dst[i];
+                const uint32_t a = mul_div255(s >> 24, opacity);
+                const uint32_t inv = 255 - a;
+                uint32_t out = 0;
+                for (uint32_t shift = 0; shift < 32; shift += 8) {
+                    const uint32_t sc = mul_div255((s >> shift) & 0xFF, opacity);
+                    const uint32_t dc = mul_div255((d >> shift) & 0xFF, inv);
+                    out |= ((sc + dc) & 0xFF) << shift;
+                }
+                dst[i] = out;
+            }
+        }
+    };
+    }; // struct Simd
+
+    // --------------------- SIMD Specializations -----------------------------
+    // At namespace scope: GCC rejects explicit specializations inside a class
+
     // Specialization for float + SSE
-    template<> struct add_t<float, 4> {
+    template<> struct Simd::add_t<float, 4> {
         static void apply(const float* LA_RESTRICT a, const float* LA_RESTRICT b, float* LA_RESTRICT out, size_t count) noexcept;
     };
 
     // Specialization for float + AVX
-    template<> struct add_t<float, 8> {
-    static void apply(const float* LA_RESTRICT a, const float* LA_RESTRICT b, float* LA_RESTRICT out, size_t count) noexcept;
+    template<> struct Simd::add_t<float, 8> {
+        static void apply(const float* LA_RESTRICT a, const float* LA_RESTRICT b, float* LA_RESTRICT out, size_t count) noexcept;
     };
 
     // Specialization for int32 + AVX2
-    template<> struct add_t<int32_t, 8> {
+    template<> struct Simd::add_t<int32_t, 8> {
         static void apply(const int32_t* LA_RESTRICT a, const int32_t* LA_RESTRICT b, int32_t* LA_RESTRICT out, size_t count) noexcept;
     };
 
-    // ----------------------------- Fill -------------------------------------
-
-    // None: T, Width
-    template<typename T, size_t Width> struct fill_t {
-        static inline void apply(T* out, T value, size_t count) noexcept {
-            for (size_t i = 0; i < count; ++i) out[i] = value;
-        }
-    };
-
     // SSE2: int32_t, 4
-    template<> struct fill_t<int32_t, 4> {
+    template<> struct Simd::fill_t<int32_t, 4> {
         static void apply(int32_t* out, int32_t value, size_t count) noexcept;
     };
 
     // SSE: float, 4
-    template<> struct fill_t<float, 4> {
+    template<> struct Simd::fill_t<float, 4> {
         static void apply(float* out, float value, size_t count) noexcept;
     };
 
     // AVX: float, 8
-    template<> struct fill_t<float, 8> {
+    template<> struct Simd::fill_t<float, 8> {
         static void apply(float* out, float value, size_t count) noexcept;
     };
 
     // AVX2: int, 8
-    template<>
-    struct fill_t<int32_t, 8> {
+    template<> struct Simd::fill_t<int32_t, 8> {
         static void apply(int32_t* out, int32_t value, size_t count) noexcept;
     };
-    }; // struct Simd
+
+    // SSE2: 4 pixels
+    template<> struct Simd::blend_t<4> {
+        static void apply(uint32_t* LA_RESTRICT dst, const uint32_t* LA_RESTRICT src,
+                          uint32_t opacity, size_t count) noexcept;
+    };
+
+    // AVX2: 8 pixels
+    template<> struct Simd::blend_t<8> {
+        static void apply(uint32_t* LA_RESTRICT dst, const uint32_t* LA_RESTRICT src,
+                          uint32_t opacity, size_t count) noexcept;
+    };
+
+    // ----------------------- SIMD Dispatch ----------------------------------
+
+    inline Simd::AddFloat Simd::
+choose_add_float(bool sse, bool avx) noexcept {
+        if (avx) return &add_t<float, 8>::apply;
+        if (sse) return &add_t<float, 4>::apply;
+                 return &add_t<float, 1>::apply;
+    }
+
+    inline Simd::AddInt32 Simd::
+choose_add_int32(bool sse2, bool avx2) noexcept {
+        if (avx2) return &add_t<int32_t, 8>::apply;
+        if (sse2) return &add_t<int32_t, 4>::apply;
+                  return &add_t<int32_t, 1>::apply;
+    }
+
+    inline Simd::FillFloat Simd::
+choose_fill_float(bool sse, bool avx) noexcept {
+        if (avx)  return &fill_t<float, 8>::apply;
+        if (sse)  return &fill_t<float, 4>::apply;
+                  return &fill_t<float, 1>::apply;
+    }
+
+    inline Simd::FillInt32 Simd::
+choose_fill_int32(bool sse2, bool avx2) noexcept {
+        if (avx2) return &fill_t<int32_t, 8>::apply;
+        if (sse2) return &fill_t<int32_t, 4>::apply;
+                  return &fill_t<int32_t, 1>::apply;
+    }
+
+    inline Simd::BlendArgb32 Simd::
+choose_blend_argb32(bool sse2, bool avx2) noexcept {
+        if (avx2) return &blend_t<8>::apply;
+        if (sse2) return &blend_t<4>::apply;
+                  return &blend_t<1>::apply;
+    }
+
+    // ---------------------------- Bits --------------------------------------
+
+    // Index of the highest set bit, `value` must not be 0
+    LA_NO_DISCARD static inline unsigned
+floor_log2(uint64_t value) noexcept {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return static_cast<unsigned>(index);
+#elif defined(_MSC_VER)
+        unsigned long index;
+        if (_BitScanReverse(&index, static_cast<unsigned long>(value >> 32)))
+            return static_cast<unsigned>(index) + 32;
+        _BitScanReverse(&index, static_cast<unsigned long>(value));
+        return static_cast<unsigned>(index);
+#else
+        return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#endif
+    } // floor_log2
+
+    // Index of the lowest set bit, `value` must not be 0
+    LA_NO_DISCARD static inline unsigned
+lowest_bit(uint32_t value) noexcept {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, value);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(value));
+#endif
+    } // lowest_bit
+
+    // ---------------------------- Atomics -----------------------------------
+
+    namespace detail {
+#if defined(_MSC_VER)
+#if defined(_M_IX86) || defined(_M_X64)
+    // x86/x64 ordering: plain loads acquire and plain stores release
+    // as long as the compiler doesn't reorder them
+    static inline void acquire_barrier() noexcept { _ReadWriteBarrier(); }
+    static inline void release_barrier() noexcept { _ReadWriteBarrier(); }
+#elif defined(_M_ARM64)
+    // ARM64 reorders plain accesses in hardware: fence after the load, before the store
+    static inline void acquire_barrier() noexcept { __dmb(_ARM64_BARRIER_ISH); }
+    static inline void release_barrier() noexcept { __dmb(_ARM64_BARRIER_ISH); }
+#else
+#   error "la::Atomic: unsupported MSVC target, only x86, x64 and ARM64"
+#endif
+
+    template<size_t Size> struct AtomicOps;
+
+    template<> struct AtomicOps<4> {
+        using Raw = long;
+        static Raw load(const volatile Raw* p) noexcept { const Raw v = *p; acquire_barrier(); return v; }
+        static void store(volatile Raw* p, Raw v) noexcept { release_barrier(); *p = v; }
+        static Raw add(volatile Raw* p, Raw v) noexcept { return _InterlockedExchangeAdd(p, v); }
+        static Raw exchange(volatile Raw* p, Raw v) noexcept { return _InterlockedExchange(p, v); }
+        static Raw cas(volatile Raw* p, Raw expected, Raw desired) noexcept {
+            return _InterlockedCompareExchange(p, desired, expected);
+        }
+    }; // struct AtomicOps<4>
+
+    template<> struct AtomicOps<8> {
+        using Raw = __int64;
+        static Raw cas(volatile Raw* p, Raw expected, Raw desired) noexcept {
+            return _InterlockedCompareExchange64(p, desired, expected);
+        }
+#if defined(_M_IX86) // No 64-bit loads, stores or adds: everything goes through CAS
+        static Raw load(const volatile Raw* p) noexcept { return cas(const_cast<volatile Raw*>(p), 0, 0); }
+        static Raw exchange(volatile Raw* p, Raw v) noexcept {
+            Raw old = *p;
+            for (Raw seen; (seen = cas(p, old, v)) != old;) old = seen;
+            return old;
+        }
+        static void store(volatile Raw* p, Raw v) noexcept { (void)exchange(p, v); }
+        static Raw add(volatile Raw* p, Raw v) noexcept {
+            Raw old = *p;
+            for (Raw seen; (seen = cas(p, old, old + v)) != old;) old = seen;
+            return old;
+        }
+#else
+        static Raw load(const volatile Raw* p) noexcept { const Raw v = *p; acquire_barrier(); return v; }
+        static void store(volatile Raw* p, Raw v) noexcept { release_barrier(); *p = v; }
+        static Raw add(volatile Raw* p, Raw v) noexcept { return _InterlockedExchangeAdd64(p, v); }
+        static Raw exchange(volatile Raw* p, Raw v) noexcept { return _InterlockedExchange64(p, v); }
+#endif
+    }; // struct AtomicOps<8>
+#endif // _MSC_VER
+    } // namespace detail
+
+    // Integer atomic without <atomic> (unavailable in freestanding builds).
+    // `load`/`store` are acquire/release, read-modify-writes are sequentially consistent
+    template<typename T>
+    struct Atomic {
+        static_assert(sizeof(T) == 4 || sizeof(T) == 8, "Atomic<T> supports 32/64-bit integers");
+
+        explicit LA_CONSTEXPR Atomic(T value = T{}) noexcept : m_value{ value } {}
+        Atomic(const Atomic&) = delete;
+        Atomic& operator=(const Atomic&) = delete;
+
+#if defined(_MSC_VER)
+        using Ops = detail::AtomicOps<sizeof(T)>;
+        using Raw = typename Ops::Raw;
+
+        LA_NO_DISCARD T load() const noexcept { return static_cast<T>(Ops::load(raw())); }
+        LA_NO_DISCARD T load_relaxed() const noexcept { return load(); }
+        void store(T v) noexcept { Ops::store(raw(), static_cast<Raw>(v)); }
+        void store_relaxed(T v) noexcept { store(v); }
+        T fetch_add(T v) noexcept { return static_cast<T>(Ops::add(raw(), static_cast<Raw>(v))); }
+        T exchange(T v) noexcept { return static_cast<T>(Ops::exchange(raw(), static_cast<Raw>(v))); }
+        // On failure `expected` receives the current value
+        bool compare_exchange(T& expected, T desired) noexcept {
+            const Raw seen = Ops::cas(raw(), static_cast<Raw>(expected), static_cast<Raw>(desired));
+            if (seen == static_cast<Raw>(expected)) return true;
+            expected = static_cast<T>(seen);
+            return false;
+        }
+
+    private:
+        volatile Raw* raw() noexcept { return reinterpret_cast<volatile Raw*>(&m_value); }
+        const volatile Raw* raw() const noexcept { return reinterpret_cast<const volatile Raw*>(&m_value); }
+#else
+        LA_NO_DISCARD T load() const noexcept { return __atomic_load_n(&m_value, __ATOMIC_ACQUIRE); }
+        LA_NO_DISCARD T load_relaxed() const noexcept { return __atomic_load_n(&m_value, __ATOMIC_RELAXED); }
+        void store(T v) noexcept { __atomic_store_n(&m_value, v, __ATOMIC_RELEASE); }
+        void store_relaxed(T v) noexcept { __atomic_store_n(&m_value, v, __ATOMIC_RELAXED); }
+        T fetch_add(T v) noexcept { return __atomic_fetch_add(&m_value, v, __ATOMIC_SEQ_CST); }
+        T exchange(T v) noexcept { return __atomic_exchange_n(&m_value, v, __ATOMIC_SEQ_CST); }
+        // On failure `expected` receives the current value
+        bool compare_exchange(T& expected, T desired) noexcept {
+            return __atomic_compare_exchange_n(&m_value, &expected, desired, false,
+                                               __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+        }
+
+    private:
+#endif
+        alignas(sizeof(T)) T m_value;
+    }; // struct Atomic
+
+    // Full barrier: no later load moves above an earlier store, which
+    // acquire/release alone allow (Dekker-style handshakes need it)
+    static inline void
+atomic_fence() noexcept {
+#if defined(_MSC_VER) && defined(_M_ARM64)
+        __dmb(_ARM64_BARRIER_ISH);
+#elif defined(_MSC_VER)
+        long barrier = 0;
+        (void)_InterlockedOr(&barrier, 0); // Locked instruction: drains the store buffer
+#else
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+#endif
+    } // atomic_fence
+
+    // Earlier loads stay above every later load and store (seqlock readers)
+    static inline void
+atomic_acquire_fence() noexcept {
+#if defined(_MSC_VER)
+        detail::acquire_barrier();
+#else
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+#endif
+    } // atomic_acquire_fence
+
+    // Earlier loads and stores stay above every later store (seqlock writers)
+    static inline void
+atomic_release_fence() noexcept {
+#if defined(_MSC_VER)
+        detail::release_barrier();
+#else
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+#endif
+    } // atomic_release_fence
+
+    // ---------------------------- Threads -----------------------------------
+
+    struct ThreadEntry; // Platform trampoline
+
+    /// OS thread running `proc(arg)`. The object must outlive the thread: `join()`
+    /// before destroying or restarting it
+    struct Thread {
+        using Proc = void (*)(void* arg) noexcept;
+
+        Thread() noexcept = default;
+        Thread(const Thread&) = delete;
+        Thread& operator=(const Thread&) = delete;
+
+        LA_NO_DISCARD bool start(Proc proc, void* arg) noexcept;
+        void join() noexcept;
+        LA_NO_DISCARD bool joinable() const noexcept { return m_handle != 0; }
+        // The platform's handle (`HANDLE` on Windows), 0 when not started
+        LA_NO_DISCARD uintptr_t native_handle() const noexcept { return m_handle; }
+
+    private:
+        friend struct ThreadEntry;
+        uintptr_t m_handle{ 0 };
+        Proc m_proc{ nullptr };
+        void* m_arg{ nullptr };
+    }; // struct Thread
+
+    /// Auto-reset wake-up flag: any number of `set()` calls release one `wait()`
+    struct Signal {
+        Signal() noexcept;
+        ~Signal() noexcept;
+        Signal(const Signal&) = delete;
+        Signal& operator=(const Signal&) = delete;
+
+        void set() noexcept;  // Any thread
+        void wait() noexcept; // One waiting thread
+
+    private:
+#if defined(_WIN32)
+        void* m_event{ nullptr };
+#else
+        Atomic<uint32_t> m_state{ 0 }; // Futex word, 1 when set
+#endif
+    }; // struct Signal
+
+    // ---------------------------- Cycle Counter -----------------------------
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#   define LA_HAS_TSC
+#endif
+
+    namespace detail {
+        enum : uint32_t { TSC_UNKNOWN, TSC_CALIBRATING, TSC_READY, TSC_UNAVAILABLE };
+
+        struct TscClock {
+            Atomic<uint32_t> state;
+            uint64_t base_ticks; // Written before `state` becomes TSC_READY
+            uint64_t base_ns;
+            double ns_per_tick;
+        }; // struct TscClock
+
+        extern TscClock g_tsc;
+    } // namespace detail
+
+    // Calibrates the time-stamp counter against `get_monotonic_ns()` once (blocks ~10 ms).
+    // False without an invariant TSC (non-x86, old CPUs, VMs hiding the flag)
+    LA_NO_DISCARD bool tsc_calibrate() noexcept;
+
+    // `get_monotonic_ns()` timebase at a fraction of the cost once calibrated, a plain
+    // `get_monotonic_ns()` until then. Drifts from it by the calibration error and NTP
+    // slewing (a few ppm), so keep it for short intervals such as profiling zones
+    LA_NO_DISCARD static inline uint64_t
+tsc_now_ns() noexcept {
+#if defined(LA_HAS_TSC)
+    if (detail::g_tsc.state.load() == detail::TSC_READY) {
+        // Signed: another core may read a hair before the base
+        const int64_t ticks = static_cast<int64_t>(__rdtsc() - detail::g_tsc.base_ticks);
+        return detail::g_tsc.base_ns + static_cast<uint64_t>(
+            static_cast<int64_t>(static_cast<double>(ticks) * detail::g_tsc.ns_per_tick));
+    }
+#endif
+    return get_monotonic_ns();
+} // tsc_now_ns
+
+    // ---------------------------- Profiling ---------------------------------
+
+    // Define `LA_PROFILE` to record zones, without it the macros expand to nothing
+#if defined(LA_PROFILE)
+#   define LA_PROFILE_CONCAT_(a, b) a##b
+#   define LA_PROFILE_CONCAT(a, b) LA_PROFILE_CONCAT_(a, b)
+#   define LA_PROFILE_ZONE(name) ::la::ProfileZone LA_PROFILE_CONCAT(la_zone_, __LINE__){ name }
+#   define LA_PROFILE_FUNCTION() LA_PROFILE_ZONE(__FUNCTION__)
+#   define LA_PROFILE_ZONE_COUNTERS(name) \
+        ::la::ProfileCounterZone LA_PROFILE_CONCAT(la_zone_, __LINE__){ name }
+#else
+#   define LA_PROFILE_ZONE(name) ((void)0)
+#   define LA_PROFILE_FUNCTION() ((void)0)
+#   define LA_PROFILE_ZONE_COUNTERS(name) ((void)0)
+#endif
+
+    // `name` must outlive the export (string literals, `__FUNCTION__`)
+    void profile_record(const char* name, uint64_t begin_ns, uint64_t end_ns) noexcept;
+    // Chrome trace-event JSON of every thread's ring, open it in Perfetto or chrome://tracing.
+    // Threads may keep recording meanwhile, but only one export may run at a time
+    LA_NO_DISCARD bool profile_export_chrome(const char* path) noexcept;
+    // Frees every thread's ring, before `alloc_leak_report()` at exit. No thread may
+    // be recording meanwhile; any thread that records afterwards gets a new ring
+    void profile_shutdown() noexcept;
+
+    LA_NO_DISCARD static inline uint64_t
+profile_now_ns() noexcept { return tsc_now_ns(); }
+
+    // Records [construction, destruction) into the calling thread's ring
+    struct ProfileZone {
+        explicit inline ProfileZone(const char* name) noexcept
+            : m_name{ name }, m_begin{ profile_now_ns() } {}
+        inline ~ProfileZone() noexcept { profile_record(m_name, m_begin, profile_now_ns()); }
+
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone& operator=(const ProfileZone&) = delete;
+    private:
+        const char* m_name;
+        uint64_t m_begin;
+    }; // struct ProfileZone
 
 struct
 Out {
@@ -536,14 +1000,16 @@ write_float(double value, int precision) noexcept {
             value = -value;
         }
 
-        const int int_part = static_cast<int>(value);
-        double frac_part = value - int_part;
+        // Round once, so 0.9999999 prints as 1.000000 and not 0.1000000
+        const unsigned scale = pow10(precision);
+        const uint64_t scaled = static_cast<uint64_t>(value * scale + 0.5);
+        const uint64_t frac = scaled % scale;
 
-        write_unsigned(static_cast<uint64_t>(int_part));
+        write_unsigned(scaled / scale);
         put('.');
-
-        frac_part *= pow10(precision);
-        write_unsigned(static_cast<uint64_t>(frac_part + 0.5));
+        for (unsigned digit = scale / 10; digit > frac && digit > 1; digit /= 10)
+            put('0'); // Leading zeros of the fraction
+        write_unsigned(frac);
 #endif
     } // write_float
 
@@ -601,10 +1067,11 @@ enum class AboutError : int {
     Win32_CreateCompatibleDc,
     Win32_CreateDibSection,
     Win32_SelectObject,
+    Linux_AllocFramebuffer,
 
-    // MSVC issues in freestanding mode
+    // Freestanding mode
 #ifdef LA_NOSTD
-    Win32_Freestanding_DeleteOperatorCalled,
+    Freestanding_OutOfMemory,
 #endif
 }; // enum class AboutError
 
@@ -637,8 +1104,9 @@ static const char* what(AboutError error) noexcept {
     case AE::Win32_CreateCompatibleDc: return "Couldn't create compatibale DC";
     case AE::Win32_CreateDibSection:   return "Couldn't create DIB section";
     case AE::Win32_SelectObject:       return "Couldn't select object";
+    case AE::Linux_AllocFramebuffer:   return "Couldn't allocate framebuffer";
 #ifdef LA_NOSTD
-    case AE::Win32_Freestanding_DeleteOperatorCalled: return "Operator delete called in freestanding mode";
+    case AE::Freestanding_OutOfMemory: return "Out of memory in operator new";
 #endif
     default: return "unknown error";
     }
@@ -702,7 +1170,6 @@ enum class Key {
     __LAST__
 }; // enum class Key
 
-LA_NO_DISCARD bool is_key_pressed(la::Key) noexcept;
 LA_NO_DISCARD const char* get_key_name(la::Key) noexcept;
 
 // --------------------------- RendererApi ---------------------------
@@ -731,6 +1198,443 @@ struct IWindowEvents {
     }
 };
 
+// --------------------------- Buffered Events ---------------------------
+
+enum class EventType : uint8_t {
+    MouseMove, // `x`, `y`
+    Scroll,    // `scroll`, summed when coalesced
+    KeyDown,   // `key`
+    KeyUp,     // `key`
+    Focus,     // `x`: 1 gained, 0 lost
+    Resize,    // `x`, `y`: client size, only the latest is kept
+}; // enum class EventType
+
+struct Event {
+    uint64_t time_ns{ 0 };  // `get_monotonic_ns()` of the latest OS event folded in
+    EventType type{ EventType::MouseMove };
+    uint32_t merged{ 1 };   // OS events coalesced into this one
+    Key key{ Key::__NONE__ };
+    int x{ 0 };
+    int y{ 0 };
+    float scroll{ 0.f };
+}; // struct Event
+
+// Calls the `on_*` that matches the event
+void dispatch_event(IWindowEvents& handler, const Event& e) noexcept;
+
+namespace detail {
+    // A client size in one word, published with a single atomic store. Never 0,
+    // which stands for "no size pending"
+    LA_NO_DISCARD inline uint64_t
+    pack_size(int w, int h) noexcept {
+        return 1ull << 63 | static_cast<uint64_t>(static_cast<uint32_t>(w) & 0x7FFFFFFFu) << 32 |
+               static_cast<uint32_t>(h);
+    } // pack_size
+
+    inline void
+    unpack_size(uint64_t size, int& w, int& h) noexcept {
+        w = static_cast<int>(size >> 32 & 0x7FFFFFFFu);
+        h = static_cast<int>(static_cast<uint32_t>(size));
+    } // unpack_size
+} // namespace detail
+
+/// Single-producer/single-consumer ring of input events. The producer (the
+/// thread pumping OS messages) keeps the newest mouse move or scroll staged, so
+/// a run of them folds into one event; `flush()` publishes it. The consumer
+/// drains from one other (or the same) thread. A full ring drops new events,
+/// except what the consumer can't do without: the latest size waits in a slot
+/// of its own, and the last `RESERVED` entries are kept for the key-ups and the
+/// focus loss that end what the consumer already saw
+struct EventQueue {
+    LA_CONSTEXPR_VAR static uint32_t CAPACITY = 512; // Power of two
+    LA_CONSTEXPR_VAR static uint32_t KEYS = static_cast<uint32_t>(Key::__LAST__);
+    LA_CONSTEXPR_VAR static uint32_t RESERVED = KEYS + 1;
+    static_assert(RESERVED < CAPACITY / 2, "EventQueue::CAPACITY is too small for the key-up reserve");
+
+    EventQueue() noexcept = default;
+    EventQueue(const EventQueue&) = delete;
+    EventQueue& operator=(const EventQueue&) = delete;
+
+    // Producer
+    void push(const Event& e) noexcept;
+    void flush() noexcept;
+
+    // Consumer. The pending resize comes once the ring is empty
+    LA_NO_DISCARD bool pop(Event& out) noexcept {
+        const uint32_t head = m_head.load_relaxed();
+        if (head == m_tail.load())
+            return take_resize(out);
+        out = m_events[head & (CAPACITY - 1)];
+        m_head.store(head + 1);
+        return true;
+    }
+    // Pops everything published so far into `handler`, returns the count
+    unsigned dispatch(IWindowEvents& handler) noexcept;
+
+    LA_NO_DISCARD uint64_t dropped() const noexcept { return m_dropped.load_relaxed(); }
+
+private:
+    void publish(const Event& e) noexcept;
+    LA_NO_DISCARD bool take_resize(Event& out) noexcept;
+
+    // The event array keeps the consumer's and producer's indices on separate cache lines
+    Atomic<uint32_t> m_head{ 0 }; // Consumer
+    Event m_events[CAPACITY];
+    Atomic<uint32_t> m_tail{ 0 }; // Producer
+    Atomic<uint64_t> m_dropped{ 0 };
+    // Latest size from `detail::pack_size()`, 0 once taken
+    Atomic<uint64_t> m_resize{ 0 };
+    Atomic<uint64_t> m_resize_time{ 0 };
+    Event m_staged;
+    bool m_has_staged{ false };
+
+    // Producer only: the key-downs and focus the consumer will see, so a
+    // reserved entry only ever ends one of them
+    uint64_t m_keys_down[(KEYS + 63) / 64]{};
+    bool m_focused{ true };
+}; // struct EventQueue
+
+// --------------------------- Input State ---------------------------
+
+struct InputSnapshot {
+    LA_CONSTEXPR_VAR static unsigned WORDS = (static_cast<unsigned>(Key::__LAST__) + 63) / 64;
+
+    uint64_t down[WORDS]{};
+    uint64_t went_down[WORDS]{}; // Since the previous snapshot, taps included
+    uint64_t went_up[WORDS]{};
+    int mouse_x{ 0 };
+    int mouse_y{ 0 };
+    int mouse_dx{ 0 }; // Summed since the previous snapshot
+    int mouse_dy{ 0 };
+    float scroll{ 0.f };
+    uint64_t sequence{ 0 }; // 1 for the first published snapshot
+
+    LA_NO_DISCARD bool pressed(Key k) const noexcept { return test(down, k); }
+    LA_NO_DISCARD bool just_pressed(Key k) const noexcept { return test(went_down, k); }
+    LA_NO_DISCARD bool just_released(Key k) const noexcept { return test(went_up, k); }
+
+private:
+    LA_NO_DISCARD static bool test(const uint64_t* bits, Key k) noexcept {
+        const unsigned i = static_cast<unsigned>(k);
+        return (bits[i / 64] >> (i % 64)) & 1;
+    }
+}; // struct InputSnapshot
+
+/// Per-window keyboard and mouse state. The window thread accumulates OS input
+/// and publishes a snapshot once per `poll_events()`. Any thread can copy the
+/// latest one without locks: two buffers and a sequence number that is odd while
+/// a publish writes, readers retry when a publish rewrote the buffer they copied.
+struct InputState {
+    InputState() noexcept = default;
+    InputState(const InputState&) = delete;
+    InputState& operator=(const InputState&) = delete;
+
+    // Writer, the thread pumping OS messages
+    void key(Key k, bool down) noexcept;
+    void mouse_move(int x, int y) noexcept;
+    void scroll(float delta) noexcept { m_working.scroll += delta; }
+    void release_all() noexcept; // Focus lost: no key-up will arrive
+    void publish() noexcept;
+
+    // Reader, any thread
+    LA_NO_DISCARD InputSnapshot snapshot() const noexcept;
+
+private:
+    InputSnapshot m_working;
+    InputSnapshot m_buffers[2];
+    Atomic<uint64_t> m_sequence{ 0 }; // Twice the publishes, +1 during one
+    bool m_has_mouse{ false }; // No delta for the first move
+}; // struct InputState
+
+// --------------------------- Performance Counters ---------------------------
+
+enum class PerfCounter : uint8_t {
+    Cycles,
+    Instructions,
+    LlcMisses,    // Last-level cache
+    BranchMisses,
+    DtlbMisses,   // Data TLB, loads
+    __LAST__
+}; // enum class PerfCounter
+
+struct PerfSample {
+    LA_CONSTEXPR_VAR static unsigned COUNT = static_cast<unsigned>(PerfCounter::__LAST__);
+
+    uint64_t values[COUNT]{};
+    uint8_t valid{ 0 }; // Bit per counter that is actually counting
+    // Of the whole group: time it was enabled, and time it really held hardware
+    // counters. Less running than enabled means the kernel multiplexed it
+    uint64_t time_enabled{ 0 };
+    uint64_t time_running{ 0 };
+
+    LA_NO_DISCARD bool has(PerfCounter c) const noexcept {
+        return (valid >> static_cast<unsigned>(c)) & 1;
+    }
+    LA_NO_DISCARD uint64_t operator[](PerfCounter c) const noexcept {
+        return values[static_cast<unsigned>(c)];
+    }
+    // Counts scaled up to the whole interval when it was multiplexed. The group's
+    // counters share one schedule, so ratios such as IPC are never skewed by it
+    LA_NO_DISCARD PerfSample operator-(const PerfSample& begin) const noexcept {
+        PerfSample delta;
+        delta.valid = valid & begin.valid;
+        delta.time_enabled = time_enabled - begin.time_enabled;
+        delta.time_running = time_running - begin.time_running;
+        if (delta.time_enabled && !delta.time_running) delta.valid = 0; // Never scheduled
+        const bool scale = delta.time_running && delta.time_running < delta.time_enabled;
+        const double factor = scale ? static_cast<double>(delta.time_enabled) /
+                                      static_cast<double>(delta.time_running) : 1.0;
+        for (unsigned i = 0; i < COUNT; ++i) {
+            const uint64_t raw = values[i] - begin.values[i];
+            delta.values[i] = scale ? static_cast<uint64_t>(static_cast<double>(raw) * factor) : raw;
+        }
+        return delta;
+    }
+    // Instructions per cycle, 0 when either counter is missing
+    LA_NO_DISCARD double ipc() const noexcept {
+        if (!has(PerfCounter::Cycles) || !has(PerfCounter::Instructions) ||
+            values[static_cast<unsigned>(PerfCounter::Cycles)] == 0)
+            return 0.0;
+        return static_cast<double>(values[static_cast<unsigned>(PerfCounter::Instructions)]) /
+               static_cast<double>(values[static_cast<unsigned>(PerfCounter::Cycles)]);
+    }
+}; // struct PerfSample
+
+/// Hardware counters of the thread that calls `open()`, user mode only. Linux
+/// uses `perf_event_open` with the counters in one group, so they are always
+/// scheduled together; counters the kernel refuses (perf_event_paranoid,
+/// containers, VMs) are just missing from the samples. Other platforms
+/// open nothing. Plain data so it can live in `thread_local` storage:
+/// pair `open()` with `close()`.
+struct PerfCounters {
+    LA_NO_DISCARD bool open() noexcept; // True when at least one counter counts
+    void close() noexcept;
+    LA_NO_DISCARD PerfSample read() const noexcept;
+    LA_NO_DISCARD bool is_open() const noexcept { return m_valid != 0; }
+
+private:
+    int m_fds[PerfSample::COUNT]{ -1, -1, -1, -1, -1 };
+    uint8_t m_valid{ 0 };
+}; // struct PerfCounters
+
+// Zone with the hardware counters it spent attached, see `LA_PROFILE_ZONE_COUNTERS`.
+// The delta includes the two counter reads, so keep it around work of a few µs or more
+void profile_record_counters(const char* name, uint64_t begin_ns, uint64_t end_ns,
+                             const PerfSample& delta) noexcept;
+// Calling thread's counters, opened on first use; empty when unavailable
+LA_NO_DISCARD PerfSample profile_read_counters() noexcept;
+
+struct ProfileCounterZone {
+    explicit inline ProfileCounterZone(const char* name) noexcept
+        : m_name{ name }, m_counters{ profile_read_counters() }, m_begin{ profile_now_ns() } {}
+    inline ~ProfileCounterZone() noexcept {
+        const uint64_t end = profile_now_ns();
+        profile_record_counters(m_name, m_begin, end, profile_read_counters() - m_counters);
+    }
+
+    ProfileCounterZone(const ProfileCounterZone&) = delete;
+    ProfileCounterZone& operator=(const ProfileCounterZone&) = delete;
+private:
+    const char* m_name;
+    PerfSample m_counters;
+    uint64_t m_begin;
+}; // struct ProfileCounterZone
+
+// --------------------------- Allocation Telemetry ---------------------------
+
+// Define `LA_ALLOC_TELEMETRY` to count `la::alloc`/`la::free`, the pool and the heap
+// per tag. Each thread bumps its own counters without atomic read-modify-writes,
+// cheap enough for release builds. Without it the hooks compile to nothing and
+// every counter reads zero
+#if defined(LA_ALLOC_TELEMETRY)
+#   define LA_ALLOC_TAG_CONCAT_(a, b) a##b
+#   define LA_ALLOC_TAG_CONCAT(a, b) LA_ALLOC_TAG_CONCAT_(a, b)
+#   define LA_ALLOC_TAG(tag) ::la::AllocTagScope LA_ALLOC_TAG_CONCAT(la_tag_, __LINE__){ tag }
+#else
+#   define LA_ALLOC_TAG(tag) ((void)0)
+#endif
+
+enum class AllocTag : uint8_t {
+    General,     // Outside any `LA_ALLOC_TAG`
+    Arena,       // `la::Arena` blocks, display lists included
+    Pool,        // Pool slabs and large heap blocks
+    Heap,        // Untagged `pool_alloc`/`heap_alloc` objects, see `AllocLayer`
+    Surface,     // Compositor layer surfaces
+    Framebuffer, // Window pixels, even when the OS allocates them
+    Profiler,    // Zone rings are kept until `profile_shutdown()`
+    Ui,
+    Replay,
+    Jobs,        // Job system workers and queues
+    User0,       // Free for the application
+    User1,
+    User2,
+    User3,
+    __LAST__
+}; // enum class AllocTag
+
+// Memory is counted at two layers that overlap. `System` is what `la::alloc` mapped,
+// pool slabs and large heap blocks under `AllocTag::Pool`. `Heap` is the objects
+// `pool_alloc`/`heap_alloc` handed out of those, under the caller's tag (`Heap`
+// when untagged). Sum tags within one layer only
+enum class AllocLayer : uint8_t {
+    System,
+    Heap,
+    __LAST__
+}; // enum class AllocLayer
+
+struct AllocTagStats {
+    uint64_t live_bytes{ 0 };
+    uint64_t live_count{ 0 };
+    uint64_t peak_bytes{ 0 };      // Highest `live_bytes` sampled by a frame end or a query
+    uint64_t total_bytes{ 0 };     // Allocated since start
+    uint64_t total_count{ 0 };
+    uint64_t frame_bytes{ 0 };     // Allocated during the last finished frame
+    uint64_t frame_count{ 0 };
+    uint64_t max_frame_bytes{ 0 }; // Worst frame so far
+}; // struct AllocTagStats
+
+struct AllocTelemetry {
+    LA_CONSTEXPR_VAR static unsigned TAGS = static_cast<unsigned>(AllocTag::__LAST__);
+    LA_CONSTEXPR_VAR static unsigned LAYERS = static_cast<unsigned>(AllocLayer::__LAST__);
+
+    AllocTagStats tags[LAYERS][TAGS]{};
+    uint64_t frames{ 0 };
+
+    LA_NO_DISCARD const AllocTagStats& operator[](AllocTag tag) const noexcept {
+        return tags[static_cast<unsigned>(AllocLayer::System)][static_cast<unsigned>(tag)];
+    }
+    LA_NO_DISCARD const AllocTagStats& get(AllocLayer layer, AllocTag tag) const noexcept {
+        return tags[static_cast<unsigned>(layer)][static_cast<unsigned>(tag)];
+    }
+}; // struct AllocTelemetry
+
+LA_NO_DISCARD const char* alloc_tag_name(AllocTag tag) noexcept;
+LA_NO_DISCARD const char* alloc_layer_name(AllocLayer layer) noexcept;
+// Closes the per-frame counts and samples the peaks, once per frame from one thread
+void alloc_telemetry_frame() noexcept;
+// Any thread. Counters of other threads may be a few allocations behind
+LA_NO_DISCARD AllocTelemetry alloc_telemetry() noexcept;
+void alloc_telemetry_dump(Out& out) noexcept;
+// Tags with allocations still live, for shutdown. Returns how many there are
+uint64_t alloc_leak_report(Out& out) noexcept;
+
+namespace detail {
+#if defined(LA_ALLOC_TELEMETRY)
+    LA_NO_DISCARD AllocTag swap_alloc_tag(AllocTag tag) noexcept; // Returns the previous one
+    LA_NO_DISCARD AllocTag current_alloc_tag() noexcept;
+    void telemetry_alloc(AllocTag tag, size_t bytes, AllocLayer layer = AllocLayer::System) noexcept;
+    void telemetry_free(AllocTag tag, size_t bytes, AllocLayer layer = AllocLayer::System) noexcept;
+#else
+    LA_NO_DISCARD static inline AllocTag swap_alloc_tag(AllocTag) noexcept { return AllocTag::General; }
+    LA_NO_DISCARD static inline AllocTag current_alloc_tag() noexcept { return AllocTag::General; }
+    static inline void telemetry_alloc(AllocTag, size_t, AllocLayer = AllocLayer::System) noexcept {}
+    static inline void telemetry_free(AllocTag, size_t, AllocLayer = AllocLayer::System) noexcept {}
+#endif
+} // namespace detail
+
+// Tags the calling thread's `la::alloc`/`la::free` until destroyed, see `LA_ALLOC_TAG`.
+// A block must be freed under the tag it was allocated with
+struct AllocTagScope {
+    explicit inline AllocTagScope(AllocTag tag) noexcept : m_saved{ detail::swap_alloc_tag(tag) } {}
+    inline ~AllocTagScope() noexcept { (void)detail::swap_alloc_tag(m_saved); }
+
+    AllocTagScope(const AllocTagScope&) = delete;
+    AllocTagScope& operator=(const AllocTagScope&) = delete;
+private:
+    AllocTag m_saved;
+}; // struct AllocTagScope
+
+// --------------------------- Frame Timings ---------------------------
+
+enum class FramePhase : uint8_t {
+    Poll,    // `poll_events()`
+    Handler, // `on_render_*()` minus presenting
+    Present, // `swap_buffer_*()` and the native blit
+    Idle,    // Between frames: pacing, user code outside the window
+    Frame,   // Whole frame, end to end
+    __LAST__
+}; // enum class FramePhase
+
+struct FramePercentiles {
+    uint64_t count{ 0 };
+    uint64_t p50_ns{ 0 };
+    uint64_t p95_ns{ 0 };
+    uint64_t p99_ns{ 0 };
+    uint64_t max_ns{ 0 };
+}; // struct FramePercentiles
+
+/// Rolling log-bucket histograms per phase. Written by the window thread,
+/// readable from any thread without locks. Buckets are 4 per power of two
+/// (at most 25% wide), the window covers the last `SLOTS * FRAMES_PER_SLOT`
+/// frames and the oldest slot is dropped as a whole.
+struct FrameTimings {
+    LA_CONSTEXPR_VAR static unsigned PHASES = static_cast<unsigned>(FramePhase::__LAST__);
+    LA_CONSTEXPR_VAR static unsigned BUCKETS = 4 * 40; // Up to ~1100 s
+    LA_CONSTEXPR_VAR static unsigned SLOTS = 4;
+    LA_CONSTEXPR_VAR static uint32_t FRAMES_PER_SLOT = 256;
+
+    explicit inline FrameTimings() noexcept = default;
+
+    FrameTimings(const FrameTimings&) = delete;
+    FrameTimings& operator=(const FrameTimings&) = delete;
+
+    LA_NO_DISCARD static inline uint64_t
+now_ns() noexcept { return ::la::get_monotonic_ns(); }
+
+    LA_NO_DISCARD static inline unsigned
+bucket_of(uint64_t ns) noexcept {
+        if (ns < 4) return static_cast<unsigned>(ns);
+        const unsigned e = floor_log2(ns);
+        const unsigned index = 4 * (e - 1) + static_cast<unsigned>((ns >> (e - 2)) & 3);
+        return index < BUCKETS ? index : BUCKETS - 1;
+    }
+    // Inclusive upper bound of a bucket
+    LA_NO_DISCARD static inline uint64_t
+bucket_limit(unsigned index) noexcept {
+        if (index < 4) return index;
+        const unsigned e = index / 4 + 1;
+        return ((static_cast<uint64_t>(4 + index % 4 + 1)) << (e - 2)) - 1;
+    }
+
+    // Single writer: plain relaxed read-modify-write, no locked instructions
+    inline void
+record(FramePhase phase, uint64_t ns) noexcept {
+        const unsigned p = static_cast<unsigned>(phase);
+        const uint32_t slot = m_slot.load_relaxed();
+        Atomic<uint32_t>& bucket = m_counts[p][slot][bucket_of(ns)];
+        bucket.store_relaxed(bucket.load_relaxed() + 1);
+        Atomic<uint64_t>& max = m_max[p][slot];
+        if (ns > max.load_relaxed()) max.store_relaxed(ns);
+    }
+
+    // Rotates the window every `FRAMES_PER_SLOT` frames, true when it did
+    bool end_frame() noexcept;
+
+    LA_NO_DISCARD FramePercentiles percentiles(FramePhase phase) const noexcept;
+    LA_NO_DISCARD uint64_t frames() const noexcept { return m_frames.load_relaxed(); }
+    void dump(Out& out) const noexcept;
+
+    // Counter deltas of one frame, summed per slot like the histograms
+    void record_perf(const PerfSample& delta, uint64_t pixels) noexcept;
+    // Sum over the window, `frames` and `pixels` cover the same frames
+    LA_NO_DISCARD PerfSample perf_totals(uint64_t* frames, uint64_t* pixels) const noexcept;
+
+    // Frame marks, owned by the window thread
+    uint64_t frame_end_ns{ 0 }; // End of the previous frame
+    uint64_t poll_ns{ 0 };      // Accumulated since, polls may repeat between frames
+    uint64_t present_ns{ 0 };   // Inside the current handler
+
+private:
+    Atomic<uint32_t> m_counts[PHASES][SLOTS][BUCKETS];
+    Atomic<uint64_t> m_max[PHASES][SLOTS];
+    Atomic<uint32_t> m_slot{ 0 };
+    Atomic<uint64_t> m_frames{ 0 };
+    // Counters, then frames and pixels
+    Atomic<uint64_t> m_perf[SLOTS][PerfSample::COUNT + 2];
+    Atomic<uint32_t> m_perf_valid{ 0 };
+    uint32_t m_slot_frames{ 0 };
+}; // struct FrameTimings
+
 // --------------------------- Native Window ---------------------------
 struct native::Window {
 #if defined(__linux__)
@@ -738,6 +1642,7 @@ struct native::Window {
 #elif defined(_WIN32)
     void* hdc{ nullptr };
     void* hwnd{ nullptr };
+    void* wake_event{ nullptr }; // Auto-reset, signaled by `la::Window::wake()`
 #endif
 
     explicit inline Window() noexcept = default;
@@ -756,9 +1661,17 @@ struct native::Framebuffer {
 #elif defined(_WIN32)
     void* hdc{ nullptr };
     void* bmp{ nullptr };
-    void* pixels{ nullptr };
 #endif // Platform
 
+    void* pixels{ nullptr };  // 32-bit ARGB, CPU-accessible
+    int width{ 0 };           // Visible size
+    int height{ 0 };
+    int stride{ 0 };          // Pixels per row, `stride >= width`
+    int capacity_height{ 0 }; // Allocated rows, `capacity_height >= height`
+    // `la::AllocFlags` for the next allocation. On Windows GDI owns the pixels:
+    // only `ALLOC_POPULATE` and `ALLOC_LOCK` apply
+    uint32_t alloc_flags{ ALLOC_DEFAULT };
+
     explicit inline Framebuffer() noexcept = default;
     ~Framebuffer() noexcept;
 
@@ -767,11 +1680,19 @@ struct native::Framebuffer {
     Framebuffer(Framebuffer&&) = delete;
     Framebuffer& operator=(Framebuffer&&) = delete;
 
-    LA_NO_DISCARD la::AboutError recreate(
-        const la::Window& win, int width, int height) noexcept;
+    // Reuses the allocation when the new size fits, otherwise grows it geometrically.
+    // Needs no window: on Windows the DIB is made for the screen, on Linux it is
+    // `la::alloc` memory
+    LA_NO_DISCARD la::AboutError resize(int width, int height) noexcept;
+    LA_NO_DISCARD la::AboutError resize(const la::Window&, int width_, int height_) noexcept {
+        return resize(width_, height_);
+    }
 
     void clear(uint32_t color, int width, int height) const noexcept;
     void draw_pixel(int x, int y, int width, int height, uint32_t color) const noexcept;
+
+private:
+    void release() noexcept;
 }; // struct Framebuffer
 
 // --------------------------- Opengl Context ---------------------------
@@ -792,10 +1713,16 @@ struct native::OpenglContext {
 }; // struct OpenglContext
 
 // --------------------------- Window ---------------------------
+/// Windows are independent: each owns its framebuffer or GL context and can be
+/// created, pumped and rendered on its own thread, or share one thread with
+/// others. A thread's OS messages belong to the windows it created; closing
+/// one ends that window's `poll_events()` loop, the thread's last one quits.
 struct Window {
     using Native = ::la::native::Window;
     using Framebuffer = ::la::native::Framebuffer;
     using GlContext = ::la::native::OpenglContext;
+
+    LA_CONSTEXPR_VAR static uint64_t WAIT_FOREVER = ~0ull;
     
     explicit Window(IWindowEvents& handler, int w = 640, int h = 480,
                     RendererApi api = RendererApi::Software, 
@@ -828,26 +1755,69 @@ struct Window {
 
     // Getters: window properties
 
+    // False once this window closed or the thread received a quit message
     LA_NO_DISCARD bool poll_events() const noexcept;
-    LA_NO_DISCARD IWindowEvents& handler() const noexcept { return m_handler; }
+    // Block in the OS until input, a `wake()` or `timeout_ns`, then `poll_events()`.
+    // Idle apps take no CPU this way
+    LA_NO_DISCARD bool wait_events(uint64_t timeout_ns = WAIT_FOREVER) const noexcept;
+    // Ends a `wait_events()` early, callable from any thread
+    void wake() const noexcept;
+    // Input queued by the OS callbacks while buffering, see `set_event_buffering()`
+    LA_NO_DISCARD EventQueue& events() const noexcept { return m_events; }
+    LA_NO_DISCARD bool is_event_buffering() const noexcept { return m_buffer_events; }
+    // Input as of the last `poll_events()`: take one copy per frame, from any thread
+    LA_NO_DISCARD InputSnapshot input() const noexcept { return m_input.snapshot(); }
+    LA_NO_DISCARD InputState& input_state() const noexcept { return m_input; }
+    LA_NO_DISCARD IWindowEvents& handler() const noexcept { return *m_handler; }
     LA_NO_DISCARD const Native& native() const noexcept { return m_native; }
+    // From creation until the OS destroys the window, readable from any thread
+    LA_NO_DISCARD bool is_open() const noexcept { return m_open.load() != 0; }
     
-    LA_NO_DISCARD int width() const noexcept { return m_width; }
-    LA_NO_DISCARD int height() const noexcept { return m_height; }
+    // Applied size, readable from any thread
+    LA_NO_DISCARD int width() const noexcept { int w, h; detail::unpack_size(m_size.load_relaxed(), w, h); return w; }
+    LA_NO_DISCARD int height() const noexcept { int w, h; detail::unpack_size(m_size.load_relaxed(), w, h); return h; }
+    LA_NO_DISCARD bool is_geometry_pending() const noexcept { return m_pending_geometry.load() != 0; }
+    LA_NO_DISCARD const FrameTimings& timings() const noexcept { return m_timings; }
 
     // Setters
 
-    void set_handler(IWindowEvents& handler) noexcept { m_handler = handler; }
+    void set_handler(IWindowEvents& handler) noexcept { m_handler = &handler; }
     void set_renderer(RendererApi api) noexcept;
     void set_title(const char *title) const noexcept;
     void set_fullscreen(bool) const noexcept;
     void set_cursor_visible(bool) const noexcept;
+    // Print the timing percentiles through `la::Out` whenever the window rotates
+    void set_timings_dump(bool enabled) noexcept { m_dump_timings = enabled; }
+    // Opt-in render thread: `on_render_*()` and the input handlers run there, fed by
+    // `events()`; the calling thread only pumps messages. The render thread owns the
+    // framebuffer and GL context until `stop_render_thread()`, resizes reach it as
+    // messages. `continuous` renders back to back, otherwise only when woken
+    // (input, resize, `WM_PAINT`, `request_redraw()`)
+    LA_NO_DISCARD bool start_render_thread(bool continuous = false) noexcept;
+    void stop_render_thread() noexcept;
+    void request_redraw() const noexcept { m_render_signal.set(); }
+    LA_NO_DISCARD bool is_render_threaded() const noexcept { return m_render_threaded; }
+
+    // Queue input into `events()` instead of calling the handler from inside the OS
+    // callbacks; drain it with `events().dispatch(handler())` or `events().pop()`
+    void set_event_buffering(bool enabled) noexcept { m_buffer_events = enabled; }
+    // Hardware counters per frame (IPC, misses per pixel), false when unavailable.
+    // They count the thread running `render()`, which opens them on its next frame
+    bool set_perf_counters(bool enabled) noexcept {
+        m_perf_wanted.store(enabled ? 1 : 0);
+        if (!enabled) return true;
+        PerfCounters probe;
+        const bool available = probe.open();
+        probe.close();
+        return available;
+    }
 
 
 
 private:
-    IWindowEvents& m_handler;
+    IWindowEvents* m_handler; // Pointer: `set_handler()` rebinds it
     Native m_native;
+    Atomic<uint32_t> m_open{ 0 };
 
     RendererApi m_renderer_api{ RendererApi::None };
     union {
@@ -855,13 +1825,41 @@ private:
         GlContext m_gl;
     };
     
-    int m_width;
-    int m_height;
+    Atomic<uint64_t> m_size; // `detail::pack_size()`, set by whichever thread runs `render()`
+
+    // Latest size reported by the OS, applied once per frame by `render()`. Written
+    // by the message thread, taken by the render thread: `detail::pack_size()`, 0 when none
+    Atomic<uint64_t> m_pending_geometry{ 0 };
+
+    // Written by const procedures too (`poll_events()`, `swap_buffer_*()`)
+    mutable FrameTimings m_timings;
+    bool m_dump_timings{ false };
+    PerfCounters m_perf;       // Owned by the thread running `render()`
+    uint32_t m_perf_thread{ 0 }; // The one `m_perf` counts, 0 when closed
+    Atomic<uint32_t> m_perf_wanted{ 0 };
+
+    mutable EventQueue m_events; // Filled by `poll_events()`, a const procedure
+    mutable InputState m_input;
+    bool m_buffer_events{ false };
+
+    static void render_thread_main(void* window) noexcept;
+    void drain_render_messages() noexcept;
+
+    Thread m_render_thread;
+    mutable Signal m_render_signal;
+    Atomic<uint32_t> m_render_stop{ 0 };
+    bool m_render_threaded{ false };
+    bool m_render_continuous{ false };
+    bool m_buffer_events_before{ false }; // Restored by `stop_render_thread()`
 
     friend void native::on_geometry_change(::la::Window&, int w, int h) noexcept;
+    friend void native::request_geometry_change(::la::Window&, int w, int h) noexcept;
+    friend void native::on_window_closed(::la::Window&) noexcept;
 }; // struct Window
 
 inline Window::~Window() noexcept {
+    stop_render_thread();
+    m_perf.close();
     switch (renderer_api()) {
     case RendererApi::Software: fb().~Framebuffer(); break;
     case RendererApi::Opengl:   gl().~GlContext();   break;
@@ -870,17 +1868,72 @@ inline Window::~Window() noexcept {
 };
 
 inline void Window::render() noexcept {
+    LA_PROFILE_ZONE("Window::render");
+    // Counters count the thread that opened them: follow `render()` across threads
+    if (m_perf_wanted.load_relaxed()) {
+        const uint32_t thread = get_thread_id();
+        if (thread != m_perf_thread) {
+            m_perf_thread = thread;
+            (void)m_perf.open(); // Closes the previous thread's
+        }
+    } else if (m_perf_thread) {
+        m_perf.close();
+        m_perf_thread = 0;
+    }
+
+    const uint64_t begin = FrameTimings::now_ns();
+    const PerfSample perf_begin = m_perf.is_open() ? m_perf.read() : PerfSample{};
+
+    // Coalesced resize: any number of size events cost one reallocation per frame
+    if (const uint64_t size = m_pending_geometry.exchange(0)) {
+        int w, h;
+        detail::unpack_size(size, w, h);
+        native::on_geometry_change(*this, w, h);
+    }
+
+    uint64_t handled = begin;
     switch (renderer_api())
     {
-    case RendererApi::Software:
-        m_handler.on_render_software();
+    case RendererApi::Software: {
+        { LA_PROFILE_ZONE("on_render_software"); m_handler->on_render_software(); }
+        handled = FrameTimings::now_ns();
+        LA_PROFILE_ZONE("native::render_software");
         native::render_software(*this);
         break;
-    case RendererApi::Opengl:
-        m_handler.on_render_opengl();
+    }
+    case RendererApi::Opengl: {
+        native::make_context_current(*this, true); // Another window on this thread may own it
+        { LA_PROFILE_ZONE("on_render_opengl"); m_handler->on_render_opengl(); }
+        handled = FrameTimings::now_ns();
+        LA_PROFILE_ZONE("native::render_opengl");
         native::render_opengl(*this);
         break;
+    }
     } // switch
+
+    const uint64_t end = FrameTimings::now_ns();
+    FrameTimings& t = m_timings;
+    if (m_perf.is_open()) {
+        const PerfSample delta = m_perf.read() - perf_begin;
+        if (delta.valid)
+            t.record_perf(delta, static_cast<uint64_t>(width()) * static_cast<uint64_t>(height()));
+    }
+    if (t.frame_end_ns) {
+        const uint64_t between = begin - t.frame_end_ns;
+        t.record(FramePhase::Idle, between > t.poll_ns ? between - t.poll_ns : 0);
+        t.record(FramePhase::Frame, end - t.frame_end_ns);
+    }
+    const uint64_t handler = handled - begin;
+    t.record(FramePhase::Poll, t.poll_ns);
+    t.record(FramePhase::Handler, handler > t.present_ns ? handler - t.present_ns : 0);
+    t.record(FramePhase::Present, t.present_ns + (end - handled));
+    t.frame_end_ns = end;
+    t.poll_ns = t.present_ns = 0;
+
+    if (t.end_frame() && m_dump_timings) {
+        Out out;
+        t.dump(out);
+    }
 } // render
 
 
@@ -888,6 +1941,7 @@ extern Simd::AddFloat  add_float;
 extern Simd::AddInt32  add_int32;
 extern Simd::FillFloat fill_float;
 extern Simd::FillInt32 fill_int32;
+extern Simd::BlendArgb32 blend_argb32;
 
 struct GlobalInitializer {
 private:
@@ -896,6 +1950,7 @@ private:
         add_int32 = Simd::choose_add_int32(sse2, avx2);
         fill_float = Simd::choose_fill_float(sse, avx);
         fill_int32 = Simd::choose_fill_int32(sse2, avx2);
+        blend_argb32 = Simd::choose_blend_argb32(sse2, avx2);
     }
 public:
     static void init() noexcept;
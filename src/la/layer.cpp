@@ -0,0 +1,203 @@
+#include "layer.hpp"
+
+namespace la {
+
+// ------------------------------ Layer ---------------------------------------
+
+Layer::
+~Layer() noexcept {
+    detach();
+
+    // Orphan the children, they are owned by the caller
+    Layer* child = m_first_child;
+    while (child) {
+        Layer* next = child->m_next_sibling;
+        child->m_parent = nullptr;
+        child->m_prev_sibling = child->m_next_sibling = nullptr;
+        child = next;
+    }
+
+    if (m_cache_owner)
+        m_cache_owner->release(*this);
+} // ~Layer
+
+DisplayList& Layer::
+record() noexcept {
+    m_content.reset();
+    m_dirty = true;
+    return m_content;
+} // record
+
+void Layer::
+add_child(Layer& child) noexcept {
+    child.detach();
+    child.m_parent = this;
+    child.m_prev_sibling = m_last_child;
+    if (m_last_child) m_last_child->m_next_sibling = &child;
+    else              m_first_child = &child;
+    m_last_child = &child;
+} // add_child
+
+void Layer::
+detach() noexcept {
+    if (!m_parent) return;
+
+    if (m_prev_sibling) m_prev_sibling->m_next_sibling = m_next_sibling;
+    else                m_parent->m_first_child = m_next_sibling;
+    if (m_next_sibling) m_next_sibling->m_prev_sibling = m_prev_sibling;
+    else                m_parent->m_last_child = m_prev_sibling;
+
+    m_parent = nullptr;
+    m_prev_sibling = m_next_sibling = nullptr;
+} // detach
+
+// ------------------------------ Compositor ----------------------------------
+
+Compositor::
+~Compositor() noexcept {
+    while (m_cached)
+        release(*m_cached);
+} // ~Compositor
+
+void Compositor::
+release(Layer& layer) noexcept {
+    Surface& surface = layer.m_surface;
+    if (surface.pixels) {
+        LA_ALLOC_TAG(AllocTag::Surface);
+        ::la::free(surface.pixels, surface.bytes);
+        m_used -= surface.bytes;
+    }
+    surface = Surface{};
+
+    if (layer.m_prev_cached) layer.m_prev_cached->m_next_cached = layer.m_next_cached;
+    else                     m_cached = layer.m_next_cached;
+    if (layer.m_next_cached) layer.m_next_cached->m_prev_cached = layer.m_prev_cached;
+
+    layer.m_next_cached = layer.m_prev_cached = nullptr;
+    layer.m_cache_owner = nullptr;
+    layer.m_dirty = true; // Must be re-rasterized when visible again
+} // release
+
+void Compositor::
+evict_for(size_t bytes) noexcept {
+    // Least recently used first, surfaces of the current frame are kept
+    while (m_used + bytes > m_budget) {
+        Layer* victim = nullptr;
+        for (Layer* l = m_cached; l; l = l->m_next_cached) {
+            if (l->m_last_used >= m_frame) continue;
+            if (!victim || l->m_last_used < victim->m_last_used)
+                victim = l;
+        }
+        if (!victim) return; // Everything is on screen, go over budget
+        release(*victim);
+        ++m_stats.evicted;
+    }
+} // evict_for
+
+void Compositor::
+trim(size_t budget_bytes) noexcept {
+    const size_t saved = m_budget;
+    m_budget = budget_bytes;
+    evict_for(0);
+    m_budget = saved;
+} // trim
+
+size_t Compositor::
+page_out() noexcept {
+    for (Layer* l = m_cached; l; l = l->m_next_cached)
+        ::la::page_out(l->m_surface.pixels, l->m_surface.bytes);
+    return m_used;
+} // page_out
+
+bool Compositor::
+rasterize(Layer& layer) noexcept {
+    LA_PROFILE_FUNCTION();
+    if (layer.m_cache_owner && layer.m_cache_owner != this)
+        layer.m_cache_owner->release(layer);
+
+    // Rows padded to 8 pixels, the allocation is reused while it fits
+    const int stride = (layer.width + 7) & ~7;
+    const size_t need = static_cast<size_t>(stride) * layer.height * sizeof(uint32_t);
+    Surface& surface = layer.m_surface;
+
+    if (surface.bytes < need) {
+        if (surface.pixels)
+            release(layer);
+        evict_for(need);
+
+        LA_ALLOC_TAG(AllocTag::Surface);
+        surface.pixels = static_cast<uint32_t*>(::la::alloc(need, m_alloc_flags));
+        if (!surface.pixels)
+            return false;
+        surface.bytes = need;
+        m_used += need;
+
+        layer.m_cache_owner = this;
+        layer.m_prev_cached = nullptr;
+        layer.m_next_cached = m_cached;
+        if (m_cached) m_cached->m_prev_cached = &layer;
+        m_cached = &layer;
+    }
+
+    surface.width = layer.width;
+    surface.height = layer.height;
+    surface.stride = stride;
+
+    Canvas canvas = surface.canvas();
+    if (!layer.opaque)
+        canvas.clear(0); // Transparent
+    layer.m_content.replay(canvas);
+
+    layer.m_dirty = false;
+    ++m_stats.rasterized;
+    return true;
+} // rasterize
+
+void Compositor::
+draw(Layer& layer, Canvas& target, int origin_x, int origin_y,
+     const Rect& clip, uint32_t opacity) noexcept {
+    const uint32_t alpha = Simd::mul_div255(opacity, layer.opacity);
+    if (alpha == 0) return;
+
+    const int lx = origin_x + layer.x;
+    const int ly = origin_y + layer.y;
+    const Rect layer_clip = layer.clip.translate(lx, ly).intersect(clip);
+    if (layer_clip.is_empty()) return;
+
+    const Rect visible = Rect::from_size(lx, ly, layer.width, layer.height).intersect(layer_clip);
+    if (!visible.is_empty() && !layer.m_content.is_empty() &&
+        (layer.is_cached() || rasterize(layer))) {
+        layer.m_last_used = m_frame;
+        ++m_stats.composited;
+
+        const Surface& surface = layer.m_surface;
+        const int count = visible.width();
+        const bool copy = layer.opaque && alpha == 255;
+        for (int y = visible.top; y < visible.bottom; ++y) {
+            const uint32_t* LA_RESTRICT src = surface.pixels
+                + static_cast<size_t>(surface.stride) * (y - ly) + (visible.left - lx);
+            uint32_t* LA_RESTRICT dst = target.row(y) + visible.left;
+            if (copy) for (int i = 0; i < count; ++i) dst[i] = src[i];
+            else      ::la::blend_argb32(dst, src, alpha, static_cast<size_t>(count));
+        }
+    }
+
+    for (Layer* child = layer.m_first_child; child; child = child->m_next_sibling)
+        draw(*child, target, lx, ly, layer_clip, alpha);
+} // draw
+
+void Compositor::
+composite(Layer& root, Canvas& target, uint32_t background) noexcept {
+    LA_PROFILE_FUNCTION();
+    ++m_frame;
+    m_stats = Stats{};
+
+    target.clear(background);
+    draw(root, target, 0, 0, target.clip, 255);
+
+    // Offscreen layers pay for the budget first
+    if (m_used > m_budget)
+        trim(m_budget);
+} // composite
+
+} // namespace la
@@ -0,0 +1,140 @@
+#ifndef __LA_LAYER_HEADER_GUARD
+#define __LA_LAYER_HEADER_GUARD
+
+#include "display_list.hpp"
+
+/*
+    Retained compositing layers. Every layer owns a display list and a cached
+    offscreen surface (premultiplied ARGB). The surface is re-rasterized only
+    after `record()`/`invalidate()`, moving, fading or clipping a layer is a
+    pure compositing operation done with `la::blend_argb32`.
+*/
+
+namespace la {
+
+struct Compositor;
+
+// --------------------------- Surface ----------------------------------------
+
+struct Surface {
+    uint32_t* pixels{ nullptr };
+    int width{ 0 };
+    int height{ 0 };
+    int stride{ 0 };
+    size_t bytes{ 0 }; // Allocated size, kept when the layer shrinks
+
+    LA_NO_DISCARD Canvas canvas() const noexcept { return Canvas{ pixels, width, height, stride }; }
+}; // struct Surface
+
+// --------------------------- Layer ------------------------------------------
+
+struct Layer {
+    int x{ 0 };                 // Translation relative to the parent
+    int y{ 0 };
+    int width{ 0 };             // Surface size, a new one re-rasterizes. Content is recorded in layer space
+    int height{ 0 };
+    uint8_t opacity{ 255 };     // Multiplied down the tree
+    bool opaque{ false };       // Content covers every pixel with alpha 255
+    Rect clip{ Rect::infinite() }; // Layer space, also clips children
+
+    explicit inline Layer() noexcept = default;
+    ~Layer() noexcept;
+
+    Layer(const Layer&) = delete;
+    Layer& operator=(const Layer&) = delete;
+    Layer(Layer&&) = delete;
+    Layer& operator=(Layer&&) = delete;
+
+    // Empty list to record new content into, the surface is re-rasterized once
+    LA_NO_DISCARD DisplayList& record() noexcept;
+    void invalidate() noexcept { m_dirty = true; }
+
+    // ---------------------------- Tree --------------------------------------
+
+    void add_child(Layer& child) noexcept; // Drawn above existing children
+    void detach() noexcept;
+
+    LA_NO_DISCARD Layer* parent() const noexcept { return m_parent; }
+    LA_NO_DISCARD Layer* first_child() const noexcept { return m_first_child; }
+    LA_NO_DISCARD Layer* next_sibling() const noexcept { return m_next_sibling; }
+
+    LA_NO_DISCARD const Surface& surface() const noexcept { return m_surface; }
+    // Rasterized at the current size and not invalidated since
+    LA_NO_DISCARD bool is_cached() const noexcept {
+        return m_surface.pixels && !m_dirty && m_surface.width == width && m_surface.height == height;
+    }
+
+private:
+    friend struct Compositor;
+
+    DisplayList m_content;
+    Surface m_surface;
+    bool m_dirty{ true };
+    uint64_t m_last_used{ 0 };  // Compositor frame, drives LRU eviction
+
+    Layer* m_parent{ nullptr };
+    Layer* m_first_child{ nullptr };
+    Layer* m_last_child{ nullptr };
+    Layer* m_next_sibling{ nullptr };
+    Layer* m_prev_sibling{ nullptr };
+
+    // Layers holding a surface, owned by a compositor
+    Compositor* m_cache_owner{ nullptr };
+    Layer* m_next_cached{ nullptr };
+    Layer* m_prev_cached{ nullptr };
+}; // struct Layer
+
+// --------------------------- Compositor -------------------------------------
+
+struct Compositor {
+    LA_CONSTEXPR_VAR static size_t DEFAULT_BUDGET = 64 * 1024 * 1024;
+
+    struct Stats {
+        uint32_t rasterized{ 0 }; // Surfaces re-rasterized this frame
+        uint32_t composited{ 0 }; // Layers blended this frame
+        uint32_t evicted{ 0 };    // Surfaces freed this frame
+    }; // struct Stats
+
+    explicit inline Compositor(size_t budget_bytes = DEFAULT_BUDGET) noexcept
+        : m_budget{ budget_bytes } {}
+    ~Compositor() noexcept;
+
+    Compositor(const Compositor&) = delete;
+    Compositor& operator=(const Compositor&) = delete;
+
+    // Clear `target` with `background` and draw the tree below `root`
+    void composite(Layer& root, Canvas& target, uint32_t background) noexcept;
+
+    // Free surfaces not used by the last frame until under budget
+    void trim(size_t budget_bytes) noexcept;
+    // Keep every surface but let the OS page them out, e.g. in the background.
+    // Returns the bytes concerned
+    size_t page_out() noexcept;
+
+    void set_budget(size_t bytes) noexcept { m_budget = bytes; }
+    // `la::AllocFlags` for surfaces allocated from now on
+    void set_alloc_flags(uint32_t flags) noexcept { m_alloc_flags = flags; }
+    LA_NO_DISCARD size_t budget() const noexcept { return m_budget; }
+    LA_NO_DISCARD size_t used_bytes() const noexcept { return m_used; }
+    LA_NO_DISCARD const Stats& stats() const noexcept { return m_stats; }
+
+private:
+    friend struct Layer;
+
+    void draw(Layer& layer, Canvas& target, int origin_x, int origin_y,
+              const Rect& clip, uint32_t opacity) noexcept;
+    bool rasterize(Layer& layer) noexcept;
+    void release(Layer& layer) noexcept;
+    void evict_for(size_t bytes) noexcept;
+
+    Layer* m_cached{ nullptr };
+    size_t m_budget;
+    size_t m_used{ 0 };
+    uint32_t m_alloc_flags{ ALLOC_DEFAULT };
+    uint64_t m_frame{ 0 };
+    Stats m_stats{};
+}; // struct Compositor
+
+} // namespace la
+
+#endif // __LA_LAYER_HEADER_GUARD
@@ -0,0 +1,616 @@
+#include "pool.hpp"
+
+#if defined(_MSC_VER) && !defined(LA_NOSTD)
+#   include <string.h> // memcpy, la.hpp declares it for freestanding builds
+#endif
+
+// Size-class pools: per-thread free lists in front of a shared lock-free list of batches
+
+namespace la {
+
+namespace detail {
+    LA_CONSTEXPR_VAR size_t   POOL_SLAB_SIZE = 64 * 1024; // Slabs are aligned to their size
+    LA_CONSTEXPR_VAR size_t   POOL_OBJECTS_OFFSET = 64;   // Slab header, cache-line padded
+    LA_CONSTEXPR_VAR unsigned POOL_CLASSES = 32;
+    // 16-byte steps up to 128, then four classes per power of two (at most 25% waste)
+    LA_CONSTEXPR_VAR uint16_t POOL_CLASS_SIZES[POOL_CLASSES] = {
+        16, 32, 48, 64, 80, 96, 112, 128,
+        160, 192, 224, 256, 320, 384, 448, 512,
+        640, 768, 896, 1024, 1280, 1536, 1792, 2048,
+        2560, 3072, 3584, 4096, 5120, 6144, 7168, 8192
+    };
+
+    // A free object. `next_batch` is only meaningful in the first object of a batch
+    struct PoolNode {
+        PoolNode* next;
+        PoolNode* next_batch;
+    }; // struct PoolNode
+
+    // First word of every 64 KB region the heap hands out pointers into
+    enum : uint32_t { POOL_KIND_SLAB = 0x51AB, POOL_KIND_LARGE = 0x1A26E };
+
+    static inline void
+    copy_bytes(void* dst, const void* src, size_t size) noexcept {
+#if defined(_MSC_VER)
+        memcpy(dst, src, size);
+#else
+        __builtin_memcpy(dst, src, size); // Plain loops are not lowered at -O2
+#endif
+    } // copy_bytes
+
+    struct PoolSlab {
+        uint32_t  kind;      // `POOL_KIND_SLAB`
+        uint32_t  cls;
+        PoolSlab* next;      // Class registry
+        void*     base;      // What `la::alloc` returned
+        size_t    bytes;
+        uint32_t  capacity;
+        uint32_t  free_mark; // Free objects seen by `trim_class()`
+    }; // struct PoolSlab
+
+    struct PoolClass {
+        Atomic<uintptr_t> shared;       // Batches: pushed with CAS, taken by exchange
+        Atomic<uintptr_t> slabs;        // Registry: pushed at the head, only trims unlink
+        Atomic<uint32_t>  shared_count; // Approximate, drives the automatic trim
+        Atomic<uint32_t>  trim_floor;   // `shared_count` the last trim left behind
+        Atomic<uint32_t>  trimming;
+        Atomic<uint32_t>  slab_count;
+    }; // struct PoolClass
+
+    // Plain data: lives in `thread_local` storage without constructors
+    struct PoolCache {
+        PoolNode* head;  // Objects ready to hand out
+        uint32_t  count;
+        PoolNode* stash; // Batches of a new slab beyond the one in use
+    }; // struct PoolCache
+
+    static PoolClass g_pool_classes[POOL_CLASSES];
+    static Atomic<uint64_t> g_pool_bytes{ 0 };
+    static Atomic<uint64_t> g_pool_released{ 0 };
+    static thread_local PoolCache t_pool_caches[POOL_CLASSES];
+
+    LA_NO_DISCARD static inline unsigned
+    pool_class(size_t size) noexcept {
+        if (size <= 128)
+            return size ? static_cast<unsigned>((size + 15) / 16 - 1) : 0;
+        // `size` in (2^e, 2^(e + 1)], split in quarters
+        const unsigned e = floor_log2(size - 1);
+        return 8 + 4 * (e - 7) + static_cast<unsigned>(((size - 1) >> (e - 2)) & 3);
+    } // pool_class
+
+    // Objects moved between a thread cache and the shared list at once:
+    // 32, or 32 KB worth for the larger classes
+    LA_NO_DISCARD static inline uint32_t
+    batch_size(unsigned cls) noexcept {
+        return POOL_CLASS_SIZES[cls] <= 1024 ? 32 : 32768u / POOL_CLASS_SIZES[cls];
+    } // batch_size
+
+    LA_NO_DISCARD static inline uint32_t
+    slab_capacity(unsigned cls) noexcept {
+        return static_cast<uint32_t>((POOL_SLAB_SIZE - POOL_OBJECTS_OFFSET) / POOL_CLASS_SIZES[cls]);
+    } // slab_capacity
+
+    LA_NO_DISCARD static inline PoolSlab*
+    slab_of(const void* ptr) noexcept {
+        return reinterpret_cast<PoolSlab*>(reinterpret_cast<uintptr_t>(ptr) & ~(POOL_SLAB_SIZE - 1));
+    } // slab_of
+
+    LA_NO_DISCARD static inline uint32_t
+    list_length(const PoolNode* node) noexcept {
+        uint32_t n = 0;
+        for (; node; node = node->next) ++n;
+        return n;
+    } // list_length
+
+    // ABA-safe: a stale head only makes the CAS fail, nothing is read through it
+    static void
+    push_batches(PoolClass& c, PoolNode* first, PoolNode* last) noexcept {
+        uintptr_t head = c.shared.load();
+        do last->next_batch = reinterpret_cast<PoolNode*>(head);
+        while (!c.shared.compare_exchange(head, reinterpret_cast<uintptr_t>(first)));
+    } // push_batches
+
+    static void trim_class(unsigned cls, uint32_t spare) noexcept;
+
+    // Move one batch of cached objects to the shared list
+    static void
+    spill(unsigned cls, PoolCache& cache) noexcept {
+        const uint32_t batch = batch_size(cls);
+        PoolNode* first = cache.head;
+        PoolNode* last = first;
+        for (uint32_t i = 1; i < batch; ++i) last = last->next;
+        cache.head = last->next;
+        cache.count -= batch;
+        last->next = nullptr;
+
+        // Trims walk every shared object: only after several slabs' worth piled up,
+        // and keep a couple of empty slabs for the next burst
+        PoolClass& c = g_pool_classes[cls];
+        push_batches(c, first, first);
+        const uint32_t shared = c.shared_count.fetch_add(batch) + batch;
+        if (shared > c.trim_floor.load() + 4 * slab_capacity(cls))
+            trim_class(cls, 2);
+    } // spill
+
+    // Set once `la::alloc` returned a block off the 64 KB grid
+    static Atomic<uint32_t> g_pool_unaligned{ 0 };
+    static Atomic<uint32_t> g_pool_alloc_flags{ ALLOC_DEFAULT };
+
+    LA_NO_DISCARD static inline uintptr_t
+    align_slab(void* base) noexcept {
+        return (reinterpret_cast<uintptr_t>(base) + POOL_SLAB_SIZE - 1) & ~(POOL_SLAB_SIZE - 1);
+    } // align_slab
+
+    // `bytes` from `la::alloc` starting at a 64 KB boundary. Backends that are not
+    // 64 KB-aligned (`VirtualAlloc` is) over-map by a slab and unmap both ends like
+    // `map_huge_aligned()`, `bytes` comes back rounded to the slab size
+    LA_NO_DISCARD static void*
+    alloc_aligned(size_t& bytes) noexcept {
+        LA_ALLOC_TAG(AllocTag::Pool);
+        const uint32_t flags = g_pool_alloc_flags.load_relaxed();
+        if (!g_pool_unaligned.load_relaxed()) {
+            void* base = ::la::alloc(bytes, flags);
+            if (!base || !(reinterpret_cast<uintptr_t>(base) & (POOL_SLAB_SIZE - 1)))
+                return base;
+            ::la::free(base, bytes);
+            g_pool_unaligned.store(1);
+        }
+        bytes = (bytes + POOL_SLAB_SIZE - 1) & ~(POOL_SLAB_SIZE - 1);
+        const size_t mapped = bytes + POOL_SLAB_SIZE;
+        unsigned char* start = static_cast<unsigned char*>(::la::alloc(mapped, flags));
+        if (!start) return nullptr;
+
+        // Large pages unmap in whole pages only, those keep the slack
+        const size_t large = get_large_page_size();
+        if ((flags & ALLOC_LARGE_PAGES) && large && mapped >= large) {
+            bytes = mapped;
+            return start;
+        }
+        unsigned char* aligned = reinterpret_cast<unsigned char*>(align_slab(start));
+        const size_t head = static_cast<size_t>(aligned - start);
+        if (head) ::la::free(start, head);
+        ::la::free(aligned + bytes, POOL_SLAB_SIZE - head);
+        // The trims are no blocks of their own: keep the telemetry count at one
+        for (unsigned trims = head ? 2 : 1; trims--;) telemetry_alloc(AllocTag::Pool, 0);
+        return aligned;
+    } // alloc_aligned
+
+    LA_NO_DISCARD static PoolNode*
+    carve_slab(unsigned cls) noexcept {
+        size_t bytes = POOL_SLAB_SIZE;
+        void* base = alloc_aligned(bytes);
+        if (!base) return nullptr;
+
+        PoolSlab* slab = reinterpret_cast<PoolSlab*>(align_slab(base));
+        slab->kind = POOL_KIND_SLAB;
+        slab->cls = cls;
+        slab->base = base;
+        slab->bytes = bytes;
+        slab->capacity = slab_capacity(cls);
+        slab->free_mark = 0;
+
+        // Batches of consecutive objects, chained through their first object
+        unsigned char* objects = reinterpret_cast<unsigned char*>(slab) + POOL_OBJECTS_OFFSET;
+        const size_t size = POOL_CLASS_SIZES[cls];
+        const uint32_t batch_objects = batch_size(cls);
+        PoolNode* batch = nullptr;
+        for (uint32_t i = slab->capacity; i-- > 0;) {
+            PoolNode* node = reinterpret_cast<PoolNode*>(objects + i * size);
+            const bool batch_end = (i + 1) % batch_objects == 0 || i + 1 == slab->capacity;
+            node->next = batch_end ? nullptr : reinterpret_cast<PoolNode*>(objects + (i + 1) * size);
+            if (i % batch_objects == 0) {
+                node->next_batch = batch;
+                batch = node;
+            }
+        }
+
+        PoolClass& c = g_pool_classes[cls];
+        uintptr_t head = c.slabs.load();
+        do slab->next = reinterpret_cast<PoolSlab*>(head);
+        while (!c.slabs.compare_exchange(head, reinterpret_cast<uintptr_t>(slab)));
+        c.slab_count.fetch_add(1);
+        g_pool_bytes.fetch_add(bytes);
+        return batch;
+    } // carve_slab
+
+    LA_NO_DISCARD static bool
+    refill(unsigned cls, PoolCache& cache) noexcept {
+        PoolClass& c = g_pool_classes[cls];
+        bool shared = false;
+        PoolNode* batch = cache.stash;
+        if (batch) cache.stash = batch->next_batch;
+        else {
+            // Popping the head batch alone would read a node another thread may have
+            // handed out (or a trim released) since the head was loaded. Take the
+            // list, keep one batch and push the others back
+            batch = reinterpret_cast<PoolNode*>(c.shared.exchange(0));
+            if (batch) {
+                shared = true;
+                // Usually nothing was pushed meanwhile and the rest goes back whole,
+                // otherwise it goes in front of the new batches
+                if (PoolNode* rest = batch->next_batch) {
+                    uintptr_t empty = 0;
+                    if (!c.shared.compare_exchange(empty, reinterpret_cast<uintptr_t>(rest))) {
+                        PoolNode* last = rest;
+                        while (last->next_batch) last = last->next_batch;
+                        push_batches(c, rest, last);
+                    }
+                }
+            }
+            else {
+                // A new slab's batches beyond the first stay with this thread
+                batch = carve_slab(cls);
+                if (!batch) return false;
+                cache.stash = batch->next_batch;
+            }
+        }
+        cache.head = batch;
+        cache.count = list_length(batch);
+        if (shared) {
+            uint32_t count = c.shared_count.load();
+            while (!c.shared_count.compare_exchange(count, count > cache.count ? count - cache.count : 0)) {}
+        }
+        return true;
+    } // refill
+
+    static void
+    trim_class(unsigned cls, uint32_t spare) noexcept {
+        PoolClass& c = g_pool_classes[cls];
+        uint32_t idle = 0;
+        if (!c.trimming.compare_exchange(idle, 1))
+            return;
+
+        // 1. Count the free objects of each slab, the drained list is ours alone
+        PoolNode* drained = reinterpret_cast<PoolNode*>(c.shared.exchange(0));
+        c.shared_count.store(0);
+        for (PoolNode* batch = drained; batch; batch = batch->next_batch)
+            for (PoolNode* node = batch; node; node = node->next)
+                ++slab_of(node)->free_mark;
+
+        // 2. Keep `spare` empty slabs, the others stay marked as empty.
+        // Slabs pushed since the drain hold none of its objects, they are skipped
+        PoolSlab* const slabs = reinterpret_cast<PoolSlab*>(c.slabs.load());
+        for (PoolSlab* slab = slabs; slab; slab = slab->next) {
+            if (slab->free_mark != slab->capacity) slab->free_mark = 0;
+            else if (spare) {
+                slab->free_mark = 0;
+                --spare;
+            }
+        }
+
+        // 3. Rebatch the objects of slabs that stay
+        PoolNode* first = nullptr;
+        PoolNode* last = nullptr; // Batch being filled
+        const uint32_t batch_objects = batch_size(cls);
+        uint32_t filled = 0, kept = 0;
+        for (PoolNode* batch = drained; batch;) {
+            PoolNode* next_batch = batch->next_batch;
+            for (PoolNode* node = batch; node;) {
+                PoolNode* next = node->next;
+                const PoolSlab* slab = slab_of(node);
+                if (slab->free_mark != slab->capacity) {
+                    if (!last || filled == batch_objects) { // Start a batch
+                        node->next = nullptr;
+                        node->next_batch = nullptr;
+                        if (last) last->next_batch = node;
+                        else      first = node;
+                        last = node;
+                        filled = 0;
+                    }
+                    else { // Behind the batch's first object
+                        node->next = last->next;
+                        last->next = node;
+                    }
+                    ++filled;
+                    ++kept;
+                }
+                node = next;
+            }
+            batch = next_batch;
+        }
+
+        // 4. Unlink and release the empty slabs
+        LA_ALLOC_TAG(AllocTag::Pool);
+        PoolSlab* prev = nullptr;
+        for (PoolSlab* slab = slabs; slab;) {
+            PoolSlab* next = slab->next;
+            if (slab->free_mark != slab->capacity) {
+                prev = slab;
+                slab = next;
+                continue;
+            }
+            if (prev) prev->next = next;
+            else {
+                uintptr_t head = reinterpret_cast<uintptr_t>(slab);
+                if (!c.slabs.compare_exchange(head, reinterpret_cast<uintptr_t>(next))) {
+                    // New slabs were pushed in front meanwhile
+                    PoolSlab* p = reinterpret_cast<PoolSlab*>(head);
+                    while (p->next != slab) p = p->next;
+                    p->next = next;
+                }
+            }
+            c.slab_count.fetch_add(static_cast<uint32_t>(-1));
+            g_pool_bytes.fetch_add(static_cast<uint64_t>(0) - slab->bytes);
+            g_pool_released.fetch_add(1);
+            ::la::free(slab->base, slab->bytes);
+            slab = next;
+        }
+
+        if (first) push_batches(c, first, last);
+        c.trim_floor.store(c.shared_count.fetch_add(kept) + kept);
+        c.trimming.store(0);
+    } // trim_class
+} // namespace detail
+
+// ------------------------------ Allocation ----------------------------------
+
+namespace detail {
+    // Objects count at the heap layer under the caller's tag, their slabs under
+    // `AllocTag::Pool` at the system layer
+    LA_NO_DISCARD static inline AllocTag
+    object_tag() noexcept {
+        const AllocTag tag = current_alloc_tag();
+        return tag == AllocTag::General ? AllocTag::Heap : tag;
+    } // object_tag
+
+    LA_NO_DISCARD static inline void*
+    class_alloc(unsigned cls) noexcept {
+        PoolCache& cache = t_pool_caches[cls];
+        if (!cache.head && !refill(cls, cache))
+            return nullptr;
+
+        PoolNode* node = cache.head;
+        cache.head = node->next;
+        --cache.count;
+        return node;
+    } // class_alloc
+
+    static inline void
+    class_free(unsigned cls, void* ptr) noexcept {
+        PoolCache& cache = t_pool_caches[cls];
+        PoolNode* node = static_cast<PoolNode*>(ptr);
+        node->next = cache.head;
+        cache.head = node;
+        if (++cache.count >= 2 * batch_size(cls))
+            spill(cls, cache);
+    } // class_free
+} // namespace detail
+
+void*
+pool_alloc(size_t size) noexcept {
+    void* ptr = nullptr;
+    if (size > POOL_MAX_SIZE) {
+        LA_ALLOC_TAG(AllocTag::Pool);
+        ptr = ::la::alloc(size, detail::g_pool_alloc_flags.load_relaxed());
+    }
+    else ptr = detail::class_alloc(detail::pool_class(size));
+    if (ptr) detail::telemetry_alloc(detail::object_tag(), size, AllocLayer::Heap);
+    return ptr;
+} // pool_alloc
+
+void
+pool_free(void* ptr, size_t size) noexcept {
+    if (!ptr) return;
+    detail::telemetry_free(detail::object_tag(), size, AllocLayer::Heap);
+    if (size > POOL_MAX_SIZE) {
+        LA_ALLOC_TAG(AllocTag::Pool);
+        ::la::free(ptr, size);
+    }
+    else detail::class_free(detail::pool_class(size), ptr);
+} // pool_free
+
+// ------------------------------ Heap ----------------------------------------
+
+namespace detail {
+    // In place of a slab header: large blocks are 64 KB-aligned as well, so
+    // `slab_of()` tells them apart from pooled objects by `kind`
+    struct HeapLarge {
+        uint32_t kind; // `POOL_KIND_LARGE`
+        uint32_t reserved;
+        void*    base;
+        size_t   bytes;
+        size_t   usable;
+    }; // struct HeapLarge
+
+    static_assert(sizeof(PoolSlab) <= POOL_OBJECTS_OFFSET && sizeof(HeapLarge) <= POOL_OBJECTS_OFFSET,
+                  "Slab and large headers must fit in front of the first object");
+
+    // Recently freed large blocks of this thread, reused before asking the OS
+    LA_CONSTEXPR_VAR unsigned HEAP_LARGE_CACHE = 4;
+    LA_CONSTEXPR_VAR size_t   HEAP_LARGE_CACHE_MAX = 1024 * 1024;
+    static thread_local HeapLarge* t_heap_large[HEAP_LARGE_CACHE];
+    static thread_local unsigned t_heap_large_next;
+
+    LA_NO_DISCARD static void*
+    large_alloc(size_t size) noexcept {
+        // Reuse a cached block that fits without wasting more than the
+        // request (plus the alignment slack of unaligned backends)
+        for (unsigned i = 0; i < HEAP_LARGE_CACHE; ++i) {
+            HeapLarge* large = t_heap_large[i];
+            if (large && large->usable >= size && large->usable - size <= size + POOL_SLAB_SIZE) {
+                t_heap_large[i] = nullptr;
+                return reinterpret_cast<unsigned char*>(large) + POOL_OBJECTS_OFFSET;
+            }
+        }
+
+        if (size > ~static_cast<size_t>(0) - 2 * POOL_SLAB_SIZE)
+            return nullptr;
+        size_t bytes = POOL_OBJECTS_OFFSET + size;
+        void* base = alloc_aligned(bytes);
+        if (!base) return nullptr;
+
+        const uintptr_t aligned = align_slab(base);
+        HeapLarge* large = reinterpret_cast<HeapLarge*>(aligned);
+        large->kind = POOL_KIND_LARGE;
+        large->base = base;
+        large->bytes = bytes;
+        large->usable = bytes - (aligned - reinterpret_cast<uintptr_t>(base)) - POOL_OBJECTS_OFFSET;
+        return reinterpret_cast<unsigned char*>(large) + POOL_OBJECTS_OFFSET;
+    } // large_alloc
+
+    static void
+    large_free(HeapLarge* large) noexcept {
+        if (large->bytes <= HEAP_LARGE_CACHE_MAX) {
+            // Round robin: the oldest cached block goes back to the OS
+            const unsigned slot = t_heap_large_next++ % HEAP_LARGE_CACHE;
+            HeapLarge* evicted = t_heap_large[slot];
+            t_heap_large[slot] = large;
+            if (!evicted) return;
+            large = evicted;
+        }
+        LA_ALLOC_TAG(AllocTag::Pool);
+        ::la::free(large->base, large->bytes);
+    } // large_free
+} // namespace detail
+
+void*
+heap_alloc(size_t size) noexcept {
+    if (size <= POOL_MAX_SIZE) {
+        const unsigned cls = detail::pool_class(size);
+        void* ptr = detail::class_alloc(cls);
+        if (ptr) detail::telemetry_alloc(detail::object_tag(), detail::POOL_CLASS_SIZES[cls], AllocLayer::Heap);
+        return ptr;
+    }
+    void* ptr = detail::large_alloc(size);
+    if (ptr) detail::telemetry_alloc(detail::object_tag(), heap_size(ptr), AllocLayer::Heap);
+    return ptr;
+} // heap_alloc
+
+void*
+heap_calloc(size_t count, size_t size) noexcept {
+    if (size && count > ~static_cast<size_t>(0) / size)
+        return nullptr;
+    const size_t bytes = count * size;
+    void* ptr = heap_alloc(bytes);
+    if (ptr) {
+        unsigned char* p = static_cast<unsigned char*>(ptr);
+        for (size_t i = 0; i < bytes; ++i) p[i] = 0;
+    }
+    return ptr;
+} // heap_calloc
+
+void
+heap_free(void* ptr) noexcept {
+    if (!ptr) return;
+    detail::PoolSlab* slab = detail::slab_of(ptr);
+    if (slab->kind == detail::POOL_KIND_SLAB) {
+        detail::telemetry_free(detail::object_tag(), detail::POOL_CLASS_SIZES[slab->cls], AllocLayer::Heap);
+        detail::class_free(slab->cls, ptr);
+        return;
+    }
+    detail::HeapLarge* large = reinterpret_cast<detail::HeapLarge*>(slab);
+    LA_ASSERT(large->kind == detail::POOL_KIND_LARGE, "heap_free: pointer not from the heap");
+    detail::telemetry_free(detail::object_tag(), large->usable, AllocLayer::Heap);
+    detail::large_free(large);
+} // heap_free
+
+size_t
+heap_size(const void* ptr) noexcept {
+    if (!ptr) return 0;
+    const detail::PoolSlab* slab = detail::slab_of(ptr);
+    if (slab->kind == detail::POOL_KIND_SLAB)
+        return detail::POOL_CLASS_SIZES[slab->cls];
+    return reinterpret_cast<const detail::HeapLarge*>(slab)->usable;
+} // heap_size
+
+void*
+heap_realloc(void* ptr, size_t size) noexcept {
+    if (!ptr) return heap_alloc(size);
+    if (size == 0) {
+        heap_free(ptr);
+        return nullptr;
+    }
+
+    // Stay in place while it fits and does not waste more than half
+    const size_t usable = heap_size(ptr);
+    if (size <= usable && (size > usable / 2 || usable <= 16))
+        return ptr;
+
+    void* moved = heap_alloc(size);
+    if (!moved) return nullptr; // `ptr` stays valid
+    const size_t keep = size < usable ? size : usable;
+    detail::copy_bytes(moved, ptr, keep);
+    heap_free(ptr);
+    return moved;
+} // heap_realloc
+
+// ------------------------------ Maintenance ---------------------------------
+
+void
+pool_flush_thread() noexcept {
+    using namespace detail;
+    for (unsigned cls = 0; cls < POOL_CLASSES; ++cls) {
+        PoolCache& cache = t_pool_caches[cls];
+        PoolClass& c = g_pool_classes[cls];
+        uint32_t count = 0;
+        if (cache.head) {
+            count += cache.count;
+            push_batches(c, cache.head, cache.head);
+        }
+        if (cache.stash) {
+            PoolNode* last = cache.stash;
+            for (;; last = last->next_batch) {
+                count += list_length(last);
+                if (!last->next_batch) break;
+            }
+            push_batches(c, cache.stash, last);
+        }
+        c.shared_count.fetch_add(count);
+        cache = PoolCache{};
+    }
+    LA_ALLOC_TAG(AllocTag::Pool);
+    for (unsigned i = 0; i < HEAP_LARGE_CACHE; ++i) {
+        if (HeapLarge* large = t_heap_large[i])
+            ::la::free(large->base, large->bytes);
+        t_heap_large[i] = nullptr;
+    }
+} // pool_flush_thread
+
+void
+pool_trim() noexcept {
+    for (unsigned cls = 0; cls < detail::POOL_CLASSES; ++cls)
+        detail::trim_class(cls, 0);
+} // pool_trim
+
+void
+pool_set_alloc_flags(uint32_t flags) noexcept { detail::g_pool_alloc_flags.store(flags); }
+
+PoolStats
+pool_stats() noexcept {
+    PoolStats stats;
+    for (unsigned cls = 0; cls < detail::POOL_CLASSES; ++cls) {
+        stats.slabs += detail::g_pool_classes[cls].slab_count.load();
+        stats.shared_free += detail::g_pool_classes[cls].shared_count.load();
+    }
+    stats.slab_bytes = detail::g_pool_bytes.load();
+    stats.released = detail::g_pool_released.load();
+    return stats;
+} // pool_stats
+
+} // namespace la
+
+// ------------------------------ Operators -----------------------------------
+
+#ifdef LA_NOSTD
+// No libc in freestanding builds: `new` and `delete` go through the heap.
+// Without exceptions to throw, running out of memory ends the process
+static void*
+checked_heap_alloc(size_t size) noexcept {
+    void* ptr = ::la::heap_alloc(size);
+    if (!ptr)
+        ::la::panic_process(::la::what(::la::AboutError::Freestanding_OutOfMemory), -1);
+    return ptr;
+} // checked_heap_alloc
+
+void* operator new(size_t size) { return checked_heap_alloc(size); }
+void* operator new[](size_t size) { return checked_heap_alloc(size); }
+void operator delete(void* ptr) noexcept { ::la::heap_free(ptr); }
+void operator delete[](void* ptr) noexcept { ::la::heap_free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { ::la::heap_free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { ::la::heap_free(ptr); }
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+// Referenced by MSVC's deleting destructors on 64-bit targets too
+void __cdecl operator delete(void* ptr, unsigned int) noexcept { ::la::heap_free(ptr); }
+#endif
+#endif // LA_NOSTD
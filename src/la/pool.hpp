@@ -0,0 +1,81 @@
+#ifndef __LA_POOL_HEADER_GUARD
+#define __LA_POOL_HEADER_GUARD
+
+#include "la.hpp"
+
+/*
+    Small-object allocation by size class (16 to 8192 bytes), for the many
+    same-sized objects that outlive a frame: retained nodes, events, glyph
+    cache entries. Objects are carved from 64 KB `la::alloc` slabs.
+
+    Each thread keeps an intrusive free list per class, so the common alloc
+    and free touch no shared memory. Lists over two batches (32 objects, or
+    32 KB for large classes) move one batch to a shared lock-free list,
+    which refills empty caches.
+    Slabs whose objects are all back on the shared list are released.
+
+        la::Pool<Node> nodes;
+        Node* n = nodes.alloc(); // Uninitialized
+        nodes.free(n);           // Any thread
+
+    A thread's cached objects stay unavailable to others until it calls
+    `pool_flush_thread()`, do so before a pool-using thread exits.
+*/
+
+namespace la {
+
+// --------------------------- Size Classes -----------------------------------
+
+LA_CONSTEXPR_VAR size_t POOL_MAX_SIZE = 8192; // Larger requests go to `la::alloc`
+LA_CONSTEXPR_VAR size_t POOL_ALIGN = 16;
+
+struct PoolStats {
+    uint64_t slabs{ 0 };       // Live slabs, every class
+    uint64_t slab_bytes{ 0 };  // Taken from `la::alloc`
+    uint64_t shared_free{ 0 }; // Objects on the shared lists (thread caches not included)
+    uint64_t released{ 0 };    // Slabs given back since start
+}; // struct PoolStats
+
+// `size` must match between the two calls. Null when out of memory
+LA_NO_DISCARD void* pool_alloc(size_t size) noexcept;
+void pool_free(void* ptr, size_t size) noexcept;
+
+// Hand the calling thread's cached objects to the shared lists, and its
+// cached large heap blocks back to the OS
+void pool_flush_thread() noexcept;
+// Release every slab with no object in use or cached. Runs on its own when
+// the shared lists grow, call it after dropping many objects at once
+void pool_trim() noexcept;
+LA_NO_DISCARD PoolStats pool_stats() noexcept;
+// `la::AllocFlags` for slabs and large blocks allocated from now on. Slabs are
+// smaller than a large page, `ALLOC_LARGE_PAGES` only reaches big heap blocks
+void pool_set_alloc_flags(uint32_t flags) noexcept;
+
+// --------------------------- Heap -------------------------------------------
+
+// General-purpose allocation on top of the size classes: blocks up to
+// `POOL_MAX_SIZE` come from the pools, larger ones straight from `la::alloc`.
+// Frees need no size. Backs `operator new`/`delete` in `LA_NOSTD` builds
+LA_NO_DISCARD void* heap_alloc(size_t size) noexcept;
+LA_NO_DISCARD void* heap_calloc(size_t count, size_t size) noexcept;
+// Null and `ptr` untouched when out of memory; size 0 frees
+LA_NO_DISCARD void* heap_realloc(void* ptr, size_t size) noexcept;
+void heap_free(void* ptr) noexcept;
+// Usable bytes, at least what was asked for
+LA_NO_DISCARD size_t heap_size(const void* ptr) noexcept;
+
+// --------------------------- Pool -------------------------------------------
+
+/// Typed front end of the size classes. Storage only: construct and destroy
+/// the objects yourself (or keep them trivial)
+template <typename T>
+struct Pool {
+    static_assert(alignof(T) <= POOL_ALIGN, "Pool<T> aligns objects to 16 bytes");
+
+    LA_NO_DISCARD T* alloc() noexcept { return static_cast<T*>(pool_alloc(sizeof(T))); }
+    void free(T* ptr) noexcept { if (ptr) pool_free(ptr, sizeof(T)); }
+}; // struct Pool
+
+} // namespace la
+
+#endif // __LA_POOL_HEADER_GUARD
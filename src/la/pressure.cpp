@@ -0,0 +1,161 @@
+#include "pressure.hpp"
+#include "pool.hpp"
+
+namespace la {
+
+namespace detail {
+    struct MemoryCache {
+        const char* name;
+        TrimProc proc;
+        void* cache;
+        CachePriority priority;
+    }; // struct MemoryCache
+
+    // Kept in registration order, which is also the trim order within a priority
+    static MemoryCache g_memory_caches[MAX_MEMORY_CACHES];
+    static unsigned g_memory_cache_count = 0;
+
+    // Highest priority each level trims
+    LA_NO_DISCARD static inline unsigned
+    trim_cutoff(MemoryPressure level) noexcept {
+        switch (level) {
+        case MemoryPressure::Background: return static_cast<unsigned>(CachePriority::Low);
+        case MemoryPressure::Moderate:   return static_cast<unsigned>(CachePriority::Normal);
+        case MemoryPressure::Critical:   return static_cast<unsigned>(CachePriority::High);
+        default:                         return 0;
+        }
+    } // trim_cutoff
+} // namespace detail
+
+const char*
+memory_pressure_name(MemoryPressure level) noexcept {
+    switch (level) {
+    case MemoryPressure::None:       return "none";
+    case MemoryPressure::Background: return "background";
+    case MemoryPressure::Moderate:   return "moderate";
+    case MemoryPressure::Critical:   return "critical";
+    default:                         return "?";
+    }
+} // memory_pressure_name
+
+// ------------------------------ Caches --------------------------------------
+
+bool
+register_memory_cache(const char* name, CachePriority priority, TrimProc proc, void* cache) noexcept {
+    using namespace detail;
+    if (!proc || g_memory_cache_count == MAX_MEMORY_CACHES) return false;
+    g_memory_caches[g_memory_cache_count++] = MemoryCache{ name, proc, cache, priority };
+    return true;
+} // register_memory_cache
+
+void
+unregister_memory_cache(void* cache) noexcept {
+    using namespace detail;
+    unsigned kept = 0;
+    for (unsigned i = 0; i < g_memory_cache_count; ++i)
+        if (g_memory_caches[i].cache != cache)
+            g_memory_caches[kept++] = g_memory_caches[i];
+    g_memory_cache_count = kept;
+} // unregister_memory_cache
+
+// ------------------------------ Policy --------------------------------------
+
+MemoryPolicy::
+MemoryPolicy(const Config& config) noexcept : m_config{ config } {}
+
+void MemoryPolicy::
+on_focus_change(bool gained) noexcept { m_focused = gained; }
+
+MemoryPressure MemoryPolicy::
+poll_stall(uint64_t now_ns) noexcept {
+    if (!m_has_psi || now_ns < m_next_poll) return m_stall_level;
+    m_next_poll = now_ns + static_cast<uint64_t>(m_config.poll_secs * 1e9);
+
+    if (!::la::get_memory_stall(m_stall)) {
+        m_has_psi = false; // Windows, or a kernel without CONFIG_PSI
+        return m_stall_level = MemoryPressure::None;
+    }
+    if (m_stall.full >= m_config.critical_full)      m_stall_level = MemoryPressure::Critical;
+    else if (m_stall.some >= m_config.moderate_some) m_stall_level = MemoryPressure::Moderate;
+    else                                             m_stall_level = MemoryPressure::None;
+    return m_stall_level;
+} // poll_stall
+
+bool MemoryPolicy::
+update() noexcept {
+    const uint64_t now = ::la::get_monotonic_ns();
+    const MemoryPressure stall = poll_stall(now);
+    const MemoryPressure focus = m_focused ? MemoryPressure::None : MemoryPressure::Background;
+    m_level = stall > focus ? stall : focus;
+
+    if (m_level == MemoryPressure::None) {
+        m_trimmed = MemoryPressure::None; // Trim again on the next focus loss
+        return false;
+    }
+
+    // Once per rise, then every `repeat_secs` while the system stays short
+    const bool repeat = m_level >= MemoryPressure::Moderate &&
+                        now - m_last_trim >= static_cast<uint64_t>(m_config.repeat_secs * 1e9);
+    if (m_level <= m_trimmed && !repeat) return false;
+    (void)trim(m_level);
+    return true;
+} // update
+
+TrimReport MemoryPolicy::
+trim(MemoryPressure level) noexcept {
+    using namespace detail;
+    LA_PROFILE_FUNCTION();
+    TrimReport report;
+    report.level = level;
+    const uint64_t start = ::la::get_monotonic_ns();
+    report.rss_before = ::la::get_resident_bytes();
+
+    if (level != MemoryPressure::None) {
+        // Cheapest to rebuild first
+        const unsigned cutoff = trim_cutoff(level);
+        for (unsigned priority = 0; priority <= cutoff; ++priority) {
+            for (unsigned i = 0; i < g_memory_cache_count; ++i) {
+                const MemoryCache& entry = g_memory_caches[i];
+                if (static_cast<unsigned>(entry.priority) != priority) continue;
+                report.released += entry.proc(entry.cache, level);
+                ++report.caches;
+            }
+        }
+
+        // Slabs emptied by the caches, and this thread's cached objects
+        const uint64_t slab_bytes = pool_stats().slab_bytes;
+        pool_flush_thread();
+        pool_trim();
+        const uint64_t trimmed = pool_stats().slab_bytes;
+        report.released += static_cast<size_t>(slab_bytes > trimmed ? slab_bytes - trimmed : 0);
+
+        // What is left stays valid, it just leaves RAM. Not under moderate
+        // pressure while in use: the next frame would fault it all back in
+        if (level == MemoryPressure::Critical ||
+            (level == MemoryPressure::Background && m_config.page_out_background)) {
+            ::la::reset_workset();
+            report.paged_out = true;
+        }
+    }
+
+    report.rss_after = ::la::get_resident_bytes();
+    report.duration_ns = ::la::get_monotonic_ns() - start;
+    m_report = report;
+    m_trimmed = level;
+    m_last_trim = ::la::get_monotonic_ns();
+    return report;
+} // trim
+
+// ------------------------------ Reports -------------------------------------
+
+void
+trim_report_dump(Out& out, const TrimReport& report) noexcept {
+    out << "Memory trim (" << memory_pressure_name(report.level) << "): RSS "
+        << report.rss_before / 1048576.0 << " -> " << report.rss_after / 1048576.0
+        << " MB, released " << report.released / 1048576.0 << " MB by "
+        << report.caches << " caches" << (report.paged_out ? ", paged out, " : ", ")
+        << report.duration_ns / 1e6 << " ms\n";
+    out.flush();
+} // trim_report_dump
+
+} // namespace la
@@ -0,0 +1,121 @@
+#ifndef __LA_PRESSURE_HEADER_GUARD
+#define __LA_PRESSURE_HEADER_GUARD
+
+#include "la.hpp"
+
+/*
+    Memory-pressure policy. Caches register a trim callback with a priority;
+    when the window loses focus or the system runs short of memory (PSI on
+    Linux), the policy calls them cheapest-to-rebuild first, trims the pools
+    and pages the rest of the `la::alloc` memory out with `la::reset_workset()`.
+
+        la::register_memory_cache("surfaces", la::CachePriority::Normal,
+            [](void* c, la::MemoryPressure level) noexcept -> size_t {
+                la::Compositor& compositor = *static_cast<la::Compositor*>(c);
+                const size_t before = compositor.used_bytes();
+                compositor.trim(level == la::MemoryPressure::Critical ? 0 : before / 2);
+                return before - compositor.used_bytes();
+            }, &compositor);
+
+        la::MemoryPolicy memory;
+        // IWindowEvents::on_focus_change(bool gained): memory.on_focus_change(gained);
+        while (win.poll_events()) {
+            (void)memory.update();
+            ...
+        }
+
+    Registration and trimming happen on one thread, usually the main one.
+*/
+
+namespace la {
+
+// --------------------------- Levels -----------------------------------------
+
+enum class MemoryPressure : uint8_t {
+    None,
+    Background, // Focus lost: nobody looks at the window
+    Moderate,   // PSI `some` over the threshold: tasks wait for reclaim
+    Critical,   // PSI `full` over the threshold: the system is thrashing
+    __LAST__
+}; // enum class MemoryPressure
+
+// Trim order. Each level trims its own priority and every lower one
+enum class CachePriority : uint8_t {
+    Low,    // Cheap to rebuild, trimmed from `Background` up
+    Normal, // From `Moderate` up
+    High,   // Expensive to rebuild, `Critical` only
+    __LAST__
+}; // enum class CachePriority
+
+LA_NO_DISCARD const char* memory_pressure_name(MemoryPressure level) noexcept;
+
+// --------------------------- Caches -----------------------------------------
+
+// Shrink as far as `level` calls for, return the bytes released
+using TrimProc = size_t (*)(void* cache, MemoryPressure level) noexcept;
+
+LA_CONSTEXPR_VAR unsigned MAX_MEMORY_CACHES = 32;
+
+// `cache` identifies the registration. False when the table is full
+bool register_memory_cache(const char* name, CachePriority priority, TrimProc proc, void* cache) noexcept;
+void unregister_memory_cache(void* cache) noexcept;
+
+// --------------------------- Policy -----------------------------------------
+
+struct TrimReport {
+    MemoryPressure level{ MemoryPressure::None };
+    size_t   rss_before{ 0 };   // `get_resident_bytes()`, 0 when unknown
+    size_t   rss_after{ 0 };
+    size_t   released{ 0 };     // As reported by the caches and the pools
+    uint32_t caches{ 0 };       // Callbacks run
+    bool     paged_out{ false }; // `reset_workset()` ran
+    uint64_t duration_ns{ 0 };
+}; // struct TrimReport
+
+void trim_report_dump(Out& out, const TrimReport& report) noexcept;
+
+struct MemoryPolicy {
+    struct Config {
+        double poll_secs{ 1.0 };         // PSI is a file read
+        float  moderate_some{ 10.0f };   // `some` avg10 percent for `Moderate`
+        float  critical_full{ 5.0f };    // `full` avg10 percent for `Critical`
+        double repeat_secs{ 10.0 };      // Trim again while pressure lasts, at most this often
+        bool   page_out_background{ true }; // `reset_workset()` on focus loss
+    }; // struct Config
+
+    explicit inline MemoryPolicy() noexcept : MemoryPolicy{ Config{} } {}
+    explicit MemoryPolicy(const Config& config) noexcept;
+
+    // Once per main loop iteration. Polls PSI every `poll_secs` and trims when the
+    // level rises, true when it trimmed
+    bool update() noexcept;
+    // Forward `IWindowEvents::on_focus_change()`. Losing focus trims on the next `update()`
+    void on_focus_change(bool gained) noexcept;
+
+    // Run the caches up to `level`'s priority, trim the pools and page out at
+    // `Background` and `Critical`. Any time, whatever the current level
+    TrimReport trim(MemoryPressure level) noexcept;
+
+    LA_NO_DISCARD MemoryPressure level() const noexcept { return m_level; }
+    LA_NO_DISCARD const MemoryStall& stall() const noexcept { return m_stall; }
+    LA_NO_DISCARD const TrimReport& last_report() const noexcept { return m_report; }
+    LA_NO_DISCARD const Config& config() const noexcept { return m_config; }
+
+private:
+    LA_NO_DISCARD MemoryPressure poll_stall(uint64_t now_ns) noexcept;
+
+    Config m_config;
+    MemoryStall m_stall{};
+    TrimReport m_report{};
+    MemoryPressure m_level{ MemoryPressure::None };
+    MemoryPressure m_stall_level{ MemoryPressure::None };
+    MemoryPressure m_trimmed{ MemoryPressure::None }; // Level of the last trim
+    uint64_t m_next_poll{ 0 };
+    uint64_t m_last_trim{ 0 };
+    bool m_focused{ true };
+    bool m_has_psi{ true };
+}; // struct MemoryPolicy
+
+} // namespace la
+
+#endif // __LA_PRESSURE_HEADER_GUARD
@@ -0,0 +1,262 @@
+#include "la.hpp"
+
+// Profiling zones: per-thread rings of completed zones plus the Chrome trace exporter
+
+namespace la {
+
+// ------------------------------ Rings ---------------------------------------
+
+namespace detail {
+    struct ProfileEvent {
+        const char* name;
+        uint64_t begin_ns;
+        uint64_t end_ns;
+        uint64_t counters[PerfSample::COUNT];
+        uint8_t counters_valid; // `PerfSample::valid`, 0 for plain zones
+    }; // struct ProfileEvent
+
+    // Oldest events are overwritten, `head` counts every event ever written
+    struct ProfileRing {
+        LA_CONSTEXPR_VAR static uint32_t CAPACITY = 1u << 15; // 2.25 MB per thread
+
+        ProfileRing* next;
+        uint32_t thread_id;
+        uint64_t export_head; // Snapshot taken by the exporter's sizing pass
+        Atomic<uint64_t> head;
+        ProfileEvent events[CAPACITY];
+    }; // struct ProfileRing
+
+    // Rings are registered once and kept until `profile_shutdown()`: exports stay
+    // valid after threads exit
+    static Atomic<uintptr_t> g_profile_rings{ 0 };
+    // Bumped by `profile_shutdown()`: a thread's cached ring is from an older one, freed
+    static Atomic<uint32_t> g_profile_generation{ 0 };
+    static thread_local ProfileRing* t_profile_ring = nullptr;
+    static thread_local uint32_t t_profile_generation = 0;
+    static thread_local bool t_profile_failed = false;
+    static thread_local PerfCounters t_profile_counters;
+    static thread_local bool t_profile_counters_tried = false;
+
+    static ProfileRing*
+    acquire_ring() noexcept {
+        const uint32_t generation = g_profile_generation.load();
+        if (t_profile_generation != generation) {
+            t_profile_ring = nullptr;
+            t_profile_failed = false;
+            t_profile_generation = generation;
+        }
+        if (t_profile_ring || t_profile_failed)
+            return t_profile_ring;
+
+        LA_ALLOC_TAG(AllocTag::Profiler);
+        ProfileRing* ring = static_cast<ProfileRing*>(::la::alloc(sizeof(ProfileRing)));
+        if (!ring) {
+            t_profile_failed = true;
+            return nullptr;
+        }
+        ring->thread_id = ::la::get_thread_id();
+        (void)::la::tsc_calibrate(); // Once per process, zones use the TSC from then on
+        ring->head.store_relaxed(0);
+
+        uintptr_t first = g_profile_rings.load();
+        do ring->next = reinterpret_cast<ProfileRing*>(first);
+        while (!g_profile_rings.compare_exchange(first, reinterpret_cast<uintptr_t>(ring)));
+
+        t_profile_ring = ring;
+        return ring;
+    } // acquire_ring
+
+    // ----------------------- JSON Writer ------------------------------------
+
+    struct JsonBuffer {
+        char* data;
+        size_t size;
+        size_t capacity;
+
+        void put(char c) noexcept { if (size < capacity) data[size++] = c; }
+        void put(const char* s) noexcept { while (*s) put(*s++); }
+        void put_unsigned(uint64_t v) noexcept {
+            char digits[20];
+            int n = 0;
+            do digits[n++] = static_cast<char>('0' + v % 10); while (v /= 10);
+            while (n) put(digits[--n]);
+        }
+        // Microseconds with nanosecond decimals, the trace-event time unit
+        void put_micros(uint64_t ns) noexcept {
+            put_unsigned(ns / 1000);
+            const uint32_t frac = static_cast<uint32_t>(ns % 1000);
+            put('.');
+            put(static_cast<char>('0' + frac / 100));
+            put(static_cast<char>('0' + frac / 10 % 10));
+            put(static_cast<char>('0' + frac % 10));
+        }
+        void put_string(const char* s) noexcept {
+            put('"');
+            for (; *s; ++s) {
+                const unsigned char c = static_cast<unsigned char>(*s);
+                if (c == '"' || c == '\\') { put('\\'); put(*s); }
+                else if (c < 0x20)         put(' ');
+                else                       put(*s);
+            }
+            put('"');
+        }
+    }; // struct JsonBuffer
+
+    static void
+    put_counters(JsonBuffer& json, const ProfileEvent& e) noexcept {
+        static const char* const NAMES[PerfSample::COUNT] = {
+            "cycles", "instructions", "llc_misses", "branch_misses", "dtlb_misses"
+        };
+        json.put(",\"args\":{");
+        bool comma = false;
+        for (unsigned i = 0; i < PerfSample::COUNT; ++i) {
+            if (!((e.counters_valid >> i) & 1)) continue;
+            if (comma) json.put(',');
+            comma = true;
+            json.put('"'); json.put(NAMES[i]); json.put("\":");
+            json.put_unsigned(e.counters[i]);
+        }
+
+        // IPC with three decimals, `JsonBuffer` has no float printer
+        PerfSample sample;
+        sample.valid = e.counters_valid;
+        for (unsigned i = 0; i < PerfSample::COUNT; ++i)
+            sample.values[i] = e.counters[i];
+        const double ipc = sample.ipc();
+        if (ipc > 0.0) {
+            const uint64_t milli = static_cast<uint64_t>(ipc * 1000.0 + 0.5);
+            json.put(",\"ipc\":");
+            json.put_unsigned(milli / 1000);
+            json.put('.');
+            json.put(static_cast<char>('0' + milli / 100 % 10));
+            json.put(static_cast<char>('0' + milli / 10 % 10));
+            json.put(static_cast<char>('0' + milli % 10));
+        }
+        json.put('}');
+    } // put_counters
+
+    LA_NO_DISCARD static inline size_t
+    string_length(const char* s) noexcept {
+        size_t n = 0;
+        while (s[n]) ++n;
+        return n;
+    } // string_length
+} // namespace detail
+
+void
+profile_record(const char* name, uint64_t begin_ns, uint64_t end_ns) noexcept {
+    detail::ProfileRing* ring = detail::acquire_ring();
+    if (!ring) return;
+
+    // Single writer per ring: fill the slot, then publish it
+    const uint64_t head = ring->head.load_relaxed();
+    detail::ProfileEvent& e = ring->events[head & (detail::ProfileRing::CAPACITY - 1)];
+    e.name = name;
+    e.begin_ns = begin_ns;
+    e.end_ns = end_ns;
+    e.counters_valid = 0;
+    ring->head.store(head + 1);
+} // profile_record
+
+void
+profile_record_counters(const char* name, uint64_t begin_ns, uint64_t end_ns,
+                        const PerfSample& delta) noexcept {
+    detail::ProfileRing* ring = detail::acquire_ring();
+    if (!ring) return;
+
+    const uint64_t head = ring->head.load_relaxed();
+    detail::ProfileEvent& e = ring->events[head & (detail::ProfileRing::CAPACITY - 1)];
+    e.name = name;
+    e.begin_ns = begin_ns;
+    e.end_ns = end_ns;
+    for (unsigned i = 0; i < PerfSample::COUNT; ++i)
+        e.counters[i] = delta.values[i];
+    e.counters_valid = delta.valid;
+    ring->head.store(head + 1);
+} // profile_record_counters
+
+PerfSample
+profile_read_counters() noexcept {
+    // One attempt per thread, a refused `perf_event_open` stays refused
+    if (!detail::t_profile_counters_tried) {
+        detail::t_profile_counters_tried = true;
+        (void)detail::t_profile_counters.open();
+    }
+    return detail::t_profile_counters.is_open() ? detail::t_profile_counters.read() : PerfSample{};
+} // profile_read_counters
+
+// ------------------------------ Export --------------------------------------
+
+bool
+profile_export_chrome(const char* path) noexcept {
+    using detail::ProfileRing;
+    const ProfileRing* first = reinterpret_cast<const ProfileRing*>(detail::g_profile_rings.load());
+
+    // Size first: escaping at most doubles a name
+    LA_CONSTEXPR_VAR size_t EVENT_OVERHEAD = 320; // Counter args included
+    uint64_t start_ns = ~0ull;
+    size_t capacity = EVENT_OVERHEAD;
+    for (ProfileRing* ring = const_cast<ProfileRing*>(first); ring; ring = ring->next) {
+        const uint64_t head = ring->export_head = ring->head.load();
+        const uint64_t count = head < ProfileRing::CAPACITY ? head : ProfileRing::CAPACITY;
+        for (uint64_t i = head - count; i < head; ++i) {
+            const detail::ProfileEvent& e = ring->events[i & (ProfileRing::CAPACITY - 1)];
+            capacity += EVENT_OVERHEAD + 2 * detail::string_length(e.name);
+            if (e.begin_ns < start_ns) start_ns = e.begin_ns;
+        }
+    }
+
+    LA_ALLOC_TAG(AllocTag::Profiler);
+    detail::JsonBuffer json{ static_cast<char*>(::la::alloc(capacity)), 0, capacity };
+    if (!json.data)
+        return false;
+
+    // Timestamps relative to the first event keep the numbers short.
+    // Threads may keep recording: only events seen while sizing are written,
+    // and an event overwritten since then is dropped if it no longer fits
+    json.put("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    bool comma = false;
+    for (const ProfileRing* ring = first; ring; ring = ring->next) {
+        const uint64_t head = ring->export_head;
+        const uint64_t count = head < ProfileRing::CAPACITY ? head : ProfileRing::CAPACITY;
+        for (uint64_t i = head - count; i < head; ++i) {
+            const detail::ProfileEvent& e = ring->events[i & (ProfileRing::CAPACITY - 1)];
+            if (json.capacity - json.size < EVENT_OVERHEAD + 2 * detail::string_length(e.name))
+                continue;
+            if (comma) json.put(',');
+            comma = true;
+            json.put("\n{\"ph\":\"X\",\"pid\":1,\"tid\":");
+            json.put_unsigned(ring->thread_id);
+            json.put(",\"name\":");
+            json.put_string(e.name);
+            json.put(",\"ts\":");
+            json.put_micros(e.begin_ns > start_ns ? e.begin_ns - start_ns : 0);
+            json.put(",\"dur\":");
+            json.put_micros(e.end_ns >= e.begin_ns ? e.end_ns - e.begin_ns : 0);
+            if (e.counters_valid)
+                put_counters(json, e);
+            json.put('}');
+        }
+    }
+    json.put("\n]}\n");
+
+    const bool ok = ::la::write_file(path, json.data, json.size);
+    ::la::free(json.data, capacity);
+    return ok;
+} // profile_export_chrome
+
+void
+profile_shutdown() noexcept {
+    using detail::ProfileRing;
+    LA_ALLOC_TAG(AllocTag::Profiler);
+    ProfileRing* ring = reinterpret_cast<ProfileRing*>(detail::g_profile_rings.exchange(0));
+    // Before the rings go: every thread drops its cached one on its next record
+    (void)detail::g_profile_generation.fetch_add(1);
+    while (ring) {
+        ProfileRing* next = ring->next;
+        ::la::free(ring, sizeof(ProfileRing));
+        ring = next;
+    }
+} // profile_shutdown
+
+} // namespace la
@@ -0,0 +1,290 @@
+#include "replay.hpp"
+
+namespace la {
+
+// Layout: "LAEV", version byte, 3 reserved bytes, then records of
+// [tag][varint ns since the previous record][payload]
+namespace detail {
+    LA_CONSTEXPR_VAR uint8_t REPLAY_MAGIC[4] = { 'L', 'A', 'E', 'V' };
+    LA_CONSTEXPR_VAR uint8_t REPLAY_VERSION = 1;
+
+    enum : uint8_t {
+        REC_MOUSE_MOVE, // zigzag x, zigzag y
+        REC_SCROLL,     // float bits, 4 bytes little-endian
+        REC_KEY_DOWN,   // key
+        REC_KEY_UP,     // key
+        REC_FOCUS,      // 0 or 1
+        REC_RESIZE,     // width, height
+        REC_FRAME,      // A rendered frame, no payload
+        REC__LAST__
+    };
+
+    LA_NO_DISCARD static inline uint64_t
+    zigzag(int v) noexcept {
+        return (static_cast<uint64_t>(static_cast<int64_t>(v)) << 1) ^
+                static_cast<uint64_t>(static_cast<int64_t>(v) >> 63);
+    }
+    LA_NO_DISCARD static inline int
+    unzigzag(uint64_t v) noexcept {
+        return static_cast<int>(static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1));
+    }
+
+    // Bit copies without <string.h>
+    union FloatBits { float f; uint32_t u; };
+} // namespace detail
+
+// ------------------------------ Recorder ------------------------------------
+
+EventRecorder::
+~EventRecorder() noexcept {
+    LA_ALLOC_TAG(AllocTag::Replay);
+    if (m_data) ::la::free(m_data, m_capacity);
+} // ~EventRecorder
+
+void EventRecorder::
+put_byte(uint8_t b) noexcept {
+    if (m_size == m_capacity) {
+        if (m_failed) return;
+        LA_ALLOC_TAG(AllocTag::Replay);
+        const size_t capacity = m_capacity ? m_capacity * 2 : 64 * 1024;
+        uint8_t* data = static_cast<uint8_t*>(::la::alloc(capacity));
+        if (!data) {
+            m_failed = true; // `save()` reports it, the app keeps running
+            return;
+        }
+        for (size_t i = 0; i < m_size; ++i) data[i] = m_data[i];
+        if (m_data) ::la::free(m_data, m_capacity);
+        m_data = data;
+        m_capacity = capacity;
+    }
+    m_data[m_size++] = b;
+} // put_byte
+
+void EventRecorder::
+put_varint(uint64_t v) noexcept {
+    while (v >= 0x80) {
+        put_byte(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    put_byte(static_cast<uint8_t>(v));
+} // put_varint
+
+void EventRecorder::
+begin(uint8_t tag) noexcept {
+    const uint64_t now = ::la::get_monotonic_ns();
+    const uint64_t delta = m_last_ns ? now - m_last_ns : 0;
+    m_last_ns = now;
+    put_byte(tag);
+    put_varint(delta);
+} // begin
+
+void EventRecorder::
+on_scroll_vertical(float delta) noexcept {
+    begin(detail::REC_SCROLL);
+    detail::FloatBits bits;
+    bits.f = delta;
+    for (int i = 0; i < 4; ++i) put_byte(static_cast<uint8_t>(bits.u >> (8 * i)));
+    m_inner->on_scroll_vertical(delta);
+} // on_scroll_vertical
+
+void EventRecorder::
+on_resize(int width, int height) noexcept {
+    begin(detail::REC_RESIZE);
+    put_varint(static_cast<uint64_t>(width));
+    put_varint(static_cast<uint64_t>(height));
+    m_inner->on_resize(width, height);
+} // on_resize
+
+void EventRecorder::
+on_mouse_move(int x, int y) noexcept {
+    begin(detail::REC_MOUSE_MOVE);
+    put_varint(detail::zigzag(x));
+    put_varint(detail::zigzag(y));
+    m_inner->on_mouse_move(x, y);
+} // on_mouse_move
+
+void EventRecorder::
+on_key_down(Key k) noexcept {
+    begin(detail::REC_KEY_DOWN);
+    put_varint(static_cast<uint64_t>(k));
+    m_inner->on_key_down(k);
+} // on_key_down
+
+void EventRecorder::
+on_key_up(Key k) noexcept {
+    begin(detail::REC_KEY_UP);
+    put_varint(static_cast<uint64_t>(k));
+    m_inner->on_key_up(k);
+} // on_key_up
+
+void EventRecorder::
+on_focus_change(bool gained) noexcept {
+    begin(detail::REC_FOCUS);
+    put_byte(gained ? 1 : 0);
+    m_inner->on_focus_change(gained);
+} // on_focus_change
+
+void EventRecorder::
+on_render_software() noexcept {
+    begin(detail::REC_FRAME);
+    m_inner->on_render_software();
+} // on_render_software
+
+void EventRecorder::
+on_render_opengl() noexcept {
+    begin(detail::REC_FRAME);
+    m_inner->on_render_opengl();
+} // on_render_opengl
+
+bool EventRecorder::
+save(const char* path) const noexcept {
+    if (m_failed) return false;
+
+    // Header and records in one write, so a partial file never looks valid
+    LA_ALLOC_TAG(AllocTag::Replay);
+    const size_t total = EventReplay::HEADER_SIZE + m_size;
+    uint8_t* file = static_cast<uint8_t*>(::la::alloc(total));
+    if (!file) return false;
+    for (int i = 0; i < 4; ++i) file[i] = detail::REPLAY_MAGIC[i];
+    file[4] = detail::REPLAY_VERSION;
+    file[5] = file[6] = file[7] = 0;
+    for (size_t i = 0; i < m_size; ++i) file[EventReplay::HEADER_SIZE + i] = m_data[i];
+
+    const bool ok = ::la::write_file(path, file, total);
+    ::la::free(file, total);
+    return ok;
+} // save
+
+// ------------------------------ Replay --------------------------------------
+
+struct EventReplay::Record {
+    uint8_t tag;
+    uint64_t delta_ns;
+    uint64_t a; // x, width, key or focus
+    uint64_t b; // y, height or float bits
+    size_t next; // Offset after the record
+}; // struct Record
+
+EventReplay::
+~EventReplay() noexcept {
+    LA_ALLOC_TAG(AllocTag::Replay);
+    if (m_data) ::la::free(m_data, m_size);
+} // ~EventReplay
+
+bool EventReplay::
+load(const char* path) noexcept {
+    LA_ALLOC_TAG(AllocTag::Replay); // `read_file()` included
+    if (m_data) ::la::free(m_data, m_size);
+    m_data = nullptr;
+    m_size = m_pos = 0;
+
+    size_t size = 0;
+    uint8_t* data = static_cast<uint8_t*>(::la::read_file(path, &size));
+    if (!data) return false;
+
+    bool valid = size >= HEADER_SIZE && data[4] == detail::REPLAY_VERSION;
+    for (int i = 0; valid && i < 4; ++i) valid = data[i] == detail::REPLAY_MAGIC[i];
+    if (!valid) {
+        ::la::free(data, size);
+        return false;
+    }
+    m_data = data;
+    m_size = size;
+    rewind();
+    return true;
+} // load
+
+bool EventReplay::
+peek(Record& r) const noexcept {
+    size_t pos = m_pos;
+    auto varint = [&](uint64_t& out) noexcept {
+        out = 0;
+        for (unsigned shift = 0; pos < m_size && shift < 64; shift += 7) {
+            const uint8_t byte = m_data[pos++];
+            out |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    };
+
+    if (pos >= m_size) return false;
+    r.tag = m_data[pos++];
+    r.a = r.b = 0;
+    if (r.tag >= detail::REC__LAST__ || !varint(r.delta_ns))
+        return false;
+
+    bool ok = true;
+    switch (r.tag) {
+    case detail::REC_MOUSE_MOVE:
+    case detail::REC_RESIZE:
+        ok = varint(r.a) && varint(r.b);
+        break;
+    case detail::REC_KEY_DOWN:
+    case detail::REC_KEY_UP:
+        ok = varint(r.a) && r.a < static_cast<uint64_t>(Key::__LAST__);
+        break;
+    case detail::REC_FOCUS:
+        ok = pos < m_size;
+        if (ok) r.a = m_data[pos++];
+        break;
+    case detail::REC_SCROLL:
+        ok = m_size - pos >= 4;
+        for (int i = 0; ok && i < 4; ++i) r.b |= static_cast<uint64_t>(m_data[pos++]) << (8 * i);
+        break;
+    } // switch
+    r.next = pos;
+    return ok;
+} // peek
+
+void EventReplay::
+dispatch(IWindowEvents& handler, const Record& r) noexcept {
+    switch (r.tag) {
+    case detail::REC_MOUSE_MOVE:
+        handler.on_mouse_move(detail::unzigzag(r.a), detail::unzigzag(r.b));
+        break;
+    case detail::REC_SCROLL: {
+        detail::FloatBits bits;
+        bits.u = static_cast<uint32_t>(r.b);
+        handler.on_scroll_vertical(bits.f);
+        break;
+    }
+    case detail::REC_KEY_DOWN: handler.on_key_down(static_cast<Key>(r.a));  break;
+    case detail::REC_KEY_UP:   handler.on_key_up(static_cast<Key>(r.a));    break;
+    case detail::REC_FOCUS:    handler.on_focus_change(r.a != 0);           break;
+    case detail::REC_RESIZE:
+        handler.on_resize(static_cast<int>(r.a), static_cast<int>(r.b));
+        break;
+    } // switch: frames are markers only
+} // dispatch
+
+bool EventReplay::
+play_frame(IWindowEvents& handler) noexcept {
+    Record r;
+    bool any = false;
+    while (peek(r)) {
+        m_pos = r.next;
+        m_time_ns += r.delta_ns;
+        any = true;
+        if (r.tag == detail::REC_FRAME) break;
+        dispatch(handler, r);
+    }
+    if (!any) m_pos = m_size; // Truncated or corrupt tail: stop
+    return any;
+} // play_frame
+
+unsigned EventReplay::
+play_until(IWindowEvents& handler, uint64_t elapsed_ns) noexcept {
+    Record r;
+    unsigned count = 0;
+    while (peek(r) && m_time_ns + r.delta_ns <= elapsed_ns) {
+        m_pos = r.next;
+        m_time_ns += r.delta_ns;
+        if (r.tag == detail::REC_FRAME) continue;
+        dispatch(handler, r);
+        ++count;
+    }
+    if (m_pos < m_size && !peek(r)) m_pos = m_size;
+    return count;
+} // play_until
+
+} // namespace la
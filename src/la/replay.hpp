@@ -0,0 +1,96 @@
+#ifndef __LA_REPLAY_HEADER_GUARD
+#define __LA_REPLAY_HEADER_GUARD
+
+#include "la.hpp"
+
+/*
+    Input recording and deterministic replay. `EventRecorder` sits between
+    the window and the app's handler, forwards every callback and appends it
+    to a compact binary log (varint time deltas, one tag byte per event).
+    Rendered frames are logged too, so a replay can reproduce the exact
+    per-frame batches at full speed, independent of timing:
+
+        la::EventRecorder recorder{ app };        // Record a session
+        win.set_handler(recorder);
+        ...
+        (void)recorder.save("session.laev");
+
+        la::EventReplay replay;                   // Benchmark it later
+        if (replay.load("session.laev"))
+            while (replay.play_frame(app))
+                app.on_render_software();
+*/
+
+namespace la {
+
+struct EventRecorder final : IWindowEvents {
+    explicit EventRecorder(IWindowEvents& inner) noexcept : m_inner{ &inner } {}
+    ~EventRecorder() noexcept;
+
+    EventRecorder(const EventRecorder&) = delete;
+    EventRecorder& operator=(const EventRecorder&) = delete;
+
+    void on_scroll_vertical(float delta) noexcept override;
+    void on_resize(int width, int height) noexcept override;
+    void on_mouse_move(int x, int y) noexcept override;
+    void on_key_down(Key) noexcept override;
+    void on_key_up(Key) noexcept override;
+    void on_focus_change(bool gained) noexcept override;
+    void on_render_software() noexcept override;
+    void on_render_opengl() noexcept override;
+    void on_error(Error e, AboutError about) noexcept override { m_inner->on_error(e, about); }
+
+    // False when the file couldn't be written or memory ran out while recording
+    LA_NO_DISCARD bool save(const char* path) const noexcept;
+    void clear() noexcept { m_size = 0; m_last_ns = 0; m_failed = false; }
+
+    LA_NO_DISCARD size_t size_bytes() const noexcept { return m_size; }
+    LA_NO_DISCARD IWindowEvents& inner() const noexcept { return *m_inner; }
+
+private:
+    void begin(uint8_t tag) noexcept;
+    void put_byte(uint8_t b) noexcept;
+    void put_varint(uint64_t v) noexcept;
+
+    IWindowEvents* m_inner;
+    uint8_t* m_data{ nullptr };
+    size_t m_size{ 0 };
+    size_t m_capacity{ 0 };
+    uint64_t m_last_ns{ 0 }; // 0 until the first event
+    bool m_failed{ false };
+}; // struct EventRecorder
+
+struct EventReplay {
+    EventReplay() noexcept = default;
+    ~EventReplay() noexcept;
+
+    EventReplay(const EventReplay&) = delete;
+    EventReplay& operator=(const EventReplay&) = delete;
+
+    // False when the file is missing or isn't a recording
+    LA_NO_DISCARD bool load(const char* path) noexcept;
+    void rewind() noexcept { m_pos = HEADER_SIZE; m_time_ns = 0; }
+
+    // Full speed: the events of the next recorded frame. False when nothing is left
+    bool play_frame(IWindowEvents& handler) noexcept;
+    // Recorded speed: every event due `elapsed_ns` after the first, returns the count
+    unsigned play_until(IWindowEvents& handler, uint64_t elapsed_ns) noexcept;
+
+    LA_NO_DISCARD bool done() const noexcept { return m_pos >= m_size; }
+
+    LA_CONSTEXPR_VAR static size_t HEADER_SIZE = 8;
+
+private:
+    struct Record;
+    LA_NO_DISCARD bool peek(Record& r) const noexcept;
+    void dispatch(IWindowEvents& handler, const Record& r) noexcept;
+
+    uint8_t* m_data{ nullptr };
+    size_t m_size{ 0 };
+    size_t m_pos{ 0 };
+    uint64_t m_time_ns{ 0 }; // Recorded time of the last played record
+}; // struct EventReplay
+
+} // namespace la
+
+#endif // __LA_REPLAY_HEADER_GUARD
@@ -0,0 +1,96 @@
+#include "scheduler.hpp"
+
+namespace la {
+
+FrameScheduler::
+FrameScheduler(const Config& config) noexcept
+    : m_config{ config }, m_margin{ static_cast<uint64_t>(config.spin_secs * 1e9) } {
+    m_stats.sleep_margin_secs = m_margin / 1e9;
+} // FrameScheduler
+
+void FrameScheduler::
+reset_stats() noexcept {
+    m_stats = Stats{};
+    m_stats.sleep_margin_secs = m_margin / 1e9;
+} // reset_stats
+
+void FrameScheduler::
+update_mode(uint64_t now_ns) noexcept {
+    if (now_ns < m_next_battery_poll) return;
+    m_next_battery_poll = now_ns + static_cast<uint64_t>(m_config.battery_poll_secs * 1e9);
+
+    PacingMode mode = PacingMode::Paced;
+    if (m_config.throttle_on_battery && ::la::is_battery_in_use())
+        mode = m_config.battery_hz > 0.0 ? PacingMode::LowPower : PacingMode::EventDriven;
+
+    if (mode != m_mode) {
+        m_mode = mode;
+        m_started = false; // Re-phase, don't count the switch as missed
+        m_requested = true;
+    }
+} // update_mode
+
+void FrameScheduler::
+sleep_until(uint64_t deadline_ns) noexcept {
+    // Sleep up to the usual oversleep before the deadline, when that is worth it
+    const uint64_t wake_ns = deadline_ns > m_margin ? deadline_ns - m_margin : 0;
+    if (::la::get_monotonic_ns() + 500000 < wake_ns) {
+        ::la::sleep_until(wake_ns);
+
+        // Grow at once, decay slowly: one late wake-up costs a missed frame
+        const uint64_t now_ns = ::la::get_monotonic_ns();
+        const uint64_t over = now_ns > wake_ns ? now_ns - wake_ns : 0;
+        m_margin = over > m_margin ? over : (m_margin * 19 + over) / 20;
+        m_stats.sleep_margin_secs = m_margin / 1e9;
+    }
+
+    // Spin the rest
+    ::la::sleep_until(deadline_ns, deadline_ns);
+} // sleep_until
+
+bool FrameScheduler::
+wait() noexcept {
+    const uint64_t now = ::la::get_monotonic_ns();
+    update_mode(now);
+
+    if (m_mode == PacingMode::EventDriven) {
+        if (!m_requested) {
+            if (m_wait) {
+                // Wake up for the next battery check at the latest
+                const uint64_t timeout = m_next_battery_poll > now ? m_next_battery_poll - now : 0;
+                if (!m_wait(m_wait_context, timeout)) return false;
+            }
+            else ::la::sleep(m_config.idle_sleep_ms);
+        }
+        if (!m_requested) return false;
+        m_requested = false;
+        ++m_stats.frames;
+        return true;
+    }
+
+    const double hz = m_mode == PacingMode::LowPower ? m_config.battery_hz : m_config.refresh_hz;
+    const uint64_t period = hz > 0.0 ? static_cast<uint64_t>(1e9 / hz) : 0;
+    m_requested = false;
+    ++m_stats.frames;
+
+    if (!m_started || period == 0) { // First frame or uncapped
+        m_started = true;
+        m_deadline = now;
+        return true;
+    }
+
+    m_deadline += period;
+    if (now > m_deadline) {
+        // Late: start now instead of bursting frames to catch up
+        const double late = (now - m_deadline) / 1e9;
+        if (late > m_stats.worst_late_secs) m_stats.worst_late_secs = late;
+        ++m_stats.missed;
+        m_deadline = now;
+        return true;
+    }
+
+    sleep_until(m_deadline);
+    return true;
+} // wait
+
+} // namespace la
@@ -0,0 +1,93 @@
+#ifndef __LA_SCHEDULER_HEADER_GUARD
+#define __LA_SCHEDULER_HEADER_GUARD
+
+#include "la.hpp"
+
+/*
+    Frame pacing for the main loop. `wait()` sleeps until shortly before the
+    next deadline (`la::sleep_until`) and spins the rest; the sleep margin
+    adapts to how much the OS oversleeps. On battery the scheduler drops to a
+    lower rate, or renders only after `request_frame()`: then `wait()` blocks
+    in `win.wait_events()` until input arrives.
+
+        la::FrameScheduler scheduler;
+        scheduler.set_wait(win);
+        while (win.poll_events()) {
+            if (scheduler.wait())
+                win.render();
+        }
+*/
+
+namespace la {
+
+enum class PacingMode : uint8_t {
+    Paced,       // `refresh_hz`
+    LowPower,    // `battery_hz`
+    EventDriven, // Only after `request_frame()`
+}; // enum class PacingMode
+
+struct FrameScheduler {
+    struct Config {
+        double refresh_hz{ 60.0 };      // 0 is uncapped
+        double battery_hz{ 30.0 };      // 0 is event-driven on battery
+        bool   throttle_on_battery{ true };
+        double battery_poll_secs{ 1.0 }; // `is_battery_in_use()` is a system call
+        double spin_secs{ 0.002 };       // Initial sleep margin spent spinning
+        unsigned idle_sleep_ms{ 10 };    // Event-driven polling interval without `set_wait()`
+    }; // struct Config
+
+    // Block until input, a wake-up or `timeout_ns`; false when no more events will come
+    using WaitProc = bool (*)(void* context, uint64_t timeout_ns) noexcept;
+
+    struct Stats {
+        uint64_t frames{ 0 };
+        uint64_t missed{ 0 };            // Frames that started after their deadline
+        double   worst_late_secs{ 0.0 };
+        double   sleep_margin_secs{ 0.0 }; // Current oversleep estimate
+    }; // struct Stats
+
+    explicit inline FrameScheduler() noexcept : FrameScheduler{ Config{} } {}
+    explicit FrameScheduler(const Config& config) noexcept;
+
+    // Block until the next frame is due, false when there is nothing to render
+    LA_NO_DISCARD bool wait() noexcept;
+
+    // Input or content changed, wakes the event-driven mode
+    void request_frame() noexcept { m_requested = true; }
+
+    // Event-driven mode blocks in `proc` until something may need a frame, instead of
+    // polling every `idle_sleep_ms`. Handlers that `request_frame()` end the wait
+    void set_wait(WaitProc proc, void* context) noexcept { m_wait = proc; m_wait_context = context; }
+    // Same through `window.wait_events()`, the window must outlive the scheduler.
+    // Inline so builds without a `Window` backend link as long as it goes unused
+    void set_wait(const Window& window) noexcept { set_wait(&wait_window, const_cast<Window*>(&window)); }
+
+    void set_refresh_rate(double hz) noexcept { m_config.refresh_hz = hz; }
+    void reset_stats() noexcept;
+
+    LA_NO_DISCARD PacingMode mode() const noexcept { return m_mode; }
+    LA_NO_DISCARD const Config& config() const noexcept { return m_config; }
+    LA_NO_DISCARD const Stats& stats() const noexcept { return m_stats; }
+
+private:
+    void update_mode(uint64_t now_ns) noexcept;
+    void sleep_until(uint64_t deadline_ns) noexcept;
+    static bool wait_window(void* window, uint64_t timeout_ns) noexcept {
+        return static_cast<const Window*>(window)->wait_events(timeout_ns);
+    }
+
+    Config m_config;
+    Stats m_stats{};
+    PacingMode m_mode{ PacingMode::Paced };
+    uint64_t m_deadline{ 0 }; // `get_monotonic_ns()` clock
+    uint64_t m_next_battery_poll{ 0 };
+    uint64_t m_margin;
+    WaitProc m_wait{ nullptr };
+    void* m_wait_context{ nullptr };
+    bool m_started{ false };
+    bool m_requested{ true }; // First frame always renders
+}; // struct FrameScheduler
+
+} // namespace la
+
+#endif // __LA_SCHEDULER_HEADER_GUARD
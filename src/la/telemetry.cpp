@@ -0,0 +1,220 @@
+#include "la.hpp"
+
+// Allocation telemetry: per-thread counter slots, summed on demand
+
+namespace la {
+
+namespace detail {
+    LA_CONSTEXPR_VAR unsigned TELEMETRY_TAGS = AllocTelemetry::TAGS;
+    // One counter per layer and tag, `layer * TELEMETRY_TAGS + tag`
+    LA_CONSTEXPR_VAR unsigned TELEMETRY_COUNTERS = AllocTelemetry::LAYERS * TELEMETRY_TAGS;
+    LA_CONSTEXPR_VAR unsigned TELEMETRY_SLOTS = 64; // Threads past the 63rd share the last one
+
+    // Only the owning thread writes a slot, so counters are bumped with a plain
+    // load and store. The shared last slot falls back to `fetch_add`
+    struct alignas(64) TelemetrySlot {
+        Atomic<uint64_t> alloc_bytes[TELEMETRY_COUNTERS];
+        Atomic<uint64_t> alloc_count[TELEMETRY_COUNTERS];
+        Atomic<uint64_t> free_bytes[TELEMETRY_COUNTERS];
+        Atomic<uint64_t> free_count[TELEMETRY_COUNTERS];
+    }; // struct TelemetrySlot
+
+    // Slots are never released: counts of exited threads stay in the sums
+    static TelemetrySlot g_telemetry_slots[TELEMETRY_SLOTS];
+    static Atomic<uint32_t> g_telemetry_slot_count{ 0 };
+
+    // Sampled by `alloc_telemetry_frame()` and `alloc_telemetry()`
+    static Atomic<uint64_t> g_telemetry_peak[TELEMETRY_COUNTERS];
+    static Atomic<uint64_t> g_telemetry_max_frame[TELEMETRY_COUNTERS];
+    static Atomic<uint64_t> g_telemetry_frames{ 0 };
+    // Totals at the last two frame ends. Only the frame-ending thread writes them
+    static uint64_t g_telemetry_frame_start_bytes[TELEMETRY_COUNTERS];
+    static uint64_t g_telemetry_frame_start_count[TELEMETRY_COUNTERS];
+    static uint64_t g_telemetry_frame_bytes[TELEMETRY_COUNTERS];
+    static uint64_t g_telemetry_frame_count[TELEMETRY_COUNTERS];
+
+#if defined(LA_ALLOC_TELEMETRY)
+    static thread_local TelemetrySlot* t_telemetry_slot = nullptr;
+    static thread_local uint8_t t_alloc_tag = 0; // `AllocTag::General`
+
+    LA_NO_DISCARD static inline TelemetrySlot&
+    telemetry_slot() noexcept {
+        if (!t_telemetry_slot) {
+            const uint32_t index = g_telemetry_slot_count.fetch_add(1);
+            t_telemetry_slot = &g_telemetry_slots[index < TELEMETRY_SLOTS ? index : TELEMETRY_SLOTS - 1];
+        }
+        return *t_telemetry_slot;
+    } // telemetry_slot
+
+    static inline void
+    bump(TelemetrySlot& slot, Atomic<uint64_t>& counter, uint64_t value) noexcept {
+        if (&slot == &g_telemetry_slots[TELEMETRY_SLOTS - 1]) counter.fetch_add(value);
+        else counter.store_relaxed(counter.load_relaxed() + value);
+    } // bump
+
+    AllocTag
+    swap_alloc_tag(AllocTag tag) noexcept {
+        const AllocTag previous = static_cast<AllocTag>(t_alloc_tag);
+        t_alloc_tag = static_cast<uint8_t>(tag);
+        return previous;
+    } // swap_alloc_tag
+
+    AllocTag
+    current_alloc_tag() noexcept { return static_cast<AllocTag>(t_alloc_tag); }
+
+    LA_NO_DISCARD static inline unsigned
+    counter_index(AllocLayer layer, AllocTag tag) noexcept {
+        return static_cast<unsigned>(layer) * TELEMETRY_TAGS + static_cast<unsigned>(tag);
+    } // counter_index
+
+    void
+    telemetry_alloc(AllocTag tag, size_t bytes, AllocLayer layer) noexcept {
+        TelemetrySlot& slot = telemetry_slot();
+        const unsigned t = counter_index(layer, tag);
+        bump(slot, slot.alloc_bytes[t], bytes);
+        bump(slot, slot.alloc_count[t], 1);
+    } // telemetry_alloc
+
+    void
+    telemetry_free(AllocTag tag, size_t bytes, AllocLayer layer) noexcept {
+        TelemetrySlot& slot = telemetry_slot();
+        const unsigned t = counter_index(layer, tag);
+        bump(slot, slot.free_bytes[t], bytes);
+        bump(slot, slot.free_count[t], 1);
+    } // telemetry_free
+#endif // LA_ALLOC_TELEMETRY
+
+    struct TelemetryTotals {
+        uint64_t alloc_bytes[TELEMETRY_COUNTERS];
+        uint64_t alloc_count[TELEMETRY_COUNTERS];
+        uint64_t free_bytes[TELEMETRY_COUNTERS];
+        uint64_t free_count[TELEMETRY_COUNTERS];
+    }; // struct TelemetryTotals
+
+    static void
+    sum_slots(TelemetryTotals& totals) noexcept {
+        totals = TelemetryTotals{};
+        const uint32_t claimed = g_telemetry_slot_count.load();
+        const uint32_t slots = claimed < TELEMETRY_SLOTS ? claimed : TELEMETRY_SLOTS;
+        for (uint32_t s = 0; s < slots; ++s) {
+            const TelemetrySlot& slot = g_telemetry_slots[s];
+            for (unsigned t = 0; t < TELEMETRY_COUNTERS; ++t) {
+                totals.alloc_bytes[t] += slot.alloc_bytes[t].load_relaxed();
+                totals.alloc_count[t] += slot.alloc_count[t].load_relaxed();
+                totals.free_bytes[t] += slot.free_bytes[t].load_relaxed();
+                totals.free_count[t] += slot.free_count[t].load_relaxed();
+            }
+        }
+    } // sum_slots
+
+    // A free counted by one thread can be summed before the matching alloc of another
+    LA_NO_DISCARD static inline uint64_t
+    live(uint64_t allocated, uint64_t freed) noexcept {
+        return allocated > freed ? allocated - freed : 0;
+    } // live
+
+    static void
+    raise_to(Atomic<uint64_t>& counter, uint64_t value) noexcept {
+        uint64_t seen = counter.load();
+        while (value > seen && !counter.compare_exchange(seen, value)) {}
+    } // raise_to
+} // namespace detail
+
+// ------------------------------ Queries -------------------------------------
+
+const char*
+alloc_tag_name(AllocTag tag) noexcept {
+    static const char* const NAMES[AllocTelemetry::TAGS] = {
+        "general", "arena", "pool", "heap", "surface", "framebuffer",
+        "profiler", "ui", "replay", "jobs", "user0", "user1", "user2", "user3"
+    };
+    const unsigned t = static_cast<unsigned>(tag);
+    return t < AllocTelemetry::TAGS ? NAMES[t] : "?";
+} // alloc_tag_name
+
+const char*
+alloc_layer_name(AllocLayer layer) noexcept {
+    static const char* const NAMES[AllocTelemetry::LAYERS] = { "system", "heap" };
+    const unsigned l = static_cast<unsigned>(layer);
+    return l < AllocTelemetry::LAYERS ? NAMES[l] : "?";
+} // alloc_layer_name
+
+void
+alloc_telemetry_frame() noexcept {
+    using namespace detail;
+    TelemetryTotals totals;
+    sum_slots(totals);
+    for (unsigned t = 0; t < TELEMETRY_COUNTERS; ++t) {
+        raise_to(g_telemetry_peak[t], live(totals.alloc_bytes[t], totals.free_bytes[t]));
+
+        g_telemetry_frame_bytes[t] = totals.alloc_bytes[t] - g_telemetry_frame_start_bytes[t];
+        g_telemetry_frame_count[t] = totals.alloc_count[t] - g_telemetry_frame_start_count[t];
+        g_telemetry_frame_start_bytes[t] = totals.alloc_bytes[t];
+        g_telemetry_frame_start_count[t] = totals.alloc_count[t];
+        raise_to(g_telemetry_max_frame[t], g_telemetry_frame_bytes[t]);
+    }
+    g_telemetry_frames.fetch_add(1);
+} // alloc_telemetry_frame
+
+AllocTelemetry
+alloc_telemetry() noexcept {
+    using namespace detail;
+    TelemetryTotals totals;
+    sum_slots(totals);
+
+    AllocTelemetry result;
+    result.frames = g_telemetry_frames.load();
+    for (unsigned t = 0; t < TELEMETRY_COUNTERS; ++t) {
+        AllocTagStats& stats = result.tags[t / TELEMETRY_TAGS][t % TELEMETRY_TAGS];
+        stats.live_bytes = live(totals.alloc_bytes[t], totals.free_bytes[t]);
+        stats.live_count = live(totals.alloc_count[t], totals.free_count[t]);
+        stats.total_bytes = totals.alloc_bytes[t];
+        stats.total_count = totals.alloc_count[t];
+        raise_to(g_telemetry_peak[t], stats.live_bytes);
+        stats.peak_bytes = g_telemetry_peak[t].load();
+        stats.frame_bytes = g_telemetry_frame_bytes[t];
+        stats.frame_count = g_telemetry_frame_count[t];
+        stats.max_frame_bytes = g_telemetry_max_frame[t].load();
+    }
+    return result;
+} // alloc_telemetry
+
+// ------------------------------ Reports -------------------------------------
+
+void
+alloc_telemetry_dump(Out& out) noexcept {
+    const AllocTelemetry telemetry = alloc_telemetry();
+    out << "Allocations, KB (live / peak / frame / worst frame, count live / frame) after "
+        << telemetry.frames << " frames:\n";
+    for (unsigned t = 0; t < detail::TELEMETRY_COUNTERS; ++t) {
+        const unsigned layer = t / AllocTelemetry::TAGS, tag = t % AllocTelemetry::TAGS;
+        const AllocTagStats& s = telemetry.tags[layer][tag];
+        if (!s.total_count) continue;
+        out << '\t' << alloc_layer_name(static_cast<AllocLayer>(layer)) << ' '
+            << alloc_tag_name(static_cast<AllocTag>(tag)) << ": "
+            << s.live_bytes / 1024.0 << " / " << s.peak_bytes / 1024.0 << " / "
+            << s.frame_bytes / 1024.0 << " / " << s.max_frame_bytes / 1024.0 << ", "
+            << s.live_count << " / " << s.frame_count << '\n';
+    }
+    out.flush();
+} // alloc_telemetry_dump
+
+uint64_t
+alloc_leak_report(Out& out) noexcept {
+    const AllocTelemetry telemetry = alloc_telemetry();
+    uint64_t leaked = 0;
+    for (unsigned t = 0; t < detail::TELEMETRY_COUNTERS; ++t) {
+        const unsigned layer = t / AllocTelemetry::TAGS, tag = t % AllocTelemetry::TAGS;
+        const AllocTagStats& s = telemetry.tags[layer][tag];
+        if (!s.live_count) continue;
+        if (!leaked) out << "Allocations still live:\n";
+        out << '\t' << alloc_layer_name(static_cast<AllocLayer>(layer)) << ' '
+            << alloc_tag_name(static_cast<AllocTag>(tag)) << ": "
+            << s.live_count << " blocks, " << s.live_bytes << " bytes\n";
+        leaked += s.live_count;
+    }
+    if (leaked) out.flush();
+    return leaked;
+} // alloc_leak_report
+
+} // namespace la
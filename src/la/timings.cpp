@@ -0,0 +1,121 @@
+#include "la.hpp"
+
+// Platform-independent part of `la::FrameTimings`, the hot path is inline in la.hpp
+
+namespace la {
+
+bool FrameTimings::
+end_frame() noexcept {
+    m_frames.store_relaxed(m_frames.load_relaxed() + 1);
+    if (++m_slot_frames < FRAMES_PER_SLOT)
+        return false;
+    m_slot_frames = 0;
+
+    // Empty the oldest slot before it becomes the current one
+    const uint32_t next = (m_slot.load_relaxed() + 1) % SLOTS;
+    for (unsigned p = 0; p < PHASES; ++p) {
+        for (unsigned b = 0; b < BUCKETS; ++b)
+            m_counts[p][next][b].store_relaxed(0);
+        m_max[p][next].store_relaxed(0);
+    }
+    for (unsigned i = 0; i < PerfSample::COUNT + 2; ++i)
+        m_perf[next][i].store_relaxed(0);
+    m_slot.store(next);
+    return true;
+} // end_frame
+
+void FrameTimings::
+record_perf(const PerfSample& delta, uint64_t pixels) noexcept {
+    const uint32_t slot = m_slot.load_relaxed();
+    Atomic<uint64_t>* sums = m_perf[slot];
+    for (unsigned i = 0; i < PerfSample::COUNT; ++i)
+        sums[i].store_relaxed(sums[i].load_relaxed() + delta.values[i]);
+    sums[PerfSample::COUNT].store_relaxed(sums[PerfSample::COUNT].load_relaxed() + 1);
+    sums[PerfSample::COUNT + 1].store_relaxed(sums[PerfSample::COUNT + 1].load_relaxed() + pixels);
+    m_perf_valid.store_relaxed(delta.valid);
+} // record_perf
+
+PerfSample FrameTimings::
+perf_totals(uint64_t* frames, uint64_t* pixels) const noexcept {
+    PerfSample total;
+    uint64_t frame_sum = 0, pixel_sum = 0;
+    for (unsigned slot = 0; slot < SLOTS; ++slot) {
+        for (unsigned i = 0; i < PerfSample::COUNT; ++i)
+            total.values[i] += m_perf[slot][i].load_relaxed();
+        frame_sum += m_perf[slot][PerfSample::COUNT].load_relaxed();
+        pixel_sum += m_perf[slot][PerfSample::COUNT + 1].load_relaxed();
+    }
+    total.valid = static_cast<uint8_t>(m_perf_valid.load_relaxed());
+    if (frames) *frames = frame_sum;
+    if (pixels) *pixels = pixel_sum;
+    return total;
+} // perf_totals
+
+FramePercentiles FrameTimings::
+percentiles(FramePhase phase) const noexcept {
+    const unsigned p = static_cast<unsigned>(phase);
+    FramePercentiles result{};
+
+    uint64_t counts[BUCKETS];
+    for (unsigned b = 0; b < BUCKETS; ++b) {
+        uint64_t sum = 0;
+        for (unsigned slot = 0; slot < SLOTS; ++slot)
+            sum += m_counts[p][slot][b].load_relaxed();
+        counts[b] = sum;
+        result.count += sum;
+    }
+    for (unsigned slot = 0; slot < SLOTS; ++slot) {
+        const uint64_t max = m_max[p][slot].load_relaxed();
+        if (max > result.max_ns) result.max_ns = max;
+    }
+    if (result.count == 0)
+        return result;
+
+    // Nearest rank, reported as the bucket's upper bound but never above max
+    const uint64_t ranks[3] = {
+        (result.count * 50 + 99) / 100,
+        (result.count * 95 + 99) / 100,
+        (result.count * 99 + 99) / 100,
+    };
+    uint64_t* outputs[3] = { &result.p50_ns, &result.p95_ns, &result.p99_ns };
+
+    uint64_t seen = 0;
+    unsigned next = 0;
+    for (unsigned b = 0; b < BUCKETS && next < 3; ++b) {
+        seen += counts[b];
+        while (next < 3 && seen >= ranks[next]) {
+            const uint64_t limit = bucket_limit(b);
+            *outputs[next++] = limit < result.max_ns ? limit : result.max_ns;
+        }
+    }
+    return result;
+} // percentiles
+
+void FrameTimings::
+dump(Out& out) const noexcept {
+    static const char* const NAMES[PHASES] = { "poll", "handler", "present", "idle", "frame" };
+
+    out << "Frame timings, ms (p50 / p95 / p99 / max) after " << frames() << " frames:\n";
+    for (unsigned p = 0; p < PHASES; ++p) {
+        const FramePercentiles f = percentiles(static_cast<FramePhase>(p));
+        out << '\t' << NAMES[p] << ": "
+            << f.p50_ns / 1e6 << " / " << f.p95_ns / 1e6 << " / "
+            << f.p99_ns / 1e6 << " / " << f.max_ns / 1e6 << '\n';
+    }
+
+    uint64_t frames = 0, pixels = 0;
+    const PerfSample perf = perf_totals(&frames, &pixels);
+    if (frames && perf.valid) {
+        out << "\tcounters: IPC " << perf.ipc();
+        if (perf.has(PerfCounter::LlcMisses) && pixels)
+            out << ", LLC misses/pixel " << static_cast<double>(perf[PerfCounter::LlcMisses]) / pixels;
+        if (perf.has(PerfCounter::BranchMisses))
+            out << ", branch misses/frame " << perf[PerfCounter::BranchMisses] / frames;
+        if (perf.has(PerfCounter::DtlbMisses))
+            out << ", dTLB misses/frame " << perf[PerfCounter::DtlbMisses] / frames;
+        out << '\n';
+    }
+    out.flush();
+} // dump
+
+} // namespace la
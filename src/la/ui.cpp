@@ -0,0 +1,568 @@
+#include "ui.hpp"
+
+namespace la {
+namespace ui {
+
+// ------------------------------ Helpers -------------------------------------
+
+namespace detail {
+    enum : uint8_t {
+        ALIVE         = 1 << 0,
+        NEEDS_LAYOUT  = 1 << 1,
+        NEEDS_PAINT   = 1 << 2, // Own rect must be repainted
+        SUBTREE_PAINT = 1 << 3, // Some descendant needs paint
+        BOUNDARY      = 1 << 4, // Explicit relayout boundary
+        QUEUED        = 1 << 5, // In the dirty boundary list
+    };
+
+    // Capacity stays a multiple of 8, so every array in the slab is 8-byte aligned
+    LA_CONSTEXPR_VAR uint32_t INITIAL_CAPACITY = 64;
+    LA_CONSTEXPR_VAR size_t NODE_BYTES =
+        sizeof(const char*) + sizeof(Constraints) + sizeof(Rect) +
+        sizeof(NodeId) * 6 /* links + dirty */ + sizeof(uint32_t) * 2 /* depth, color */ +
+        sizeof(int32_t) * 6 /* params, x, y, w, h */ + sizeof(uint16_t) + sizeof(uint8_t) * 2;
+
+    template<typename T>
+    static inline void
+    move_array(T*& array, unsigned char*& cursor, uint32_t capacity, uint32_t used) noexcept {
+        T* dst = reinterpret_cast<T*>(cursor);
+        for (uint32_t i = 0; i < used; ++i) dst[i] = array[i];
+        array = dst;
+        cursor += sizeof(T) * capacity;
+    } // move_array
+
+    LA_NO_DISCARD static inline int
+    max_int(int a, int b) noexcept { return a > b ? a : b; }
+
+    // Shallow boundaries first so deeper ones are usually clean by their turn.
+    // Heap sort: no allocation, no recursion
+    static void
+    sort_by_depth(NodeId* nodes, uint32_t count, const uint32_t* depth) noexcept {
+        auto sift = [&](uint32_t root, uint32_t end) {
+            for (;;) {
+                uint32_t child = 2 * root + 1;
+                if (child >= end) return;
+                if (child + 1 < end && depth[nodes[child + 1]] > depth[nodes[child]]) ++child;
+                if (depth[nodes[root]] >= depth[nodes[child]]) return;
+                const NodeId t = nodes[root]; nodes[root] = nodes[child]; nodes[child] = t;
+                root = child;
+            }
+        };
+        for (uint32_t i = count / 2; i-- > 0;)
+            sift(i, count);
+        for (uint32_t end = count; end-- > 1;) {
+            const NodeId t = nodes[0]; nodes[0] = nodes[end]; nodes[end] = t;
+            sift(0, end);
+        }
+    } // sort_by_depth
+} // namespace detail
+
+// ------------------------------ Storage -------------------------------------
+
+Tree::
+Tree() noexcept {
+    if (!reserve(detail::INITIAL_CAPACITY))
+        return;
+    m_root = create(Kind::Box, NONE);
+    m_color[m_root] = 0xFF000000; // Damage always has a background
+} // Tree
+
+Tree::
+~Tree() noexcept {
+    LA_ALLOC_TAG(AllocTag::Ui);
+    if (m_slab)
+        ::la::free(m_slab, m_slab_bytes);
+} // ~Tree
+
+bool Tree::
+reserve(uint32_t capacity) noexcept {
+    if (capacity <= m_capacity) return true;
+
+    LA_ALLOC_TAG(AllocTag::Ui);
+    const size_t bytes = static_cast<size_t>(capacity) * detail::NODE_BYTES;
+    unsigned char* slab = static_cast<unsigned char*>(::la::alloc(bytes));
+    if (!slab) {
+        m_failed = true;
+        return false;
+    }
+
+    // Widest types first, the order only has to match `NODE_BYTES`
+    unsigned char* cursor = slab;
+    detail::move_array(m_text,         cursor, capacity, m_count);
+    detail::move_array(m_constraints,  cursor, capacity, m_count);
+    detail::move_array(m_painted,      cursor, capacity, m_count);
+    detail::move_array(m_parent,       cursor, capacity, m_count);
+    detail::move_array(m_first_child,  cursor, capacity, m_count);
+    detail::move_array(m_last_child,   cursor, capacity, m_count);
+    detail::move_array(m_next_sibling, cursor, capacity, m_count);
+    detail::move_array(m_prev_sibling, cursor, capacity, m_count);
+    detail::move_array(m_dirty,        cursor, capacity, m_dirty_count);
+    detail::move_array(m_depth,        cursor, capacity, m_count);
+    detail::move_array(m_color,        cursor, capacity, m_count);
+    detail::move_array(m_param_a,      cursor, capacity, m_count);
+    detail::move_array(m_param_b,      cursor, capacity, m_count);
+    detail::move_array(m_x,            cursor, capacity, m_count);
+    detail::move_array(m_y,            cursor, capacity, m_count);
+    detail::move_array(m_w,            cursor, capacity, m_count);
+    detail::move_array(m_h,            cursor, capacity, m_count);
+    detail::move_array(m_flex,         cursor, capacity, m_count);
+    detail::move_array(m_kind,         cursor, capacity, m_count);
+    detail::move_array(m_flags,        cursor, capacity, m_count);
+
+    if (m_slab)
+        ::la::free(m_slab, m_slab_bytes);
+    m_slab = slab;
+    m_slab_bytes = bytes;
+    m_capacity = capacity;
+    return true;
+} // reserve
+
+bool Tree::
+is_alive(NodeId node) const noexcept {
+    return node < m_count && (m_flags[node] & detail::ALIVE);
+} // is_alive
+
+// ------------------------------ Structure -----------------------------------
+
+NodeId Tree::
+create(Kind kind, NodeId parent) noexcept {
+    if (parent != NONE && !is_alive(parent))
+        return NONE;
+
+    NodeId id;
+    if (m_free != NONE) {
+        id = m_free;
+        m_free = m_next_sibling[id];
+    }
+    else {
+        // From scratch when the constructor's reservation failed
+        if (m_count == m_capacity) {
+            const uint32_t grown = m_capacity * 2 > detail::INITIAL_CAPACITY ? m_capacity * 2
+                                                                            : detail::INITIAL_CAPACITY;
+            if (!reserve(grown)) return NONE;
+        }
+        id = m_count++;
+    }
+
+    m_parent[id] = parent;
+    m_first_child[id] = m_last_child[id] = NONE;
+    m_next_sibling[id] = m_prev_sibling[id] = NONE;
+    m_depth[id] = parent == NONE ? 0 : m_depth[parent] + 1;
+    m_kind[id] = static_cast<uint8_t>(kind);
+    m_flags[id] = detail::ALIVE | detail::NEEDS_LAYOUT;
+    m_flex[id] = 0;
+    m_color[id] = 0;
+    m_param_a[id] = kind == Kind::Box ? -1 : (kind == Kind::Text ? 1 : 0);
+    m_param_b[id] = kind == Kind::Box ? -1 : 0;
+    m_text[id] = nullptr;
+    m_constraints[id] = Constraints{};
+    m_x[id] = m_y[id] = m_w[id] = m_h[id] = 0;
+    m_painted[id] = Rect{};
+    ++m_stats.nodes;
+
+    if (parent != NONE) {
+        m_prev_sibling[id] = m_last_child[parent];
+        if (m_last_child[parent] != NONE) m_next_sibling[m_last_child[parent]] = id;
+        else                              m_first_child[parent] = id;
+        m_last_child[parent] = id;
+        mark_needs_layout(parent);
+    }
+    else {
+        queue(id);
+    }
+    mark_needs_paint(id);
+    return id;
+} // create
+
+void Tree::
+destroy(NodeId node) noexcept {
+    if (!is_alive(node) || node == m_root) return;
+
+    // Whatever the subtree covered now shows its parent
+    m_pending.add(m_painted[node]);
+
+    const NodeId parent = m_parent[node];
+    if (m_prev_sibling[node] != NONE) m_next_sibling[m_prev_sibling[node]] = m_next_sibling[node];
+    else                              m_first_child[parent] = m_next_sibling[node];
+    if (m_next_sibling[node] != NONE) m_prev_sibling[m_next_sibling[node]] = m_prev_sibling[node];
+    else                              m_last_child[parent] = m_prev_sibling[node];
+
+    release(node);
+    mark_needs_layout(parent);
+} // destroy
+
+void Tree::
+release(NodeId node) noexcept {
+    NodeId child = m_first_child[node];
+    while (child != NONE) {
+        const NodeId next = m_next_sibling[child];
+        release(child);
+        child = next;
+    }
+
+    if (m_flags[node] & detail::QUEUED) {
+        for (uint32_t i = 0; i < m_dirty_count; ++i) {
+            if (m_dirty[i] == node) {
+                m_dirty[i] = m_dirty[--m_dirty_count];
+                break;
+            }
+        }
+    }
+
+    m_flags[node] = 0;
+    m_next_sibling[node] = m_free;
+    m_free = node;
+    --m_stats.nodes;
+} // release
+
+// ------------------------------ Properties ----------------------------------
+
+void Tree::
+set_size(NodeId node, int w, int h) noexcept {
+    if (!is_alive(node) || (m_param_a[node] == w && m_param_b[node] == h)) return;
+    m_param_a[node] = w;
+    m_param_b[node] = h;
+    mark_needs_layout(node);
+} // set_size
+
+void Tree::
+set_gap(NodeId node, int gap) noexcept {
+    if (!is_alive(node) || m_param_a[node] == gap) return;
+    m_param_a[node] = gap;
+    mark_needs_layout(node);
+} // set_gap
+
+void Tree::
+set_padding(NodeId node, int padding) noexcept {
+    if (!is_alive(node) || m_param_a[node] == padding) return;
+    m_param_a[node] = padding;
+    mark_needs_layout(node);
+} // set_padding
+
+void Tree::
+set_flex(NodeId node, uint16_t flex) noexcept {
+    if (!is_alive(node) || m_flex[node] == flex) return;
+    m_flex[node] = flex;
+    // Flex is read by the parent, the node itself may be a boundary
+    if (m_parent[node] != NONE)
+        mark_needs_layout(m_parent[node]);
+} // set_flex
+
+void Tree::
+set_text(NodeId node, const char* text, size_t length, int scale) noexcept {
+    if (!is_alive(node)) return;
+    m_text[node] = text;
+    m_param_a[node] = scale;
+    m_param_b[node] = static_cast<int32_t>(length);
+    mark_needs_layout(node);
+    mark_needs_paint(node); // Same size does not mean same glyphs
+} // set_text
+
+void Tree::
+set_color(NodeId node, uint32_t color) noexcept {
+    if (!is_alive(node) || m_color[node] == color) return;
+    m_color[node] = color;
+    mark_needs_paint(node);
+} // set_color
+
+void Tree::
+set_relayout_boundary(NodeId node, bool value) noexcept {
+    if (!is_alive(node)) return;
+    const uint8_t flags = static_cast<uint8_t>(value ? m_flags[node] | detail::BOUNDARY
+                                                     : m_flags[node] & ~detail::BOUNDARY);
+    if (flags == m_flags[node]) return;
+    m_flags[node] = flags;
+    // Relayout now stops at a different node: start over from the new boundary
+    mark_needs_layout(node);
+} // set_relayout_boundary
+
+// ------------------------------ Invalidation --------------------------------
+
+bool Tree::
+is_boundary(NodeId node) const noexcept {
+    // Tight constraints: the size can't change, so the parent never has to know
+    return m_parent[node] == NONE || (m_flags[node] & detail::BOUNDARY) ||
+           m_constraints[node].is_tight();
+} // is_boundary
+
+NodeId Tree::
+mark_up(NodeId node) noexcept {
+    for (;;) {
+        m_flags[node] |= detail::NEEDS_LAYOUT;
+        if (is_boundary(node)) return node;
+        node = m_parent[node];
+    }
+} // mark_up
+
+void Tree::
+queue(NodeId boundary) noexcept {
+    if (m_flags[boundary] & detail::QUEUED) return;
+    m_flags[boundary] |= detail::QUEUED;
+    m_dirty[m_dirty_count++] = boundary; // Each live node at most once, fits
+} // queue
+
+void Tree::
+mark_needs_layout(NodeId node) noexcept {
+    if (!is_alive(node)) return;
+    queue(mark_up(node));
+} // mark_needs_layout
+
+void Tree::
+mark_needs_paint(NodeId node) noexcept {
+    if (!is_alive(node)) return;
+    m_flags[node] |= detail::NEEDS_PAINT;
+    for (NodeId p = m_parent[node]; p != NONE && !(m_flags[p] & detail::SUBTREE_PAINT); p = m_parent[p])
+        m_flags[p] |= detail::SUBTREE_PAINT;
+} // mark_needs_paint
+
+// ------------------------------ Layout --------------------------------------
+
+void Tree::
+set_viewport(int width, int height) noexcept {
+    if (m_root == NONE || (width == m_viewport_w && height == m_viewport_h)) return;
+    m_viewport_w = width;
+    m_viewport_h = height;
+    m_constraints[m_root] = Constraints::tight(width, height);
+    mark_needs_layout(m_root);
+} // set_viewport
+
+void Tree::
+layout() noexcept {
+    LA_PROFILE_ZONE("ui::Tree::layout");
+    m_stats.laid_out = 0;
+    detail::sort_by_depth(m_dirty, m_dirty_count, m_depth);
+
+    for (uint32_t i = 0; i < m_dirty_count; ++i) {
+        NodeId boundary = m_dirty[i];
+        m_flags[boundary] &= ~detail::QUEUED;
+
+        // Relayout with the constraints the parent gave last time
+        while (m_flags[boundary] & detail::NEEDS_LAYOUT) {
+            const int w = m_w[boundary];
+            const int h = m_h[boundary];
+            layout_node(boundary, m_constraints[boundary]);
+            if (m_parent[boundary] == NONE || (m_w[boundary] == w && m_h[boundary] == h))
+                break;
+            // An explicit boundary changed size, its parent reads it
+            boundary = mark_up(m_parent[boundary]);
+        }
+    }
+    m_dirty_count = 0;
+} // layout
+
+Tree::Size Tree::
+layout_node(NodeId node, const Constraints& c) noexcept {
+    // Clean and asked the same question: the whole subtree is skipped
+    if (!(m_flags[node] & detail::NEEDS_LAYOUT) && m_constraints[node] == c)
+        return Size{ m_w[node], m_h[node] };
+
+    m_constraints[node] = c;
+    ++m_stats.laid_out;
+
+    Size size{ 0, 0 };
+    switch (static_cast<Kind>(m_kind[node])) {
+    case Kind::Box: {
+        const int w = m_param_a[node];
+        const int h = m_param_b[node];
+        size.w = c.clamp_w(w >= 0 ? w : (c.max_w < UNBOUNDED ? c.max_w : 0));
+        size.h = c.clamp_h(h >= 0 ? h : (c.max_h < UNBOUNDED ? c.max_h : 0));
+
+        const Constraints inner = Constraints::tight(size.w, size.h);
+        for (NodeId child = m_first_child[node]; child != NONE; child = m_next_sibling[child]) {
+            (void)layout_node(child, inner);
+            place(child, 0, 0);
+        }
+        break;
+    }
+    case Kind::Padding: {
+        const int pad = detail::max_int(m_param_a[node], 0);
+        Constraints inner{};
+        inner.min_w = detail::max_int(c.min_w - 2 * pad, 0);
+        inner.min_h = detail::max_int(c.min_h - 2 * pad, 0);
+        inner.max_w = c.max_w >= UNBOUNDED ? UNBOUNDED : detail::max_int(c.max_w - 2 * pad, inner.min_w);
+        inner.max_h = c.max_h >= UNBOUNDED ? UNBOUNDED : detail::max_int(c.max_h - 2 * pad, inner.min_h);
+
+        int content_w = 0, content_h = 0;
+        for (NodeId child = m_first_child[node]; child != NONE; child = m_next_sibling[child]) {
+            const Size s = layout_node(child, inner);
+            content_w = detail::max_int(content_w, s.w);
+            content_h = detail::max_int(content_h, s.h);
+            place(child, pad, pad);
+        }
+        size.w = c.clamp_w(content_w + 2 * pad);
+        size.h = c.clamp_h(content_h + 2 * pad);
+        break;
+    }
+    case Kind::Row:    size = layout_linear(node, c, true);  break;
+    case Kind::Column: size = layout_linear(node, c, false); break;
+    case Kind::Text: {
+        const Rect r = Canvas::text_bounds(0, 0, m_text[node],
+                                           static_cast<size_t>(m_param_b[node]), m_param_a[node]);
+        size.w = c.clamp_w(r.is_empty() ? 0 : r.width());
+        size.h = c.clamp_h(r.is_empty() ? 0 : r.height());
+        break;
+    }
+    } // switch
+
+    if (size.w != m_w[node] || size.h != m_h[node]) {
+        m_w[node] = size.w;
+        m_h[node] = size.h;
+        mark_needs_paint(node);
+    }
+    m_flags[node] &= ~detail::NEEDS_LAYOUT;
+    return size;
+} // layout_node
+
+Tree::Size Tree::
+layout_linear(NodeId node, const Constraints& c, bool horizontal) noexcept {
+    const int gap = detail::max_int(m_param_a[node], 0);
+    const int main_max = horizontal ? c.max_w : c.max_h;
+    const int cross_max = horizontal ? c.max_h : c.max_w;
+
+    // Inflexible children first, unbounded along the main axis
+    int used = 0;
+    int count = 0;
+    uint32_t total_flex = 0;
+    for (NodeId child = m_first_child[node]; child != NONE; child = m_next_sibling[child]) {
+        ++count;
+        if (m_flex[child]) {
+            total_flex += m_flex[child];
+            continue;
+        }
+        const Constraints cc = horizontal ? Constraints{ 0, UNBOUNDED, 0, cross_max }
+                                          : Constraints{ 0, cross_max, 0, UNBOUNDED };
+        const Size s = layout_node(child, cc);
+        used += horizontal ? s.w : s.h;
+    }
+    if (count > 1)
+        used += gap * (count - 1);
+
+    // Flexible children split what is left, nothing when unbounded
+    if (total_flex) {
+        int left = main_max >= UNBOUNDED ? 0 : detail::max_int(main_max - used, 0);
+        uint32_t flex_left = total_flex;
+        for (NodeId child = m_first_child[node]; child != NONE; child = m_next_sibling[child]) {
+            if (!m_flex[child]) continue;
+            const int share = static_cast<int>(static_cast<int64_t>(left) * m_flex[child] / flex_left);
+            left -= share;
+            flex_left -= m_flex[child];
+
+            const Constraints cc = horizontal ? Constraints{ share, share, 0, cross_max }
+                                              : Constraints{ 0, cross_max, share, share };
+            const Size s = layout_node(child, cc);
+            used += horizontal ? s.w : s.h;
+        }
+    }
+
+    int cursor = 0;
+    int cross = 0;
+    for (NodeId child = m_first_child[node]; child != NONE; child = m_next_sibling[child]) {
+        if (horizontal) place(child, cursor, 0);
+        else            place(child, 0, cursor);
+        cursor += (horizontal ? m_w[child] : m_h[child]) + gap;
+        cross = detail::max_int(cross, horizontal ? m_h[child] : m_w[child]);
+    }
+
+    return horizontal ? Size{ c.clamp_w(used), c.clamp_h(cross) }
+                      : Size{ c.clamp_w(cross), c.clamp_h(used) };
+} // layout_linear
+
+void Tree::
+place(NodeId child, int x, int y) noexcept {
+    if (m_x[child] == x && m_y[child] == y) return;
+    m_x[child] = x;
+    m_y[child] = y;
+    mark_needs_paint(child);
+} // place
+
+// ------------------------------ Paint ---------------------------------------
+
+void Tree::
+collect_damage(NodeId node, int ax, int ay, const Rect& bounds) noexcept {
+    const uint8_t flags = m_flags[node];
+    if (flags & detail::NEEDS_PAINT) {
+        // Old and new position, children are clipped to it
+        m_damage.add(m_painted[node].intersect(bounds));
+        refresh(node, ax, ay);
+        m_damage.add(m_painted[node].intersect(bounds));
+        return;
+    }
+    if (flags & detail::SUBTREE_PAINT) {
+        m_flags[node] &= ~detail::SUBTREE_PAINT;
+        for (NodeId child = m_first_child[node]; child != NONE; child = m_next_sibling[child])
+            collect_damage(child, ax + m_x[node], ay + m_y[node], bounds);
+    }
+} // collect_damage
+
+void Tree::
+refresh(NodeId node, int ax, int ay) noexcept {
+    const int x = ax + m_x[node];
+    const int y = ay + m_y[node];
+    m_painted[node] = Rect::from_size(x, y, m_w[node], m_h[node]);
+    m_flags[node] &= ~(detail::NEEDS_PAINT | detail::SUBTREE_PAINT);
+    for (NodeId child = m_first_child[node]; child != NONE; child = m_next_sibling[child])
+        refresh(child, x, y);
+} // refresh
+
+void Tree::
+draw(NodeId node, Canvas& canvas) noexcept {
+    const Rect& r = m_painted[node];
+    if (!r.intersects(canvas.clip)) return;
+    ++m_stats.painted;
+
+    const uint32_t color = m_color[node];
+    const Kind kind = static_cast<Kind>(m_kind[node]);
+    if (color >> 24) {
+        if (kind == Kind::Text)
+            canvas.draw_text(r.left, r.top, m_text[node],
+                             static_cast<size_t>(m_param_b[node]), color, m_param_a[node]);
+        else
+            canvas.fill_rect(r, color);
+    }
+
+    const Rect saved = canvas.clip;
+    canvas.clip = saved.intersect(r);
+    for (NodeId child = m_first_child[node]; child != NONE; child = m_next_sibling[child]) {
+        // Children are ordered along the main axis: stop past the clip
+        const Rect& cr = m_painted[child];
+        if (kind == Kind::Column && cr.top >= canvas.clip.bottom) break;
+        if (kind == Kind::Row && cr.left >= canvas.clip.right) break;
+        draw(child, canvas);
+    }
+    canvas.clip = saved;
+} // draw
+
+const Damage& Tree::
+paint(Canvas& canvas) noexcept {
+    LA_PROFILE_ZONE("ui::Tree::paint");
+    m_stats.painted = 0;
+    m_damage.reset();
+    if (m_root == NONE) return m_damage;
+
+    // Off-canvas damage would only waste the rect budget
+    const Rect bounds = canvas.bounds();
+    for (int i = 0; i < m_pending.count; ++i)
+        m_damage.add(m_pending.rects[i].intersect(bounds));
+    m_pending.reset();
+    collect_damage(m_root, 0, 0, bounds);
+
+    const Rect saved = canvas.clip;
+    for (int i = 0; i < m_damage.count; ++i) {
+        canvas.set_clip(m_damage.rects[i].intersect(saved));
+        if (!canvas.clip.is_empty())
+            draw(m_root, canvas);
+    }
+    canvas.clip = saved;
+    return m_damage;
+} // paint
+
+void Tree::
+frame(::la::Window& win) noexcept {
+    Canvas canvas{ win.fb() };
+    set_viewport(canvas.width, canvas.height);
+    layout();
+    (void)paint(canvas);
+} // frame
+
+} // namespace ui
+} // namespace la
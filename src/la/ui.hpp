@@ -0,0 +1,172 @@
+#ifndef __LA_UI_HEADER_GUARD
+#define __LA_UI_HEADER_GUARD
+
+#include "display_list.hpp"
+
+/*
+    Retained element tree with constraint-based layout (constraints go down,
+    sizes go up, parents place children). Nodes live in structure-of-arrays
+    storage carved from one `la::alloc` slab and are addressed by `NodeId`.
+
+    Only invalidated subtrees re-layout: dirtiness propagates up to the
+    nearest relayout boundary (root, tight constraints or explicit flag).
+    Painting is incremental as well: changed nodes produce damage, and only
+    nodes intersecting the damage are redrawn. Children are clipped to their
+    parent, which keeps damage and culling conservative.
+*/
+
+namespace la {
+namespace ui {
+
+using NodeId = uint32_t;
+LA_CONSTEXPR_VAR NodeId NONE = 0xFFFFFFFFu;
+LA_CONSTEXPR_VAR int UNBOUNDED = 1 << 30;
+
+enum class Kind : uint8_t {
+    Box,     // Preferred size (-1 expands), children fill it (tight constraints)
+    Row,     // Children left to right, `gap` between them, `flex` shares the rest
+    Column,  // Children top to bottom
+    Padding, // Insets children by `padding` on every side
+    Text,    // Built-in font, `color` is the text color
+}; // enum class Kind
+
+// --------------------------- Constraints ------------------------------------
+
+struct Constraints {
+    int min_w{ 0 };
+    int max_w{ UNBOUNDED };
+    int min_h{ 0 };
+    int max_h{ UNBOUNDED };
+
+    LA_NO_DISCARD static LA_CONSTEXPR Constraints
+tight(int w, int h) noexcept { return Constraints{ w, w, h, h }; }
+    LA_NO_DISCARD static LA_CONSTEXPR Constraints
+loose(int w, int h) noexcept { return Constraints{ 0, w, 0, h }; }
+
+    LA_NO_DISCARD bool is_tight() const noexcept { return min_w == max_w && min_h == max_h; }
+    LA_NO_DISCARD int clamp_w(int w) const noexcept { return w < min_w ? min_w : (w > max_w ? max_w : w); }
+    LA_NO_DISCARD int clamp_h(int h) const noexcept { return h < min_h ? min_h : (h > max_h ? max_h : h); }
+
+    LA_NO_DISCARD bool operator==(const Constraints& c) const noexcept {
+        return min_w == c.min_w && max_w == c.max_w && min_h == c.min_h && max_h == c.max_h;
+    }
+    LA_NO_DISCARD bool operator!=(const Constraints& c) const noexcept { return !(*this == c); }
+}; // struct Constraints
+
+// --------------------------- Tree -------------------------------------------
+
+struct Tree {
+    struct Stats {
+        uint32_t laid_out{ 0 }; // Nodes whose layout ran this frame
+        uint32_t painted{ 0 };  // Nodes drawn this frame
+        uint32_t nodes{ 0 };    // Live nodes
+    }; // struct Stats
+
+    explicit Tree() noexcept;
+    ~Tree() noexcept;
+
+    Tree(const Tree&) = delete;
+    Tree& operator=(const Tree&) = delete;
+    Tree(Tree&&) = delete;
+    Tree& operator=(Tree&&) = delete;
+
+    // ---------------------------- Structure ---------------------------------
+
+    LA_NO_DISCARD NodeId root() const noexcept { return m_root; }
+    // Appended as the last child of `parent`, NONE when out of memory
+    LA_NO_DISCARD NodeId create(Kind kind, NodeId parent) noexcept;
+    // Destroys the whole subtree
+    void destroy(NodeId node) noexcept;
+
+    // ---------------------------- Properties --------------------------------
+
+    void set_size(NodeId node, int w, int h) noexcept;      // Box
+    void set_gap(NodeId node, int gap) noexcept;            // Row/Column
+    void set_padding(NodeId node, int padding) noexcept;    // Padding
+    void set_flex(NodeId node, uint16_t flex) noexcept;     // Child of Row/Column
+    // Text is referenced, it must outlive the node or be set again
+    void set_text(NodeId node, const char* text, size_t length, int scale = 1) noexcept;
+    void set_color(NodeId node, uint32_t color) noexcept;   // Paint only, alpha 0 draws nothing
+    void set_relayout_boundary(NodeId node, bool value) noexcept;
+
+    void mark_needs_layout(NodeId node) noexcept;
+    void mark_needs_paint(NodeId node) noexcept;
+
+    // ---------------------------- Frame -------------------------------------
+
+    void set_viewport(int width, int height) noexcept;
+    void layout() noexcept;
+    // Redraw the damage into `canvas`, which must keep its pixels between frames
+    const Damage& paint(Canvas& canvas) noexcept;
+    // Software renderer helper: viewport, layout and paint into `win.fb()`
+    void frame(::la::Window& win) noexcept;
+
+    // ---------------------------- Queries -----------------------------------
+
+    LA_NO_DISCARD Rect rect(NodeId node) const noexcept { return m_painted[node]; }
+    LA_NO_DISCARD NodeId parent(NodeId node) const noexcept { return m_parent[node]; }
+    LA_NO_DISCARD NodeId first_child(NodeId node) const noexcept { return m_first_child[node]; }
+    LA_NO_DISCARD NodeId next_sibling(NodeId node) const noexcept { return m_next_sibling[node]; }
+    LA_NO_DISCARD const Stats& stats() const noexcept { return m_stats; }
+    LA_NO_DISCARD bool has_failed() const noexcept { return m_failed; }
+
+private:
+    struct Size { int w, h; };
+
+    bool reserve(uint32_t capacity) noexcept;
+    LA_NO_DISCARD bool is_alive(NodeId node) const noexcept;
+    LA_NO_DISCARD bool is_boundary(NodeId node) const noexcept;
+    NodeId mark_up(NodeId node) noexcept;
+    void queue(NodeId boundary) noexcept;
+    Size layout_node(NodeId node, const Constraints& c) noexcept;
+    Size layout_linear(NodeId node, const Constraints& c, bool horizontal) noexcept;
+    void place(NodeId child, int x, int y) noexcept;
+    void collect_damage(NodeId node, int ax, int ay, const Rect& bounds) noexcept;
+    void refresh(NodeId node, int ax, int ay) noexcept;
+    void draw(NodeId node, Canvas& canvas) noexcept;
+    void release(NodeId node) noexcept;
+
+    // Structure-of-arrays node storage, all arrays share one slab
+    void*        m_slab{ nullptr };
+    size_t       m_slab_bytes{ 0 };
+    uint32_t     m_capacity{ 0 };
+    uint32_t     m_count{ 0 };     // High-water mark of used ids
+    NodeId       m_free{ NONE };   // Free list threaded through `m_next_sibling`
+
+    NodeId*      m_parent{ nullptr };
+    NodeId*      m_first_child{ nullptr };
+    NodeId*      m_last_child{ nullptr };
+    NodeId*      m_next_sibling{ nullptr };
+    NodeId*      m_prev_sibling{ nullptr };
+    uint32_t*    m_depth{ nullptr };
+    uint8_t*     m_kind{ nullptr };
+    uint8_t*     m_flags{ nullptr };
+    uint16_t*    m_flex{ nullptr };
+    uint32_t*    m_color{ nullptr };
+    int32_t*     m_param_a{ nullptr }; // Box width, gap, padding, text scale
+    int32_t*     m_param_b{ nullptr }; // Box height, text length
+    const char** m_text{ nullptr };
+    Constraints* m_constraints{ nullptr };
+    int32_t*     m_x{ nullptr };       // Offset in the parent
+    int32_t*     m_y{ nullptr };
+    int32_t*     m_w{ nullptr };
+    int32_t*     m_h{ nullptr };
+    Rect*        m_painted{ nullptr }; // Absolute rect at the last paint, unclipped
+
+    // Relayout boundaries waiting for layout
+    NodeId*      m_dirty{ nullptr };
+    uint32_t     m_dirty_count{ 0 };
+
+    NodeId m_root{ NONE };
+    int m_viewport_w{ 0 };
+    int m_viewport_h{ 0 };
+    Damage m_damage;
+    Damage m_pending; // Rects of destroyed nodes
+    Stats m_stats{};
+    bool m_failed{ false };
+}; // struct Tree
+
+} // namespace ui
+} // namespace la
+
+#endif // __LA_UI_HEADER_GUARD
@@ -0,0 +1,203 @@
+#include "test.hpp"
+#include "la/containers.hpp"
+
+// `String`, `SmallVector` and `HashMap`
+//
+//     g++ -std=c++14 -O2 -Isrc tests/containers.cpp src/la/*.cpp -o test_containers -lpthread
+
+namespace {
+
+void
+string_self_append() noexcept {
+    // On the heap, appending itself moves to a bigger buffer
+    la::String s{ "abcdefghijklmnopqrstuvwxyz0123" };
+    CHECK(s.size() == 30 && s.capacity() >= 30);
+    CHECK(s.append(s));
+    CHECK(s == "abcdefghijklmnopqrstuvwxyz0123abcdefghijklmnopqrstuvwxyz0123");
+
+    // A view into the middle of the string
+    la::String t{ "0123456789abcdefghijklmnopqrstuvwxyz" };
+    CHECK(t.append(t.view().substr(10, 6)));
+    CHECK(t == "0123456789abcdefghijklmnopqrstuvwxyzabcdef");
+
+    // Inline to heap
+    la::String u{ "0123456789" };
+    CHECK(u.append(u) && u.append(u));
+    CHECK(u == "0123456789012345678901234567890123456789");
+
+    // Enough room already: in place
+    la::String v{ "abc" };
+    CHECK(v.reserve(64));
+    const char* data = v.c_str();
+    CHECK(v.append(v) && v.c_str() == data);
+    CHECK(v == "abcabc");
+} // string_self_append
+
+// Sizes whose bytes wrap `size_t` fail instead of allocating a wrapped size
+void
+capacity_overflow() noexcept {
+    const size_t huge = ~static_cast<size_t>(0);
+
+    la::Vector<uint64_t> v;
+    (void)v.push_back(1);
+    CHECK(!v.reserve(huge / 4));
+    CHECK(!v.resize(huge / 8 + 1));
+    CHECK(v.size() == 1 && v[0] == 1);
+
+    la::HashMap<uint64_t, uint64_t> map;
+    const uint64_t key = 7;
+    (void)map.insert(key, 7);
+    CHECK(!map.reserve(huge));
+    CHECK(!map.reserve(huge / 2));
+    CHECK(map.size() == 1 && map.find(key) && *map.find(key) == 7);
+    CHECK(map.reserve(1000) && map.capacity() >= 1024);
+
+    la::String s{ "abc" };
+    CHECK(!s.reserve(huge));
+    CHECK(!s.append(la::StringView{ "x", huge }));
+    CHECK(s == "abc");
+} // capacity_overflow
+
+// ------------------------------ Hash Map ------------------------------------
+
+// Every key starts probing at group 0: full groups, long probes, tombstones
+struct Crowded {
+    LA_NO_DISCARD uint64_t operator()(uint32_t key) const noexcept { return key & 0x7F; }
+}; // struct Crowded
+
+void
+hash_map_tombstones() noexcept {
+    la::HashMap<uint32_t, uint32_t, Crowded> map;
+    for (uint32_t k = 0; k < 40; ++k) (void)map.insert(k, k * 10);
+    const size_t capacity = map.capacity();
+    CHECK(map.size() == 40 && capacity == 64);
+
+    // The first group is full, its slots turn into tombstones and probes for
+    // the keys further along still get there
+    for (uint32_t k = 0; k < 16; ++k) CHECK(map.erase(k));
+    CHECK(map.size() == 24 && !map.erase(3u));
+    bool found = true;
+    for (uint32_t k = 0; k < 40; ++k) found = found && (map.find(k) != nullptr) == (k >= 16);
+    CHECK(found);
+    for (uint32_t k = 16; k < 40; ++k) found = found && *map.find(k) == k * 10;
+    CHECK(found);
+
+    // Churn through the tombstones: the table neither grows nor loses keys
+    for (uint32_t k = 1000; k < 21000; ++k) {
+        CHECK(map.insert(k, k) != nullptr);
+        CHECK(map.erase(k));
+    }
+    CHECK(map.size() == 24 && map.capacity() == capacity);
+    for (uint32_t k = 16; k < 40; ++k) found = found && map.find(k) && *map.find(k) == k * 10;
+    CHECK(found);
+
+    // Refill the erased keys
+    for (uint32_t k = 0; k < 16; ++k) (void)map.insert(k, k);
+    CHECK(map.size() == 40 && map.capacity() == capacity);
+
+    // A sliding window of 100 keys: tombstones pile up in full groups until a
+    // rehash at the same size clears them
+    la::HashMap<uint64_t, uint64_t> window;
+    size_t max_capacity = 0;
+    for (uint64_t k = 0; k < 100000; ++k) {
+        (void)window.insert(k, k);
+        if (k >= 100) CHECK(window.erase(k - 100));
+        if (window.capacity() > max_capacity) max_capacity = window.capacity();
+    }
+    CHECK(window.size() == 100 && max_capacity <= 256);
+    for (uint64_t k = 99900; k < 100000; ++k) found = found && window.find(k) && *window.find(k) == k;
+    CHECK(found);
+} // hash_map_tombstones
+
+// Random inserts and erases against a plain array of what should be there
+void
+hash_map_churn() noexcept {
+    LA_CONSTEXPR_VAR uint32_t KEYS = 512;
+    static bool present[KEYS];
+    la::HashMap<uint64_t, uint32_t> map;
+    size_t expected = 0, max_capacity = 0;
+    uint32_t rng = 12345;
+    for (int i = 0; i < 200000; ++i) {
+        rng = rng * 1664525u + 1013904223u;
+        const uint64_t key = (rng >> 8) % KEYS;
+        if (rng & 0x80) {
+            bool inserted = false;
+            uint32_t* value = map.find_or_insert(key, &inserted);
+            CHECK(value && inserted != present[key]);
+            if (value) *value = static_cast<uint32_t>(key * 3);
+            expected += !present[key];
+            present[key] = true;
+        }
+        else {
+            CHECK(map.erase(key) == present[key]);
+            expected -= present[key];
+            present[key] = false;
+        }
+        if (map.capacity() > max_capacity) max_capacity = map.capacity();
+    }
+    CHECK(map.size() == expected && max_capacity <= 1024);
+
+    bool consistent = true;
+    for (uint64_t key = 0; key < KEYS; ++key) {
+        const uint32_t* value = map.find(key);
+        consistent = consistent && (value != nullptr) == present[key] && (!value || *value == key * 3);
+    }
+    CHECK(consistent);
+
+    // Erasing during the walk visits every entry once
+    size_t visited = 0;
+    for (auto& entry : map) {
+        ++visited;
+        if (entry.key % 2) (void)map.erase(entry.key);
+    }
+    CHECK(visited == expected);
+    for (uint64_t key = 0; key < KEYS; ++key) consistent = consistent && map.contains(key) == (present[key] && key % 2 == 0);
+    CHECK(consistent);
+} // hash_map_churn
+
+// Hands out `budget` allocations, then fails
+struct Budget {
+    int left;
+};
+
+void*
+budget_alloc(void* context, size_t size) noexcept {
+    Budget& budget = *static_cast<Budget*>(context);
+    if (budget.left <= 0) return nullptr;
+    --budget.left;
+    return la::pool_alloc(size);
+} // budget_alloc
+
+void
+budget_free(void*, void* ptr, size_t size) noexcept { la::pool_free(ptr, size); }
+
+// A key whose copy runs out of memory leaves the map as it was
+void
+hash_map_key_out_of_memory() noexcept {
+    static const la::Allocator::Ops OPS{ &budget_alloc, &budget_free };
+    Budget budget{ 1 };
+    la::HashMap<la::String, int> map{ la::Allocator{ &OPS, &budget } };
+    CHECK(map.reserve(4)); // The table takes the one allocation
+
+    const la::StringView key{ "a key well past the inline capacity of String" };
+    bool inserted = true;
+    CHECK(map.find_or_insert(key, &inserted) == nullptr && !inserted);
+    CHECK(map.size() == 0 && !map.contains(key));
+
+    budget.left = 1;
+    CHECK(map.insert(key, 5) && map.size() == 1);
+    const int* value = map.find(key);
+    CHECK(value && *value == 5);
+    for (const auto& entry : map) CHECK(entry.key == key);
+} // hash_map_key_out_of_memory
+
+} // namespace
+
+int main() {
+    string_self_append();
+    capacity_overflow();
+    hash_map_tombstones();
+    hash_map_churn();
+    hash_map_key_out_of_memory();
+    return test::report("containers");
+}
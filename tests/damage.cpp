@@ -0,0 +1,126 @@
+#include "test.hpp"
+#include "la/display_list.hpp"
+
+#include <string.h> // memcmp
+
+// `Damage` merging and `RetainedRenderer` repainting only what changed
+//
+//     g++ -std=c++14 -O2 -Isrc tests/damage.cpp src/la/*.cpp -o test_damage -lpthread
+
+namespace {
+
+LA_CONSTEXPR_VAR int SIZE = 64;
+
+// Every pixel of `r` is in some damage rect
+bool
+covers(const la::Damage& damage, const la::Rect& r) noexcept {
+    for (int y = r.top; y < r.bottom; ++y)
+        for (int x = r.left; x < r.right; ++x) {
+            bool hit = false;
+            for (int i = 0; i < damage.count && !hit; ++i) hit = damage.rects[i].contains(la::Rect{ x, y, x + 1, y + 1 });
+            if (!hit) return false;
+        }
+    return true;
+} // covers
+
+bool
+disjoint(const la::Damage& damage) noexcept {
+    for (int i = 0; i < damage.count; ++i)
+        for (int j = i + 1; j < damage.count; ++j)
+            if (damage.rects[i].intersects(damage.rects[j])) return false;
+    return true;
+} // disjoint
+
+void
+merging() noexcept {
+    la::Damage damage;
+    damage.add(la::Rect{ 5, 5, 5, 20 }); // Empty
+    CHECK(damage.is_empty());
+
+    damage.add(la::Rect::from_size(0, 0, 10, 10));
+    damage.add(la::Rect::from_size(2, 2, 4, 4)); // Inside
+    damage.add(la::Rect::from_size(10, 0, 10, 10)); // Touching only: kept apart
+    CHECK(damage.count == 2);
+    damage.add(la::Rect::from_size(8, 8, 4, 4)); // Overlaps both
+    CHECK(damage.count == 1 && damage.rects[0] == (la::Rect{ 0, 0, 20, 12 }));
+
+    // Growing one rect into others folds them in
+    damage.reset();
+    damage.add(la::Rect::from_size(0, 0, 10, 10));
+    damage.add(la::Rect::from_size(20, 0, 10, 10));
+    damage.add(la::Rect::from_size(40, 0, 10, 10));
+    damage.add(la::Rect::from_size(5, 2, 40, 2));
+    CHECK(damage.count == 1 && damage.rects[0] == (la::Rect{ 0, 0, 50, 10 }));
+
+    // Out of slots: the new rect joins the one that grows the least
+    damage.reset();
+    for (int i = 0; i < la::Damage::MAX_RECTS; ++i) damage.add(la::Rect::from_size(i * 8, i * 8, 2, 2));
+    CHECK(damage.count == la::Damage::MAX_RECTS);
+    const la::Rect extra = la::Rect::from_size(59, 59, 2, 2);
+    damage.add(extra);
+    CHECK(damage.count == la::Damage::MAX_RECTS && covers(damage, extra));
+    CHECK(damage.bounds() == (la::Rect{ 0, 0, 61, 61 }));
+
+    // A pseudo-random storm: everything added stays covered, nothing overlaps
+    damage.reset();
+    uint32_t rng = 7;
+    la::Rect added[64];
+    for (la::Rect& r : added) {
+        rng = rng * 1664525u + 1013904223u;
+        r = la::Rect::from_size(static_cast<int>(rng % 56), static_cast<int>((rng >> 8) % 56),
+                                1 + static_cast<int>((rng >> 16) % 8), 1 + static_cast<int>((rng >> 24) % 8));
+        damage.add(r);
+        CHECK(damage.count <= la::Damage::MAX_RECTS && disjoint(damage));
+    }
+    for (const la::Rect& r : added) CHECK(covers(damage, r));
+} // merging
+
+void
+record(la::DisplayList& list, int box_x) noexcept {
+    list.clear(0xff000000u);
+    list.fill_rect(la::Rect::from_size(4, 4, 20, 20), 0xff00ff00u);
+    list.fill_rect(la::Rect::from_size(box_x, 30, 10, 10), 0xffff0000u);
+    list.text(2, 50, "hi", 2, 0xffffffffu, 2);
+} // record
+
+// Damage-only repaints end with the same pixels as a full replay
+void
+retained() noexcept {
+    static uint32_t pixels[SIZE * SIZE], expected[SIZE * SIZE];
+    la::Canvas target{ pixels, SIZE, SIZE, SIZE };
+    la::Canvas full{ expected, SIZE, SIZE, SIZE };
+    la::RetainedRenderer renderer;
+
+    record(renderer.begin_frame(), 10);
+    const la::Damage& first = renderer.end_frame(target);
+    CHECK(first.count == 1 && first.rects[0] == target.bounds());
+
+    record(renderer.begin_frame(), 10);
+    CHECK(renderer.end_frame(target).is_empty());
+
+    // Only the box moved: its old and new place, nothing else
+    record(renderer.begin_frame(), 40);
+    const la::Damage& moved = renderer.end_frame(target);
+    CHECK(moved.count == 2 && disjoint(moved));
+    CHECK(covers(moved, la::Rect::from_size(10, 30, 10, 10)) && covers(moved, la::Rect::from_size(40, 30, 10, 10)));
+    CHECK(moved.bounds().area() < static_cast<int64_t>(SIZE) * SIZE / 4);
+
+    la::DisplayList reference;
+    record(reference, 40);
+    reference.replay(full);
+    CHECK(memcmp(pixels, expected, sizeof(pixels)) == 0);
+
+    // Pixels the lists can't see
+    record(renderer.begin_frame(), 40);
+    renderer.invalidate(la::Rect::from_size(0, 0, 3, 3));
+    const la::Damage& extra = renderer.end_frame(target);
+    CHECK(extra.count == 1 && extra.rects[0] == (la::Rect{ 0, 0, 3, 3 }));
+} // retained
+
+} // namespace
+
+int main() {
+    merging();
+    retained();
+    return test::report("damage");
+}
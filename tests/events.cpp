@@ -0,0 +1,90 @@
+#include "test.hpp"
+
+// `EventQueue` coalescing and overflow
+//
+//     g++ -std=c++14 -O2 -Isrc tests/events.cpp src/la/*.cpp -o test_events -lpthread
+
+namespace {
+
+la::Event
+make_event(la::EventType type, la::Key key = la::Key::__NONE__, int x = 0, int y = 0) noexcept {
+    la::Event e;
+    e.type = type;
+    e.key = key;
+    e.x = x;
+    e.y = y;
+    return e;
+} // make_event
+
+void
+coalescing() noexcept {
+    la::EventQueue queue;
+    for (int i = 0; i < 10; ++i) queue.push(make_event(la::EventType::MouseMove, la::Key::__NONE__, i, 2 * i));
+    queue.push(make_event(la::EventType::KeyDown, la::Key::A));
+    for (int i = 0; i < 3; ++i) {
+        la::Event e = make_event(la::EventType::Scroll);
+        e.scroll = 1.f;
+        queue.push(e);
+    }
+    queue.flush();
+
+    la::Event e;
+    CHECK(queue.pop(e) && e.type == la::EventType::MouseMove && e.x == 9 && e.y == 18 && e.merged == 10);
+    CHECK(queue.pop(e) && e.type == la::EventType::KeyDown && e.key == la::Key::A);
+    CHECK(queue.pop(e) && e.type == la::EventType::Scroll && e.scroll == 3.f && e.merged == 3);
+    CHECK(!queue.pop(e));
+} // coalescing
+
+// A consumer that fell behind still gets the final size and every key-up it needs
+void
+overflow() noexcept {
+    static la::EventQueue queue; // 16 KB of events
+    queue.push(make_event(la::EventType::KeyDown, la::Key::A));
+    queue.push(make_event(la::EventType::KeyDown, la::Key::B));
+    for (uint32_t i = 0; i < la::EventQueue::CAPACITY; ++i) {
+        queue.push(make_event(la::EventType::Resize, la::Key::__NONE__, 100 + static_cast<int>(i), 50));
+        queue.push(make_event(la::EventType::KeyDown, la::Key::Space)); // Fills the ring
+    }
+    CHECK(queue.dropped() > 0);
+
+    queue.push(make_event(la::EventType::KeyUp, la::Key::A));
+    queue.push(make_event(la::EventType::KeyUp, la::Key::C)); // Never went down here: droppable
+    queue.push(make_event(la::EventType::Focus, la::Key::__NONE__, 0));
+    queue.push(make_event(la::EventType::KeyUp, la::Key::B));
+    queue.push(make_event(la::EventType::Resize, la::Key::__NONE__, 640, 480));
+
+    la::Event e;
+    uint32_t count = 0, resizes = 0;
+    bool up_a = false, up_b = false, up_c = false, lost_focus = false;
+    int width = 0, height = 0;
+    while (queue.pop(e)) {
+        ++count;
+        if (e.type == la::EventType::KeyUp) {
+            up_a |= e.key == la::Key::A;
+            up_b |= e.key == la::Key::B;
+            up_c |= e.key == la::Key::C;
+        }
+        if (e.type == la::EventType::Focus && !e.x) lost_focus = true;
+        if (e.type == la::EventType::Resize) {
+            ++resizes;
+            width = e.x;
+            height = e.y;
+        }
+    }
+    CHECK(count <= la::EventQueue::CAPACITY + 1);
+    CHECK(up_a && up_b && !up_c && lost_focus);
+    CHECK(resizes == 1 && width == 640 && height == 480);
+
+    // Drained, the ring takes everything again
+    queue.push(make_event(la::EventType::KeyUp, la::Key::C));
+    CHECK(queue.pop(e) && e.type == la::EventType::KeyUp && e.key == la::Key::C);
+    CHECK(!queue.pop(e));
+} // overflow
+
+} // namespace
+
+int main() {
+    coalescing();
+    overflow();
+    return test::report("events");
+}
@@ -0,0 +1,62 @@
+#include "test.hpp"
+
+// `native::Framebuffer` resizing without a window
+//
+//     g++ -std=c++14 -O2 -Isrc tests/framebuffer.cpp src/la/*.cpp -o test_framebuffer -lpthread
+
+namespace {
+
+void
+grow_then_shrink() noexcept {
+    la::native::Framebuffer fb;
+    CHECK(fb.resize(100, 50) == la::AboutError::None);
+    CHECK(fb.pixels && fb.width == 100 && fb.height == 50);
+    CHECK(fb.stride >= 100 && fb.stride % 8 == 0 && fb.capacity_height >= 50);
+
+    // Growing by a little more than one allocation holds grows by 1.5x
+    const int stride = fb.stride, rows = fb.capacity_height;
+    CHECK(fb.resize(stride + 1, rows + 1) == la::AboutError::None);
+    CHECK(fb.stride >= stride + stride / 2 && fb.stride % 8 == 0);
+    CHECK(fb.capacity_height >= rows + rows / 2);
+
+    // Shrinking only changes the visible size
+    const void* pixels = fb.pixels;
+    const int big_stride = fb.stride, big_rows = fb.capacity_height;
+    CHECK(fb.resize(30, 20) == la::AboutError::None);
+    CHECK(fb.pixels == pixels && fb.stride == big_stride && fb.capacity_height == big_rows);
+    CHECK(fb.width == 30 && fb.height == 20);
+
+    // Rows keep the stride: the clear covers the visible rectangle only
+    fb.clear(0xff112233u, fb.width, fb.height);
+    const uint32_t* p = static_cast<const uint32_t*>(fb.pixels);
+    CHECK(p[0] == 0xff112233u && p[29] == 0xff112233u);
+    CHECK(p[static_cast<size_t>(fb.stride) * 19 + 29] == 0xff112233u);
+
+    // Growing back within the capacity reuses it
+    CHECK(fb.resize(big_stride, big_rows) == la::AboutError::None);
+    CHECK(fb.pixels == pixels && fb.stride == big_stride);
+    fb.draw_pixel(big_stride - 1, big_rows - 1, fb.width, fb.height, 0xffabcdefu);
+    CHECK(p[static_cast<size_t>(big_stride) * big_rows - 1] == 0xffabcdefu);
+} // grow_then_shrink
+
+// A minimized window reports 0x0: nothing to draw, the allocation stays
+void
+zero_size() noexcept {
+    la::native::Framebuffer fb;
+    CHECK(fb.resize(0, 0) == la::AboutError::None && !fb.pixels);
+    CHECK(fb.resize(64, 64) == la::AboutError::None);
+    const void* pixels = fb.pixels;
+    const int stride = fb.stride;
+    CHECK(fb.resize(0, 0) == la::AboutError::None);
+    CHECK(fb.width == 0 && fb.height == 0 && fb.pixels == pixels && fb.stride == stride);
+    fb.clear(0xffffffffu, 64, 64); // Nothing visible, nothing written
+    CHECK(fb.resize(64, 64) == la::AboutError::None && fb.pixels == pixels);
+} // zero_size
+
+} // namespace
+
+int main() {
+    grow_then_shrink();
+    zero_size();
+    return test::report("framebuffer");
+}
@@ -0,0 +1,122 @@
+#include "test.hpp"
+
+// `InputState` edges and deltas, and snapshots read while another thread publishes
+//
+//     g++ -std=c++14 -O2 -Isrc tests/input.cpp src/la/*.cpp -o test_input -lpthread
+
+namespace {
+
+void
+edges() noexcept {
+    la::InputState input;
+    input.key(la::Key::A, true);
+    input.key(la::Key::A, true); // Auto-repeat
+    input.key(la::Key::B, true);
+    input.key(la::Key::B, false); // Tapped within one frame
+    input.publish();
+    la::InputSnapshot s = input.snapshot();
+    CHECK(s.sequence == 1);
+    CHECK(s.pressed(la::Key::A) && s.just_pressed(la::Key::A) && !s.just_released(la::Key::A));
+    CHECK(!s.pressed(la::Key::B) && s.just_pressed(la::Key::B) && s.just_released(la::Key::B));
+
+    // Held keys carry over, their edges don't
+    input.key(la::Key::A, true);
+    input.publish();
+    s = input.snapshot();
+    CHECK(s.sequence == 2 && s.pressed(la::Key::A) && !s.just_pressed(la::Key::A));
+    CHECK(!s.just_pressed(la::Key::B) && !s.just_released(la::Key::B));
+
+    // Focus lost: every held key goes up
+    input.key(la::Key::Space, true);
+    input.release_all();
+    input.publish();
+    s = input.snapshot();
+    CHECK(!s.pressed(la::Key::A) && s.just_released(la::Key::A));
+    CHECK(!s.pressed(la::Key::Space) && s.just_pressed(la::Key::Space) && s.just_released(la::Key::Space));
+
+    // Out of range keys are ignored
+    input.key(la::Key::__NONE__, true);
+    input.key(la::Key::__LAST__, true);
+    input.publish();
+    s = input.snapshot();
+    CHECK(!s.pressed(la::Key::__NONE__));
+} // edges
+
+void
+mouse() noexcept {
+    la::InputState input;
+    input.mouse_move(100, 50); // First position, no delta
+    input.mouse_move(110, 45);
+    input.mouse_move(130, 40);
+    input.scroll(1.f);
+    input.scroll(0.5f);
+    input.publish();
+    la::InputSnapshot s = input.snapshot();
+    CHECK(s.mouse_x == 130 && s.mouse_y == 40);
+    CHECK(s.mouse_dx == 30 && s.mouse_dy == -10 && s.scroll == 1.5f);
+
+    input.publish();
+    s = input.snapshot();
+    CHECK(s.mouse_x == 130 && s.mouse_dx == 0 && s.mouse_dy == 0 && s.scroll == 0.f);
+} // mouse
+
+// ------------------------------ Seqlock --------------------------------------
+
+LA_CONSTEXPR_VAR int PUBLISHES = 200000;
+
+struct Shared {
+    la::InputState input;
+    la::Atomic<uint32_t> done{ 0 };
+};
+
+// Publish `i` has the mouse at (i, 2i) and exactly key `i % 26` held
+void
+writer(void* arg) noexcept {
+    Shared& shared = *static_cast<Shared*>(arg);
+    for (int i = 1; i <= PUBLISHES; ++i) {
+        if (i > 1) shared.input.key(static_cast<la::Key>(static_cast<int>(la::Key::A) + (i - 1) % 26), false);
+        shared.input.key(static_cast<la::Key>(static_cast<int>(la::Key::A) + i % 26), true);
+        shared.input.mouse_move(i, 2 * i);
+        shared.input.publish();
+        if (i % 64 == 0) la::yield_thread(); // Let the reader in between publishes, on one core too
+    }
+    shared.done.store(1);
+} // writer
+
+// Every snapshot must be one whole publish, never a mix of two
+void
+concurrent_snapshots() noexcept {
+    static Shared shared;
+    la::Thread thread;
+    CHECK(thread.start(&writer, &shared));
+
+    uint64_t reads = 0, torn = 0, backwards = 0, last = 0;
+    while (!shared.done.load()) {
+        const la::InputSnapshot s = shared.input.snapshot();
+        ++reads;
+        if (s.sequence < last) ++backwards;
+        last = s.sequence;
+        if (s.sequence == 0) continue;
+
+        const int i = static_cast<int>(s.sequence);
+        unsigned held = 0;
+        for (int k = 0; k < 26; ++k) held += s.pressed(static_cast<la::Key>(static_cast<int>(la::Key::A) + k));
+        if (s.mouse_x != i || s.mouse_y != 2 * i || held != 1 ||
+            !s.pressed(static_cast<la::Key>(static_cast<int>(la::Key::A) + i % 26)))
+            ++torn;
+    }
+    thread.join();
+
+    CHECK(reads > 0 && torn == 0 && backwards == 0);
+    const la::InputSnapshot s = shared.input.snapshot();
+    CHECK(s.sequence == PUBLISHES && s.mouse_x == PUBLISHES);
+} // concurrent_snapshots
+
+} // namespace
+
+int main() {
+    edges();
+    mouse();
+    concurrent_snapshots();
+    return test::report("input");
+}
@@ -0,0 +1,54 @@
+#include "test.hpp"
+#include "la/layer.hpp"
+
+// `Layer` surfaces and `Compositor` caching
+//
+//     g++ -std=c++14 -O2 -Isrc tests/layer.cpp src/la/*.cpp -o test_layer -lpthread
+
+namespace {
+
+LA_CONSTEXPR_VAR int SIZE = 512;
+
+uint32_t g_pixels[SIZE * SIZE];
+
+void
+resize_rasterizes() noexcept {
+    la::Canvas target{ g_pixels, SIZE, SIZE, SIZE };
+    la::Compositor compositor;
+    la::Layer layer;
+    layer.width = layer.height = 8;
+    layer.opaque = true;
+    layer.record().fill_rect(la::Rect::from_size(0, 0, SIZE, SIZE), 0xff00ff00u);
+
+    compositor.composite(layer, target, 0xff000000u);
+    CHECK(compositor.stats().rasterized == 1);
+    CHECK(layer.is_cached() && layer.surface().width == 8);
+    CHECK(g_pixels[7] == 0xff00ff00u && g_pixels[8] == 0xff000000u);
+
+    // Same content, no new `record()`: still a new surface at the new size
+    layer.width = layer.height = SIZE;
+    CHECK(!layer.is_cached());
+    compositor.composite(layer, target, 0xff000000u);
+    CHECK(compositor.stats().rasterized == 1);
+    CHECK(layer.is_cached() && layer.surface().width == SIZE && layer.surface().height == SIZE);
+    CHECK(g_pixels[SIZE * SIZE - 1] == 0xff00ff00u);
+
+    // Shrinking keeps the allocation
+    const size_t bytes = layer.surface().bytes;
+    layer.width = layer.height = 16;
+    compositor.composite(layer, target, 0xff000000u);
+    CHECK(compositor.stats().rasterized == 1);
+    CHECK(layer.surface().bytes == bytes && layer.surface().width == 16);
+    CHECK(g_pixels[15] == 0xff00ff00u && g_pixels[16] == 0xff000000u);
+
+    // Nothing changed
+    compositor.composite(layer, target, 0xff000000u);
+    CHECK(compositor.stats().rasterized == 0 && compositor.stats().composited == 1);
+} // resize_rasterizes
+
+} // namespace
+
+int main() {
+    resize_rasterizes();
+    return test::report("layer");
+}
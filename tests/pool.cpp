@@ -0,0 +1,151 @@
+#include "test.hpp"
+#include "la/pool.hpp"
+
+// Size-class pools: distinct objects, slab sizes, trimming around live objects
+// and refills that take one batch of the shared list
+//
+//     g++ -std=c++14 -O2 -Isrc tests/pool.cpp src/la/*.cpp -o test_pool -lpthread
+
+namespace {
+
+LA_CONSTEXPR_VAR uintptr_t SLAB_SIZE = 64 * 1024;
+LA_CONSTEXPR_VAR int COUNT = 2000;
+
+// A class of its own: nothing else in the program allocates 320 bytes
+struct Node { uint32_t words[80]; };
+
+Node* g_nodes[COUNT];
+
+void
+fill(Node* node, uint32_t value) noexcept {
+    for (uint32_t& w : node->words) w = value;
+} // fill
+
+bool
+holds(const Node* node, uint32_t value) noexcept {
+    for (uint32_t w : node->words) if (w != value) return false;
+    return true;
+} // holds
+
+// Every slab of the class back to the OS, and the baseline to compare against
+la::PoolStats
+settle() noexcept {
+    la::pool_flush_thread();
+    la::pool_trim();
+    return la::pool_stats();
+} // settle
+
+void
+distinct_objects() noexcept {
+    const la::PoolStats before = settle();
+    la::Pool<Node> pool;
+    for (int i = 0; i < COUNT; ++i) {
+        g_nodes[i] = pool.alloc();
+        CHECK(g_nodes[i] && reinterpret_cast<uintptr_t>(g_nodes[i]) % la::POOL_ALIGN == 0);
+        if (g_nodes[i]) fill(g_nodes[i], static_cast<uint32_t>(i));
+    }
+    bool intact = true;
+    for (int i = 0; i < COUNT; ++i) intact = intact && holds(g_nodes[i], static_cast<uint32_t>(i));
+    CHECK(intact);
+
+    // 64 KB mapped per slab, no alignment slack kept
+    const la::PoolStats during = la::pool_stats();
+    const uint64_t slabs = during.slabs - before.slabs;
+    CHECK(slabs >= COUNT * sizeof(Node) / SLAB_SIZE);
+    CHECK(during.slab_bytes - before.slab_bytes == slabs * SLAB_SIZE);
+
+    for (int i = 0; i < COUNT; ++i) pool.free(g_nodes[i]);
+    const la::PoolStats after = settle();
+    CHECK(after.slabs == before.slabs && after.slab_bytes == before.slab_bytes);
+    CHECK(after.released - before.released == slabs);
+} // distinct_objects
+
+// A slab with one live object stays, with the object untouched
+void
+trim_around_live_objects() noexcept {
+    const la::PoolStats before = settle();
+    la::Pool<Node> pool;
+    uintptr_t slabs[64];
+    Node* kept[64];
+    int kept_count = 0;
+    for (int i = 0; i < COUNT; ++i) {
+        g_nodes[i] = pool.alloc();
+        fill(g_nodes[i], 0xC0DE0000u + static_cast<uint32_t>(i));
+    }
+
+    // The first object seen in each slab stays alive
+    for (int i = 0; i < COUNT; ++i) {
+        const uintptr_t slab = reinterpret_cast<uintptr_t>(g_nodes[i]) & ~(SLAB_SIZE - 1);
+        bool seen = false;
+        for (int k = 0; k < kept_count && !seen; ++k) seen = slabs[k] == slab;
+        if (seen || kept_count == 64) {
+            pool.free(g_nodes[i]);
+            g_nodes[i] = nullptr;
+            continue;
+        }
+        slabs[kept_count] = slab;
+        kept[kept_count++] = g_nodes[i];
+    }
+
+    const la::PoolStats trimmed = settle();
+    CHECK(trimmed.slabs - before.slabs == static_cast<uint64_t>(kept_count));
+    bool intact = true;
+    for (int i = 0; i < COUNT; ++i)
+        if (g_nodes[i]) intact = intact && holds(g_nodes[i], 0xC0DE0000u + static_cast<uint32_t>(i));
+    CHECK(intact);
+
+    // The survivors' slabs still hand out their free objects
+    Node* reused = pool.alloc();
+    bool from_kept = false;
+    for (int k = 0; k < kept_count; ++k)
+        from_kept = from_kept || (reinterpret_cast<uintptr_t>(reused) & ~(SLAB_SIZE - 1)) == slabs[k];
+    CHECK(from_kept);
+    pool.free(reused);
+
+    for (int k = 0; k < kept_count; ++k) pool.free(kept[k]);
+    const la::PoolStats after = settle();
+    CHECK(after.slabs == before.slabs);
+} // trim_around_live_objects
+
+struct Refill {
+    uint64_t shared_before{ 0 };
+    uint64_t shared_after{ 0 };
+};
+
+void
+alloc_one(void* arg) noexcept {
+    Refill& r = *static_cast<Refill*>(arg);
+    la::Pool<Node> pool;
+    r.shared_before = la::pool_stats().shared_free;
+    Node* node = pool.alloc();
+    r.shared_after = la::pool_stats().shared_free;
+    pool.free(node);
+    la::pool_flush_thread();
+} // alloc_one
+
+// An empty cache takes one batch from the shared list, the rest stays shared
+void
+refill_takes_one_batch() noexcept {
+    (void)settle();
+    la::Pool<Node> pool;
+    const int count = 640; // Below the automatic trim
+    for (int i = 0; i < count; ++i) g_nodes[i] = pool.alloc();
+    for (int i = 0; i < count; ++i) pool.free(g_nodes[i]);
+    CHECK(la::pool_stats().shared_free >= 32 * 4);
+
+    Refill refill;
+    la::Thread thread;
+    CHECK(thread.start(&alloc_one, &refill));
+    thread.join();
+    CHECK(refill.shared_before - refill.shared_after == 32);
+    (void)settle();
+} // refill_takes_one_batch
+
+} // namespace
+
+int main() {
+    distinct_objects();
+    trim_around_live_objects();
+    refill_takes_one_batch();
+    return test::report("pool");
+}
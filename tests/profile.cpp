@@ -0,0 +1,70 @@
+#include "test.hpp"
+
+#include <string.h> // strstr
+
+// Profiler rings across `profile_shutdown()`. Writes `test_profile.json` to the
+// working directory
+//
+//     g++ -std=c++14 -O2 -Isrc tests/profile.cpp src/la/*.cpp -o test_profile -lpthread
+
+namespace {
+
+struct Recorder {
+    la::Signal recorded;
+    la::Signal shut_down;
+};
+
+void
+record_around_shutdown(void* arg) noexcept {
+    Recorder& r = *static_cast<Recorder*>(arg);
+    la::profile_record("before_shutdown", 1000, 2000);
+    r.recorded.set();
+    r.shut_down.wait();
+    // The ring cached above is gone: this needs a new one
+    la::profile_record("after_shutdown", 3000, 4000);
+} // record_around_shutdown
+
+// Exported trace, null-terminated, in `la::alloc` memory of `*size + 1` bytes
+char*
+export_trace(size_t* size) noexcept {
+    if (!la::profile_export_chrome("test_profile.json")) return nullptr;
+    char* data = static_cast<char*>(la::read_file("test_profile.json", size));
+    if (!data) return nullptr;
+    char* text = static_cast<char*>(la::alloc(*size + 1));
+    if (text) {
+        memcpy(text, data, *size);
+        text[*size] = '\0';
+    }
+    la::free(data, *size);
+    return text;
+} // export_trace
+
+// Another thread's cached ring is freed by the shutdown, its next record starts over
+void
+shutdown_while_threads_live() noexcept {
+    Recorder recorder;
+    la::Thread thread;
+    CHECK(thread.start(&record_around_shutdown, &recorder));
+    recorder.recorded.wait();
+    la::profile_record("main_before", 1500, 2500);
+    la::profile_shutdown();
+    recorder.shut_down.set();
+    thread.join();
+    la::profile_record("main_after", 5000, 6000);
+
+    size_t size = 0;
+    char* trace = export_trace(&size);
+    CHECK(trace);
+    if (!trace) return;
+    CHECK(strstr(trace, "\"after_shutdown\"") && strstr(trace, "\"main_after\""));
+    CHECK(!strstr(trace, "before_shutdown") && !strstr(trace, "main_before"));
+    la::free(trace, size + 1);
+    la::profile_shutdown();
+} // shutdown_while_threads_live
+
+} // namespace
+
+int main() {
+    shutdown_while_threads_live();
+    return test::report("profile");
+}
@@ -0,0 +1,33 @@
+#ifndef __LA_TEST_HEADER_GUARD
+#define __LA_TEST_HEADER_GUARD
+
+#include "la/la.hpp"
+#include <stdio.h>
+
+// Shared by the programs in tests/, see README.md
+
+namespace test {
+
+static int g_failures = 0;
+
+inline void
+check(bool ok, const char* expr, const char* file, int line) noexcept {
+    if (ok) return;
+    printf("%s:%d: CHECK(%s) failed\n", file, line, expr);
+    ++g_failures;
+} // check
+
+// Exit code of the test program
+inline int
+report(const char* name) noexcept {
+    if (g_failures) printf("%s: %d failed\n", name, g_failures);
+    else printf("%s: ok\n", name);
+    return g_failures ? 1 : 0;
+} // report
+
+} // namespace test
+
+// Keeps going after a failure, `test::report()` sums them up
+#define CHECK(expr) ::test::check(static_cast<bool>(expr), #expr, __FILE__, __LINE__)
+
+#endif // __LA_TEST_HEADER_GUARD
@@ -0,0 +1,246 @@
+#include "test.hpp"
+#include "la/ui.hpp"
+
+#include <string.h> // memcmp
+
+// `ui::Tree` layout, relayout boundaries and incremental paint
+//
+//     g++ -std=c++14 -O2 -Isrc tests/ui.cpp src/la/*.cpp -o test_ui -lpthread
+
+namespace {
+
+using la::ui::Kind;
+using la::ui::NodeId;
+using la::ui::Tree;
+
+LA_CONSTEXPR_VAR int WIDTH = 200;
+LA_CONSTEXPR_VAR int HEIGHT = 120;
+
+uint32_t g_pixels[WIDTH * HEIGHT];
+uint32_t g_expected[WIDTH * HEIGHT];
+
+void
+linear_layout() noexcept {
+    Tree tree;
+    const NodeId row = tree.create(Kind::Row, tree.root());
+    tree.set_gap(row, 10);
+    const NodeId fixed = tree.create(Kind::Box, row);
+    tree.set_size(fixed, 50, 20);
+    const NodeId a = tree.create(Kind::Box, row);
+    const NodeId b = tree.create(Kind::Box, row);
+    tree.set_flex(a, 1);
+    tree.set_flex(b, 3);
+    tree.set_size(a, -1, 10);
+    tree.set_size(b, -1, 30);
+    tree.set_viewport(WIDTH, HEIGHT);
+    tree.layout();
+
+    // 200 - 50 - 2 * 10 = 130 shared 1:3
+    la::Canvas canvas{ g_pixels, WIDTH, HEIGHT, WIDTH };
+    (void)tree.paint(canvas);
+    CHECK(tree.rect(row) == la::Rect::from_size(0, 0, WIDTH, HEIGHT)); // Tight from the root
+    CHECK(tree.rect(fixed) == la::Rect::from_size(0, 0, 50, 20));
+    CHECK(tree.rect(a) == la::Rect::from_size(60, 0, 32, 10));
+    CHECK(tree.rect(b) == la::Rect::from_size(102, 0, 98, 30));
+    CHECK(tree.stats().nodes == 5);
+
+    // Nothing changed: no work at all
+    tree.layout();
+    CHECK(tree.stats().laid_out == 0);
+    CHECK(tree.paint(canvas).is_empty() && tree.stats().painted == 0);
+} // linear_layout
+
+// Column of fixed-height rows, each a `Box` holding a `Row` of `leaves` boxes.
+// The box gives its row tight constraints, which makes the row a boundary
+NodeId
+build_grid(Tree& tree, int rows, int leaves, NodeId* first_leaf) noexcept {
+    const NodeId column = tree.create(Kind::Column, tree.root());
+    for (int r = 0; r < rows; ++r) {
+        const NodeId cell = tree.create(Kind::Box, column);
+        tree.set_size(cell, -1, 12);
+        const NodeId row = tree.create(Kind::Row, cell);
+        tree.set_gap(row, 1);
+        for (int i = 0; i < leaves; ++i) {
+            const NodeId leaf = tree.create(Kind::Box, row);
+            tree.set_size(leaf, 2, 10);
+            tree.set_color(leaf, 0xFF000000u | static_cast<uint32_t>(r * 7919 + i * 104729));
+            if (r == 0 && i == 0 && first_leaf) *first_leaf = leaf;
+        }
+    }
+    return column;
+} // build_grid
+
+// A leaf inside a tightly constrained row relayouts the row and nothing above
+void
+tight_boundary() noexcept {
+    Tree tree;
+    NodeId leaf = la::ui::NONE;
+    (void)build_grid(tree, 8, 16, &leaf);
+    tree.set_viewport(WIDTH, HEIGHT);
+    tree.layout();
+    CHECK(tree.stats().laid_out == 1 + 1 + 8 * (2 + 16));
+
+    const NodeId sibling = tree.next_sibling(leaf);
+    la::Canvas canvas{ g_pixels, WIDTH, HEIGHT, WIDTH };
+    (void)tree.paint(canvas);
+    const la::Rect before = tree.rect(sibling);
+
+    tree.set_size(leaf, 5, 10);
+    tree.layout();
+    CHECK(tree.stats().laid_out == 2); // The row and the leaf
+    (void)tree.paint(canvas);
+    CHECK(tree.rect(sibling) == before.translate(3, 0));
+} // tight_boundary
+
+// Explicit boundaries stop relayout while their size holds, and hand it to
+// the parent when it doesn't
+void
+explicit_boundary() noexcept {
+    Tree tree;
+    const NodeId column = tree.create(Kind::Column, tree.root());
+    const NodeId padding = tree.create(Kind::Padding, column);
+    tree.set_padding(padding, 4);
+    const NodeId row = tree.create(Kind::Row, padding);
+    const NodeId a = tree.create(Kind::Box, row);
+    const NodeId b = tree.create(Kind::Box, row);
+    tree.set_size(a, 10, 20);
+    tree.set_size(b, 20, 20);
+    const NodeId below = tree.create(Kind::Box, column);
+    tree.set_size(below, 40, 10);
+    tree.set_viewport(WIDTH, HEIGHT);
+    tree.layout();
+
+    la::Canvas canvas{ g_pixels, WIDTH, HEIGHT, WIDTH };
+    (void)tree.paint(canvas);
+    CHECK(tree.rect(below).top == 28);
+
+    // Not a boundary: up to the column, which the root holds tight
+    tree.set_size(a, 20, 20);
+    tree.set_size(b, 10, 20);
+    tree.layout();
+    CHECK(tree.stats().laid_out == 5);
+
+    // Toggling the flag relayouts from the node
+    tree.set_relayout_boundary(padding, true);
+    tree.layout();
+    CHECK(tree.stats().laid_out >= 1);
+    tree.set_relayout_boundary(padding, true); // No change
+    tree.layout();
+    CHECK(tree.stats().laid_out == 0);
+
+    // Same size: the padding and what's inside
+    tree.set_size(a, 10, 20);
+    tree.set_size(b, 20, 20);
+    tree.layout();
+    CHECK(tree.stats().laid_out == 4);
+
+    // Taller: the padding, the row and `a`, then the column has to move `below`
+    tree.set_size(a, 10, 30);
+    tree.layout();
+    CHECK(tree.stats().laid_out == 4);
+    (void)tree.paint(canvas);
+    CHECK(tree.rect(padding) == la::Rect::from_size(0, 0, 38, 38));
+    CHECK(tree.rect(below).top == 38);
+} // explicit_boundary
+
+// 100k nodes, one change: the frame's work doesn't grow with the tree
+void
+large_tree() noexcept {
+    Tree tree;
+    NodeId leaf = la::ui::NONE;
+    (void)build_grid(tree, 1000, 98, &leaf);
+    CHECK(!tree.has_failed() && tree.stats().nodes == 1 + 1 + 1000 * 100);
+    tree.set_viewport(WIDTH, HEIGHT);
+    tree.layout();
+
+    la::Canvas canvas{ g_pixels, WIDTH, HEIGHT, WIDTH };
+    (void)tree.paint(canvas);
+
+    tree.set_color(leaf, 0xFFFFFFFFu);
+    tree.layout();
+    CHECK(tree.stats().laid_out == 0);
+    const la::Damage& damage = tree.paint(canvas);
+    CHECK(damage.count == 1 && damage.rects[0] == tree.rect(leaf));
+    CHECK(tree.stats().painted <= 5); // Root, column, cell, row, leaf
+    CHECK(g_pixels[0] == 0xFFFFFFFFu);
+
+    tree.set_size(leaf, 3, 10);
+    tree.layout();
+    CHECK(tree.stats().laid_out == 2);
+    (void)tree.paint(canvas);
+    CHECK(tree.stats().painted < 200);
+} // large_tree
+
+void
+destroy_subtree() noexcept {
+    Tree tree;
+    const NodeId column = tree.create(Kind::Column, tree.root());
+    const NodeId top = tree.create(Kind::Box, column);
+    tree.set_size(top, 50, 20);
+    tree.set_color(top, 0xFF0000FFu);
+    const NodeId inner = tree.create(Kind::Box, top);
+    tree.set_color(inner, 0xFF00FF00u);
+    const NodeId bottom = tree.create(Kind::Box, column);
+    tree.set_size(bottom, 50, 20);
+    tree.set_viewport(WIDTH, HEIGHT);
+    tree.layout();
+
+    la::Canvas canvas{ g_pixels, WIDTH, HEIGHT, WIDTH };
+    (void)tree.paint(canvas);
+    CHECK(tree.rect(bottom).top == 20);
+
+    tree.destroy(top);
+    CHECK(tree.stats().nodes == 3 && tree.first_child(column) == bottom);
+    tree.layout();
+    const la::Damage& damage = tree.paint(canvas);
+    CHECK(tree.rect(bottom).top == 0);
+    CHECK(damage.bounds().contains(la::Rect::from_size(0, 0, 50, 40)));
+    CHECK(g_pixels[10 * WIDTH + 10] == 0xFF000000u); // The background shows again
+
+    // Freed ids come back
+    const NodeId again = tree.create(Kind::Box, column);
+    CHECK(again == top || again == inner);
+    CHECK(tree.parent(again) == column && tree.next_sibling(bottom) == again);
+} // destroy_subtree
+
+// Incremental frames end with the same pixels as a tree built in its final state
+void
+matches_fresh_tree() noexcept {
+    Tree tree;
+    NodeId leaf = la::ui::NONE;
+    (void)build_grid(tree, 12, 20, &leaf);
+    tree.set_viewport(WIDTH, HEIGHT);
+    tree.layout();
+    la::Canvas canvas{ g_pixels, WIDTH, HEIGHT, WIDTH };
+    (void)tree.paint(canvas);
+
+    for (int frame = 0; frame < 4; ++frame) {
+        tree.set_size(leaf, 2 + frame, 10);
+        tree.set_color(tree.next_sibling(leaf), 0xFF00FF00u + static_cast<uint32_t>(frame));
+        tree.layout();
+        (void)tree.paint(canvas);
+    }
+
+    Tree fresh;
+    NodeId fresh_leaf = la::ui::NONE;
+    (void)build_grid(fresh, 12, 20, &fresh_leaf);
+    fresh.set_size(fresh_leaf, 5, 10);
+    fresh.set_color(fresh.next_sibling(fresh_leaf), 0xFF00FF03u);
+    fresh.set_viewport(WIDTH, HEIGHT);
+    fresh.layout();
+    la::Canvas full{ g_expected, WIDTH, HEIGHT, WIDTH };
+    (void)fresh.paint(full);
+    CHECK(memcmp(g_pixels, g_expected, sizeof(g_pixels)) == 0);
+} // matches_fresh_tree
+
+} // namespace
+
+int main() {
+    linear_layout();
+    tight_boundary();
+    explicit_boundary();
+    large_tree();
+    destroy_subtree();
+    matches_fresh_tree();
+    return test::report("ui");
+}